@@ -0,0 +1,406 @@
+#include "archive/ColumnArchive.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const char kMagic[8] = {'F', 'O', 'A', 'R', 'C', 'H', '0', '1'};
+static constexpr size_t kColumnCount = static_cast<size_t>(ArchiveColumn::COUNT);
+
+static const char* const kColumnNames[kColumnCount] = {
+    "trade_time", "trade_price", "trade_qty", "buy_trader", "sell_trader", "collision",
+    "order_time", "order_id", "batch_id", "order_trader", "side", "order_price", "order_qty",
+    "tif", "order_type"
+};
+
+ArchiveStream column_stream(ArchiveColumn column) {
+    return column < ArchiveColumn::ORDER_TIME ? ArchiveStream::TRADES : ArchiveStream::ORDERS;
+}
+
+ColumnEncoding column_encoding(ArchiveColumn column) {
+    switch (column) {
+        case ArchiveColumn::TRADE_TIME:
+        case ArchiveColumn::TRADE_PRICE:
+        case ArchiveColumn::ORDER_TIME:
+        case ArchiveColumn::ORDER_ID:
+        case ArchiveColumn::ORDER_BATCH:
+        case ArchiveColumn::ORDER_PRICE:
+            return ColumnEncoding::DELTA_VARINT;
+        case ArchiveColumn::TRADE_COLLISION:
+        case ArchiveColumn::ORDER_SIDE:
+        case ArchiveColumn::ORDER_TYPE:
+            return ColumnEncoding::BITS;
+        default:
+            return ColumnEncoding::VARINT;
+    }
+}
+
+const char* column_name(ArchiveColumn column) {
+    size_t i = static_cast<size_t>(column);
+    return i < kColumnCount ? kColumnNames[i] : "?";
+}
+
+bool parse_column_name(const std::string& name, ArchiveColumn& column) {
+    for (size_t i = 0; i < kColumnCount; ++i) {
+        if (name == kColumnNames[i]) {
+            column = static_cast<ArchiveColumn>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---- encoding ----
+
+static inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+static inline void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+template <typename T>
+static void put_raw(std::string& out, T v) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+static bool get_raw(const char*& p, const char* end, T& v) {
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+static void encode_column(const std::vector<int64_t>& values, ColumnEncoding encoding, std::string& out) {
+    out.clear();
+    switch (encoding) {
+        case ColumnEncoding::VARINT:
+            for (int64_t v : values) put_varint(out, zigzag(v));
+            break;
+        case ColumnEncoding::DELTA_VARINT: {
+            int64_t prev = 0;
+            for (int64_t v : values) {
+                put_varint(out, zigzag(static_cast<int64_t>(static_cast<uint64_t>(v) - static_cast<uint64_t>(prev))));
+                prev = v;
+            }
+            break;
+        }
+        case ColumnEncoding::BITS:
+            out.assign((values.size() + 7) / 8, '\0');
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (values[i] != 0) out[i / 8] = static_cast<char>(out[i / 8] | (1 << (i % 8)));
+            }
+            break;
+    }
+}
+
+static bool decode_column(const char* p, const char* end, uint32_t rows, ColumnEncoding encoding,
+                          std::vector<int64_t>& out) {
+    out.resize(rows);
+    if (encoding == ColumnEncoding::BITS) {
+        if (static_cast<size_t>(end - p) < (rows + 7) / 8) return false;
+        for (uint32_t i = 0; i < rows; ++i) {
+            out[i] = (static_cast<uint8_t>(p[i / 8]) >> (i % 8)) & 1;
+        }
+        return true;
+    }
+
+    int64_t prev = 0;
+    bool delta = encoding == ColumnEncoding::DELTA_VARINT;
+    for (uint32_t i = 0; i < rows; ++i) {
+        uint64_t v = 0;
+        int shift = 0;
+        while (true) {
+            if (p == end || shift > 63) return false;
+            uint8_t byte = static_cast<uint8_t>(*p++);
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) break;
+            shift += 7;
+        }
+        int64_t x = unzigzag(v);
+        if (delta) {
+            x = static_cast<int64_t>(static_cast<uint64_t>(prev) + static_cast<uint64_t>(x));
+            prev = x;
+        }
+        out[i] = x;
+    }
+    return true;
+}
+
+// ---- writer ----
+
+ArchiveWriter::ArchiveWriter(size_t chunk_rows)
+    : chunk_rows_(std::max<size_t>(1, chunk_rows)),
+      pending_(kColumnCount),
+      trade_rows_(0),
+      order_rows_(0),
+      bytes_written_(0) {}
+
+ArchiveWriter::~ArchiveWriter() {
+    close();
+}
+
+bool ArchiveWriter::open(const std::string& path) {
+    close();
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        last_error_ = "cannot open " + path + " for writing";
+        return false;
+    }
+    path_ = path;
+    chunks_.clear();
+    for (auto& column : pending_) column.clear();
+    trade_rows_ = 0;
+    order_rows_ = 0;
+    file_.write(kMagic, sizeof(kMagic));
+    bytes_written_ = sizeof(kMagic);
+    return true;
+}
+
+void ArchiveWriter::append_trade(const Trade& trade, bool was_collision) {
+    if (!file_.is_open()) return;
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_TIME)].push_back(static_cast<int64_t>(trade.execution_time));
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_PRICE)].push_back(trade.price);
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_QTY)].push_back(trade.qty);
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_BUY_TRADER)].push_back(trade.buy_trader_id);
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_SELL_TRADER)].push_back(trade.sell_trader_id);
+    pending_[static_cast<size_t>(ArchiveColumn::TRADE_COLLISION)].push_back(was_collision ? 1 : 0);
+    ++trade_rows_;
+    if (pending_[static_cast<size_t>(ArchiveColumn::TRADE_TIME)].size() >= chunk_rows_) {
+        flush_stream(ArchiveStream::TRADES);
+    }
+}
+
+void ArchiveWriter::append_order(const OrderEvent& ev) {
+    if (!file_.is_open()) return;
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_TIME)].push_back(static_cast<int64_t>(ev.recv_time));
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_ID)].push_back(static_cast<int64_t>(ev.order_id));
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_BATCH)].push_back(static_cast<int64_t>(ev.batch_id));
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_TRADER)].push_back(ev.trader_id);
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_SIDE)].push_back(ev.side == Side::SELL ? 1 : 0);
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_PRICE)].push_back(ev.price);
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_QTY)].push_back(ev.qty);
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_TIF)].push_back(static_cast<int64_t>(ev.tif));
+    pending_[static_cast<size_t>(ArchiveColumn::ORDER_TYPE)].push_back(ev.order_type == OrderType::MARKET ? 1 : 0);
+    ++order_rows_;
+    if (pending_[static_cast<size_t>(ArchiveColumn::ORDER_TIME)].size() >= chunk_rows_) {
+        flush_stream(ArchiveStream::ORDERS);
+    }
+}
+
+void ArchiveWriter::flush_stream(ArchiveStream stream) {
+    size_t first = stream == ArchiveStream::TRADES ? 0 : static_cast<size_t>(ArchiveColumn::ORDER_TIME);
+    size_t last = stream == ArchiveStream::TRADES ? static_cast<size_t>(ArchiveColumn::ORDER_TIME) : kColumnCount;
+    size_t rows = pending_[first].size();
+    if (rows == 0) return;
+
+    ChunkMeta chunk{stream, static_cast<uint32_t>(rows), {}};
+    for (size_t c = first; c < last; ++c) {
+        auto column = static_cast<ArchiveColumn>(c);
+        auto encoding = column_encoding(column);
+        const auto& values = pending_[c];
+        auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+
+        encode_column(values, encoding, scratch_);
+        file_.write(scratch_.data(), static_cast<std::streamsize>(scratch_.size()));
+        chunk.columns.push_back({column, encoding, bytes_written_, static_cast<uint32_t>(scratch_.size()), *lo, *hi});
+        bytes_written_ += scratch_.size();
+        pending_[c].clear();
+    }
+    chunks_.push_back(std::move(chunk));
+}
+
+bool ArchiveWriter::close() {
+    if (!file_.is_open()) return true;
+    flush_stream(ArchiveStream::TRADES);
+    flush_stream(ArchiveStream::ORDERS);
+
+    std::string footer;
+    put_raw<uint32_t>(footer, static_cast<uint32_t>(chunks_.size()));
+    for (const auto& chunk : chunks_) {
+        put_raw<uint8_t>(footer, static_cast<uint8_t>(chunk.stream));
+        put_raw<uint32_t>(footer, chunk.rows);
+        put_raw<uint8_t>(footer, static_cast<uint8_t>(chunk.columns.size()));
+        for (const auto& col : chunk.columns) {
+            put_raw<uint8_t>(footer, static_cast<uint8_t>(col.column));
+            put_raw<uint8_t>(footer, static_cast<uint8_t>(col.encoding));
+            put_raw<uint64_t>(footer, col.offset);
+            put_raw<uint32_t>(footer, col.bytes);
+            put_raw<int64_t>(footer, col.min);
+            put_raw<int64_t>(footer, col.max);
+        }
+    }
+    put_raw<uint64_t>(footer, bytes_written_);
+    footer.append(kMagic, sizeof(kMagic));
+
+    file_.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    bytes_written_ += footer.size();
+    file_.close();
+    if (!file_) {
+        last_error_ = "write to " + path_ + " failed";
+        return false;
+    }
+    return true;
+}
+
+// ---- reader ----
+
+bool ArchiveReader::open(const std::string& path) {
+    chunks_.clear();
+    file_.close();
+    file_.clear();
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        last_error_ = "cannot open " + path;
+        return false;
+    }
+
+    file_.seekg(0, std::ios::end);
+    file_bytes_ = static_cast<uint64_t>(file_.tellg());
+    size_t trailer = sizeof(uint64_t) + sizeof(kMagic);
+    if (file_bytes_ < sizeof(kMagic) + trailer) {
+        last_error_ = path + " is not a FairOrder archive";
+        return false;
+    }
+
+    char tail[sizeof(uint64_t) + sizeof(kMagic)];
+    file_.seekg(static_cast<std::streamoff>(file_bytes_ - trailer));
+    file_.read(tail, sizeof(tail));
+    uint64_t footer_offset = 0;
+    std::memcpy(&footer_offset, tail, sizeof(footer_offset));
+    if (!file_ || std::memcmp(tail + sizeof(uint64_t), kMagic, sizeof(kMagic)) != 0 ||
+        footer_offset < sizeof(kMagic) || footer_offset > file_bytes_ - trailer) {
+        last_error_ = path + " is not a FairOrder archive (or was not closed)";
+        return false;
+    }
+
+    std::vector<char> footer(file_bytes_ - trailer - footer_offset);
+    file_.seekg(static_cast<std::streamoff>(footer_offset));
+    file_.read(footer.data(), static_cast<std::streamsize>(footer.size()));
+
+    const char* p = footer.data();
+    const char* end = p + footer.size();
+    uint32_t count = 0;
+    bool ok = static_cast<bool>(file_) && get_raw(p, end, count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        Chunk chunk;
+        uint8_t stream = 0, ncols = 0;
+        ok = get_raw(p, end, stream) && get_raw(p, end, chunk.rows) && get_raw(p, end, ncols);
+        chunk.stream = static_cast<ArchiveStream>(stream);
+        for (uint8_t c = 0; ok && c < ncols; ++c) {
+            ColumnEntry e;
+            uint8_t column = 0, encoding = 0;
+            ok = get_raw(p, end, column) && get_raw(p, end, encoding) && get_raw(p, end, e.offset) &&
+                 get_raw(p, end, e.bytes) && get_raw(p, end, e.min) && get_raw(p, end, e.max) &&
+                 column < kColumnCount && e.offset + e.bytes <= footer_offset;
+            e.column = static_cast<ArchiveColumn>(column);
+            e.encoding = static_cast<ColumnEncoding>(encoding);
+            chunk.columns.push_back(e);
+        }
+        chunks_.push_back(std::move(chunk));
+    }
+    if (!ok) {
+        chunks_.clear();
+        last_error_ = path + ": corrupt chunk directory";
+        return false;
+    }
+    return true;
+}
+
+uint64_t ArchiveReader::row_count(ArchiveStream stream) const {
+    uint64_t rows = 0;
+    for (const auto& chunk : chunks_) {
+        if (chunk.stream == stream) rows += chunk.rows;
+    }
+    return rows;
+}
+
+uint64_t ArchiveReader::column_bytes(ArchiveColumn column) const {
+    uint64_t bytes = 0;
+    for (const auto& chunk : chunks_) {
+        if (const ColumnEntry* e = find_entry(chunk, column)) bytes += e->bytes;
+    }
+    return bytes;
+}
+
+std::vector<ArchiveChunkInfo> ArchiveReader::column_chunks(ArchiveColumn column) const {
+    std::vector<ArchiveChunkInfo> out;
+    for (const auto& chunk : chunks_) {
+        if (const ColumnEntry* e = find_entry(chunk, column)) {
+            out.push_back({chunk.stream, chunk.rows, e->bytes, e->min, e->max});
+        }
+    }
+    return out;
+}
+
+const ArchiveReader::ColumnEntry* ArchiveReader::find_entry(const Chunk& chunk, ArchiveColumn column) {
+    for (const auto& e : chunk.columns) {
+        if (e.column == column) return &e;
+    }
+    return nullptr;
+}
+
+bool ArchiveReader::decode_entry(const ColumnEntry& entry, uint32_t rows, std::vector<int64_t>& out) {
+    buf_.resize(entry.bytes);
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(entry.offset));
+    file_.read(buf_.data(), static_cast<std::streamsize>(entry.bytes));
+    if (!file_ || !decode_column(buf_.data(), buf_.data() + buf_.size(), rows, entry.encoding, out)) {
+        last_error_ = std::string("corrupt column chunk: ") + column_name(entry.column);
+        return false;
+    }
+    return true;
+}
+
+bool ArchiveReader::read_column(ArchiveColumn column, std::vector<int64_t>& out) {
+    out.clear();
+    out.reserve(row_count(column_stream(column)));
+    return scan_column(column, [&](const int64_t* values, size_t n) {
+        out.insert(out.end(), values, values + n);
+    });
+}
+
+bool ArchiveReader::read_orders(std::vector<OrderEvent>& out) {
+    std::vector<int64_t> time, id, batch, trader, side, price, qty, tif, type;
+    if (!read_column(ArchiveColumn::ORDER_TIME, time) || !read_column(ArchiveColumn::ORDER_ID, id) ||
+        !read_column(ArchiveColumn::ORDER_BATCH, batch) || !read_column(ArchiveColumn::ORDER_TRADER, trader) ||
+        !read_column(ArchiveColumn::ORDER_SIDE, side) || !read_column(ArchiveColumn::ORDER_PRICE, price) ||
+        !read_column(ArchiveColumn::ORDER_QTY, qty) || !read_column(ArchiveColumn::ORDER_TIF, tif) ||
+        !read_column(ArchiveColumn::ORDER_TYPE, type)) {
+        return false;
+    }
+    // Archives written before these columns hold GTC limit orders only
+    bool has_types = tif.size() == time.size() && type.size() == time.size();
+
+    out.clear();
+    out.reserve(time.size());
+    for (size_t i = 0; i < time.size(); ++i) {
+        OrderEvent ev;
+        ev.type = EventType::NEW;
+        ev.order_id = static_cast<OrderID>(id[i]);
+        ev.instrument = "ARCHIVE";
+        ev.side = side[i] ? Side::SELL : Side::BUY;
+        ev.price = price[i];
+        ev.qty = qty[i];
+        if (has_types) {
+            ev.tif = static_cast<TimeInForce>(tif[i]);
+            ev.order_type = type[i] ? OrderType::MARKET : OrderType::LIMIT;
+        }
+        ev.recv_time = static_cast<TimeNs>(time[i]);
+        ev.batch_id = static_cast<BatchID>(batch[i]);
+        ev.trader_id = static_cast<int>(trader[i]);
+        out.push_back(std::move(ev));
+    }
+    return true;
+}
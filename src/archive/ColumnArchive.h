@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/OrderEvent.h"
+#include "book/OrderBook.h"
+
+// Compressed columnar archive of trades and order flow.
+//
+// Rows are buffered per column and written in chunks. Each column chunk is
+// encoded on its own (zigzag varint, delta + zigzag varint, or one bit per
+// row), so a reader can decode a single column without touching the others.
+// The chunk directory, with per-column min/max, is written as a footer on
+// close().
+//
+// File layout:
+//   "FOARCH01"
+//   column chunk payloads ...
+//   footer: u32 chunk count, then per chunk
+//           u8 stream, u32 rows, u8 columns, then per column
+//           u8 column, u8 encoding, u64 offset, u32 bytes, i64 min, i64 max
+//   u64 footer offset
+//   "FOARCH01"
+
+enum class ArchiveStream : uint8_t {
+    TRADES = 1,
+    ORDERS = 2
+};
+
+enum class ArchiveColumn : uint8_t {
+    // Trade stream
+    TRADE_TIME = 0,
+    TRADE_PRICE,
+    TRADE_QTY,
+    TRADE_BUY_TRADER,
+    TRADE_SELL_TRADER,
+    TRADE_COLLISION,
+    // Order stream
+    ORDER_TIME,
+    ORDER_ID,
+    ORDER_BATCH,
+    ORDER_TRADER,
+    ORDER_SIDE,
+    ORDER_PRICE,
+    ORDER_QTY,
+    ORDER_TIF,
+    ORDER_TYPE,
+    COUNT
+};
+
+enum class ColumnEncoding : uint8_t {
+    VARINT = 0,        // zigzag LEB128
+    DELTA_VARINT = 1,  // difference from previous row, zigzag LEB128
+    BITS = 2           // one bit per row (0/1 columns)
+};
+
+ArchiveStream column_stream(ArchiveColumn column);
+ColumnEncoding column_encoding(ArchiveColumn column);
+const char* column_name(ArchiveColumn column);
+bool parse_column_name(const std::string& name, ArchiveColumn& column);
+
+class ArchiveWriter {
+public:
+    explicit ArchiveWriter(size_t chunk_rows = 65536);
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    // Create or truncate path. Returns false and sets last_error().
+    bool open(const std::string& path);
+    // Flush partial chunks and write the footer
+    bool close();
+    bool is_open() const { return file_.is_open(); }
+
+    void append_trade(const Trade& trade, bool was_collision);
+    void append_order(const OrderEvent& ev);
+
+    uint64_t trades_written() const { return trade_rows_; }
+    uint64_t orders_written() const { return order_rows_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+    const std::string& path() const { return path_; }
+    const std::string& last_error() const { return last_error_; }
+
+private:
+    struct ColumnMeta {
+        ArchiveColumn column;
+        ColumnEncoding encoding;
+        uint64_t offset;
+        uint32_t bytes;
+        int64_t min;
+        int64_t max;
+    };
+    struct ChunkMeta {
+        ArchiveStream stream;
+        uint32_t rows;
+        std::vector<ColumnMeta> columns;
+    };
+
+    size_t chunk_rows_;
+    std::ofstream file_;
+    std::string path_;
+    std::string last_error_;
+
+    // Open chunk, one vector per column, indexed by ArchiveColumn
+    std::vector<std::vector<int64_t>> pending_;
+    std::vector<ChunkMeta> chunks_;
+    std::string scratch_;
+
+    uint64_t trade_rows_;
+    uint64_t order_rows_;
+    uint64_t bytes_written_;
+
+    void flush_stream(ArchiveStream stream);
+};
+
+struct ArchiveChunkInfo {
+    ArchiveStream stream;
+    uint32_t rows;
+    uint32_t bytes;      // encoded size of the requested column
+    int64_t min;
+    int64_t max;
+};
+
+class ArchiveReader {
+public:
+    // Reads the footer only; column data is loaded on demand
+    bool open(const std::string& path);
+
+    uint64_t row_count(ArchiveStream stream) const;
+    uint64_t column_bytes(ArchiveColumn column) const;
+    uint64_t file_bytes() const { return file_bytes_; }
+
+    // Chunk directory entries for one column, in file order
+    std::vector<ArchiveChunkInfo> column_chunks(ArchiveColumn column) const;
+
+    // Decode one column chunk by chunk. fn(const int64_t* values, size_t n)
+    // is called once per chunk; no other column is read.
+    template <typename Fn>
+    bool scan_column(ArchiveColumn column, Fn&& fn) {
+        std::vector<int64_t> values;
+        for (const auto& chunk : chunks_) {
+            const ColumnEntry* entry = find_entry(chunk, column);
+            if (!entry) continue;
+            if (!decode_entry(*entry, chunk.rows, values)) return false;
+            fn(values.data(), values.size());
+        }
+        return true;
+    }
+
+    bool read_column(ArchiveColumn column, std::vector<int64_t>& out);
+    bool read_orders(std::vector<OrderEvent>& out);
+
+    const std::string& last_error() const { return last_error_; }
+
+private:
+    struct ColumnEntry {
+        ArchiveColumn column;
+        ColumnEncoding encoding;
+        uint64_t offset;
+        uint32_t bytes;
+        int64_t min;
+        int64_t max;
+    };
+    struct Chunk {
+        ArchiveStream stream;
+        uint32_t rows;
+        std::vector<ColumnEntry> columns;
+    };
+
+    std::ifstream file_;
+    std::vector<Chunk> chunks_;
+    std::vector<char> buf_;
+    uint64_t file_bytes_ = 0;
+    std::string last_error_;
+
+    static const ColumnEntry* find_entry(const Chunk& chunk, ArchiveColumn column);
+    bool decode_entry(const ColumnEntry& entry, uint32_t rows, std::vector<int64_t>& out);
+};
@@ -0,0 +1,235 @@
+#include "batching/BatchColumns.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define FAIRORDER_BATCH_SIMD 1
+#endif
+
+void BatchColumns::assign(OrderSpan batch) {
+    size_t n = batch.size();
+    price.resize(n);
+    qty.resize(n);
+    side.resize(n);
+    order_id.resize(n);
+    recv_time.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const OrderEvent& ev = batch[i];
+        price[i] = effective_price(ev);
+        qty[i] = ev.qty;
+        side[i] = static_cast<int8_t>(ev.side);
+        order_id[i] = ev.order_id;
+        recv_time[i] = ev.recv_time;
+    }
+}
+
+// ---- scalar kernels (also handle the tails of the vector loops) ----
+
+static void summarize_scalar(const BatchColumns& cols, size_t from, BatchSummary& s) {
+    for (size_t i = from; i < cols.size(); ++i) {
+        if (cols.side[i] == 0) {
+            if (cols.price[i] > s.max_bid) s.max_bid = cols.price[i];
+            s.buy_qty += cols.qty[i];
+        } else {
+            if (cols.price[i] < s.min_ask) s.min_ask = cols.price[i];
+            s.sell_qty += cols.qty[i];
+        }
+    }
+}
+
+static size_t mask_scalar(const BatchColumns& cols, size_t from, Price buy_limit, Price sell_limit, uint8_t* mask) {
+    size_t count = 0;
+    for (size_t i = from; i < cols.size(); ++i) {
+        bool m = cols.side[i] == 0 ? cols.price[i] >= buy_limit : cols.price[i] <= sell_limit;
+        mask[i] = m;
+        count += m;
+    }
+    return count;
+}
+
+static BatchSummary summarize_generic(const BatchColumns& cols) {
+    BatchSummary s{std::numeric_limits<Price>::min(), std::numeric_limits<Price>::max(), 0, 0};
+    summarize_scalar(cols, 0, s);
+    return s;
+}
+
+static size_t mask_generic(const BatchColumns& cols, Price buy_limit, Price sell_limit, uint8_t* mask) {
+    return mask_scalar(cols, 0, buy_limit, sell_limit, mask);
+}
+
+#ifdef FAIRORDER_BATCH_SIMD
+
+// Sides are widened from int8 to one 64-bit lane each, then turned into an
+// all-ones lane mask for sells. AVX2 has no 64-bit min/max, so those are
+// compare + blend.
+
+__attribute__((target("avx2")))
+static BatchSummary summarize_avx2(const BatchColumns& cols) {
+    const __m256i lowest = _mm256_set1_epi64x(std::numeric_limits<Price>::min());
+    const __m256i highest = _mm256_set1_epi64x(std::numeric_limits<Price>::max());
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i max_bid = lowest, min_ask = highest, buy_qty = zero, sell_qty = zero;
+
+    size_t n = cols.size(), i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols.price.data() + i));
+        __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols.qty.data() + i));
+        int32_t sides;
+        std::memcpy(&sides, cols.side.data() + i, sizeof(sides));
+        __m256i sell = _mm256_sub_epi64(zero, _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(sides)));
+
+        __m256i bid = _mm256_blendv_epi8(p, lowest, sell);
+        __m256i ask = _mm256_blendv_epi8(highest, p, sell);
+        max_bid = _mm256_blendv_epi8(max_bid, bid, _mm256_cmpgt_epi64(bid, max_bid));
+        min_ask = _mm256_blendv_epi8(min_ask, ask, _mm256_cmpgt_epi64(min_ask, ask));
+        sell_qty = _mm256_add_epi64(sell_qty, _mm256_and_si256(sell, q));
+        buy_qty = _mm256_add_epi64(buy_qty, _mm256_andnot_si256(sell, q));
+    }
+
+    alignas(32) int64_t lanes[4][4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), max_bid);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), min_ask);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), buy_qty);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[3]), sell_qty);
+
+    BatchSummary s{std::numeric_limits<Price>::min(), std::numeric_limits<Price>::max(), 0, 0};
+    for (int l = 0; l < 4; ++l) {
+        s.max_bid = std::max<Price>(s.max_bid, lanes[0][l]);
+        s.min_ask = std::min<Price>(s.min_ask, lanes[1][l]);
+        s.buy_qty += lanes[2][l];
+        s.sell_qty += lanes[3][l];
+    }
+    summarize_scalar(cols, i, s);
+    return s;
+}
+
+__attribute__((target("avx2")))
+static size_t mask_avx2(const BatchColumns& cols, Price buy_limit, Price sell_limit, uint8_t* mask) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i buy_lim = _mm256_set1_epi64x(buy_limit);
+    const __m256i sell_lim = _mm256_set1_epi64x(sell_limit);
+
+    size_t n = cols.size(), i = 0, count = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols.price.data() + i));
+        int32_t sides;
+        std::memcpy(&sides, cols.side.data() + i, sizeof(sides));
+        __m256i sell = _mm256_sub_epi64(zero, _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(sides)));
+
+        // Passive: buy below buy_limit, sell above sell_limit
+        __m256i buy_passive = _mm256_andnot_si256(sell, _mm256_cmpgt_epi64(buy_lim, p));
+        __m256i sell_passive = _mm256_and_si256(sell, _mm256_cmpgt_epi64(p, sell_lim));
+        int passive = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(buy_passive, sell_passive)));
+
+        int bits = ~passive & 0xF;
+        for (int l = 0; l < 4; ++l) mask[i + l] = (bits >> l) & 1;
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(bits)));
+    }
+    return count + mask_scalar(cols, i, buy_limit, sell_limit, mask);
+}
+
+__attribute__((target("sse4.2")))
+static BatchSummary summarize_sse42(const BatchColumns& cols) {
+    const __m128i lowest = _mm_set1_epi64x(std::numeric_limits<Price>::min());
+    const __m128i highest = _mm_set1_epi64x(std::numeric_limits<Price>::max());
+    const __m128i zero = _mm_setzero_si128();
+    __m128i max_bid = lowest, min_ask = highest, buy_qty = zero, sell_qty = zero;
+
+    size_t n = cols.size(), i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols.price.data() + i));
+        __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols.qty.data() + i));
+        int16_t sides;
+        std::memcpy(&sides, cols.side.data() + i, sizeof(sides));
+        __m128i sell = _mm_sub_epi64(zero, _mm_cvtepi8_epi64(_mm_cvtsi32_si128(static_cast<uint16_t>(sides))));
+
+        __m128i bid = _mm_blendv_epi8(p, lowest, sell);
+        __m128i ask = _mm_blendv_epi8(highest, p, sell);
+        max_bid = _mm_blendv_epi8(max_bid, bid, _mm_cmpgt_epi64(bid, max_bid));
+        min_ask = _mm_blendv_epi8(min_ask, ask, _mm_cmpgt_epi64(min_ask, ask));
+        sell_qty = _mm_add_epi64(sell_qty, _mm_and_si128(sell, q));
+        buy_qty = _mm_add_epi64(buy_qty, _mm_andnot_si128(sell, q));
+    }
+
+    alignas(16) int64_t lanes[4][2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes[0]), max_bid);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes[1]), min_ask);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes[2]), buy_qty);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes[3]), sell_qty);
+
+    BatchSummary s{std::numeric_limits<Price>::min(), std::numeric_limits<Price>::max(), 0, 0};
+    for (int l = 0; l < 2; ++l) {
+        s.max_bid = std::max<Price>(s.max_bid, lanes[0][l]);
+        s.min_ask = std::min<Price>(s.min_ask, lanes[1][l]);
+        s.buy_qty += lanes[2][l];
+        s.sell_qty += lanes[3][l];
+    }
+    summarize_scalar(cols, i, s);
+    return s;
+}
+
+__attribute__((target("sse4.2")))
+static size_t mask_sse42(const BatchColumns& cols, Price buy_limit, Price sell_limit, uint8_t* mask) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i buy_lim = _mm_set1_epi64x(buy_limit);
+    const __m128i sell_lim = _mm_set1_epi64x(sell_limit);
+
+    size_t n = cols.size(), i = 0, count = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols.price.data() + i));
+        int16_t sides;
+        std::memcpy(&sides, cols.side.data() + i, sizeof(sides));
+        __m128i sell = _mm_sub_epi64(zero, _mm_cvtepi8_epi64(_mm_cvtsi32_si128(static_cast<uint16_t>(sides))));
+
+        __m128i buy_passive = _mm_andnot_si128(sell, _mm_cmpgt_epi64(buy_lim, p));
+        __m128i sell_passive = _mm_and_si128(sell, _mm_cmpgt_epi64(p, sell_lim));
+        int passive = _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(buy_passive, sell_passive)));
+
+        int bits = ~passive & 0x3;
+        mask[i] = bits & 1;
+        mask[i + 1] = (bits >> 1) & 1;
+        count += static_cast<size_t>((bits & 1) + ((bits >> 1) & 1));
+    }
+    return count + mask_scalar(cols, i, buy_limit, sell_limit, mask);
+}
+
+#endif // FAIRORDER_BATCH_SIMD
+
+namespace {
+
+struct KernelSet {
+    BatchSummary (*summarize)(const BatchColumns&);
+    size_t (*mask)(const BatchColumns&, Price, Price, uint8_t*);
+    const char* isa;
+};
+
+KernelSet pick_kernels() {
+#ifdef FAIRORDER_BATCH_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {summarize_avx2, mask_avx2, "avx2"};
+    if (__builtin_cpu_supports("sse4.2")) return {summarize_sse42, mask_sse42, "sse4.2"};
+#endif
+    return {summarize_generic, mask_generic, "scalar"};
+}
+
+const KernelSet& kernels() {
+    static const KernelSet set = pick_kernels();
+    return set;
+}
+
+} // namespace
+
+BatchSummary summarize_batch(const BatchColumns& cols) {
+    return kernels().summarize(cols);
+}
+
+size_t marketable_mask(const BatchColumns& cols, Price buy_limit, Price sell_limit, uint8_t* mask) {
+    return kernels().mask(cols, buy_limit, sell_limit, mask);
+}
+
+const char* batch_kernel_isa() {
+    return kernels().isa;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "core/OrderEvent.h"
+
+// Structure-of-arrays copy of a batch: the fields pre-match screening and
+// priority sorting read, each in its own contiguous array, so the kernels
+// below stream through them with vector loads.
+struct BatchColumns {
+    std::vector<Price>   price;      // effective_price: market orders at the sentinel
+    std::vector<Qty>     qty;
+    std::vector<int8_t>  side;       // 0 = buy, 1 = sell (Side values)
+    std::vector<OrderID> order_id;
+    std::vector<TimeNs>  recv_time;
+
+    // Reuses capacity, so a long-lived BatchColumns stops allocating
+    void assign(OrderSpan batch);
+    size_t size() const { return price.size(); }
+};
+
+// Per-batch reductions. An empty side reports an uncrossable sentinel
+// (numeric_limits min for max_bid, max for min_ask).
+struct BatchSummary {
+    Price max_bid;
+    Price min_ask;
+    Qty   buy_qty;
+    Qty   sell_qty;
+};
+
+BatchSummary summarize_batch(const BatchColumns& cols);
+
+// mask[i] = 1 if order i may trade: a buy priced at or above buy_limit, or a
+// sell at or below sell_limit. Returns the number of marketable orders.
+size_t marketable_mask(const BatchColumns& cols, Price buy_limit, Price sell_limit, uint8_t* mask);
+
+// Kernel set picked at startup: "avx2", "sse4.2" or "scalar"
+const char* batch_kernel_isa();
@@ -1,43 +1,290 @@
 //#include "MicroBatcher.h"
 #include "batching/MicroBatcher.h"
+#include "metrics/PipelineStats.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 using namespace std;
 
 MicroBatcher::MicroBatcher(TimeNs batch_window_ns)
-    : window_ns(batch_window_ns),
+    : MicroBatcher([batch_window_ns] {
+          BatchPolicy p;
+          p.window_ns = batch_window_ns;
+          return p;
+      }()) {}
+
+MicroBatcher::MicroBatcher(const BatchPolicy& batch_policy)
+    : policy(batch_policy),
+      window_ns(batch_policy.window_ns),
       batch_start_ns(0),
-      next_batch_id(1) {}
+      latest_recv_ns(0),
+      next_batch_id(1),
+      last_arrival_ns(0),
+      gap_ewma_ns(0),
+      buffer_bytes(0),
+      blocked(false),
+      held_back(false) {}
+
+Admission MicroBatcher::submit(OrderEvent&& ev) {
+    StageTimer timer(Stage::SUBMIT, 1);
+    Admission verdict = admit(ev);
+    // An order held back or refused still shows how far time has moved, so
+    // a full batch keeps aging toward its window instead of stalling
+    if (verdict != Admission::ACCEPTED && !buffer.empty()) {
+        latest_recv_ns = max(latest_recv_ns, ev.recv_time);
+    }
+    switch (verdict) {
+        case Admission::ACCEPTED:
+            observe_arrival(ev.recv_time);
+            append(move(ev));
+            stats.accepted++;
+            break;
+        case Admission::DEFERRED:
+            observe_arrival(ev.recv_time);
+            loads[ev.trader_id].deferred++;
+            deferred.push_back(move(ev));
+            stats.deferred++;
+            break;
+        case Admission::REJECTED_FULL:
+            stats.rejected_full++;
+            break;
+        case Admission::REJECTED_TRADER:
+            stats.rejected_trader++;
+            break;
+        case Admission::WOULD_BLOCK:
+            blocked = true;
+            stats.blocked++;
+            break;
+    }
+    stats.peak_pending = max(stats.peak_pending, pending());
+    return verdict;
+}
+
+Admission MicroBatcher::admit(const OrderEvent& ev) {
+    bool full = policy.max_pending > 0 && pending() >= policy.max_pending;
+    bool over_cap = false;
+    if (policy.max_in_flight > 0) {
+        auto it = loads.find(ev.trader_id);
+        over_cap = it != loads.end() &&
+                   (it->second.deferred > 0 || it->second.open >= policy.max_in_flight);
+    }
+    if (!full && !over_cap) return Admission::ACCEPTED;
+
+    switch (policy.overflow) {
+        case OverflowPolicy::BLOCK:
+            return Admission::WOULD_BLOCK;
+        case OverflowPolicy::DEFER:
+            return full ? Admission::REJECTED_FULL : Admission::DEFERRED;
+        case OverflowPolicy::REJECT:
+            break;
+    }
+    return full ? Admission::REJECTED_FULL : Admission::REJECTED_TRADER;
+}
 
-void MicroBatcher::submit(OrderEvent&& ev) {
+void MicroBatcher::append(OrderEvent&& ev) {
     if (buffer.empty()) {
+        if (policy.adaptive) {
+            window_ns = adapted_window();
+        }
         batch_start_ns = ev.recv_time;
+        latest_recv_ns = ev.recv_time;
+        buffer_bytes = 0;
+    }
+    latest_recv_ns = max(latest_recv_ns, ev.recv_time);
+    buffer_bytes += event_bytes(ev);
+    if (policy.max_in_flight > 0) {
+        loads[ev.trader_id].open++;
     }
     buffer.push_back(move(ev));
 }
 
+// After a pop: deferred orders join the open batch, oldest first, while
+// their traders are under the cap and they arrived within the batch's
+// window. The first that does not fit holds back the rest, and the open
+// batch seals at the next check so they can start the one after it.
+void MicroBatcher::release_deferred() {
+    held_back = false;
+    for (size_t n = deferred.size(); n > 0; --n) {
+        OrderEvent ev = move(deferred.front());
+        deferred.pop_front();
+        if (!held_back && !buffer.empty()) {
+            TimeNs span = max(latest_recv_ns, ev.recv_time) - min(batch_start_ns, ev.recv_time);
+            held_back = has_ready_batch() || span > window_ns;
+        }
+        bool room = !held_back;
+        auto it = loads.find(ev.trader_id);
+        if (it != loads.end()) {
+            if (it->second.deferred > 0) it->second.deferred--;
+            room = room && (policy.max_in_flight == 0 || it->second.open < policy.max_in_flight);
+            if (!room) it->second.deferred++;
+        }
+        if (room) {
+            // If it arrived before the batch's first member, the window
+            // runs from it, so the batch seals in time to keep the bound
+            batch_start_ns = buffer.empty() ? ev.recv_time : min(batch_start_ns, ev.recv_time);
+            append(move(ev));
+            stats.released++;
+        } else {
+            deferred.push_back(move(ev));
+        }
+    }
+}
+
 bool MicroBatcher::has_ready_batch() const {
     if (buffer.empty()) return false;
-    return (buffer.back().recv_time - batch_start_ns) >= window_ns;
+    if (blocked || held_back) return true;
+    if (policy.max_batch_size > 0 && buffer.size() >= policy.max_batch_size) return true;
+    if (policy.max_batch_bytes > 0 && buffer_bytes >= policy.max_batch_bytes) return true;
+    return (latest_recv_ns - batch_start_ns) >= window_ns;
+}
+
+bool MicroBatcher::has_expired_batch(TimeNs now) const {
+    if (has_ready_batch()) return true;
+    if (buffer.empty()) return false;
+    return now > batch_start_ns && (now - batch_start_ns) >= window_ns;
 }
 
 vector<OrderEvent> MicroBatcher::pop_batch() {
-    for (auto& ev : buffer) {
+    StageTimer timer(Stage::POP_BATCH, 0);
+    if (buffer.empty()) release_deferred();
+    size_t count = buffer.size();
+    if (policy.max_batch_size > 0) {
+        count = min(count, policy.max_batch_size);
+    }
+    if (policy.max_batch_bytes > 0 && buffer_bytes > policy.max_batch_bytes) {
+        // The longest prefix within the byte budget, at least one event
+        size_t bytes = 0, fits = 0;
+        while (fits < count && (fits == 0 || bytes + event_bytes(buffer[fits]) <= policy.max_batch_bytes)) {
+            bytes += event_bytes(buffer[fits++]);
+        }
+        count = fits;
+    }
+
+    vector<OrderEvent> out;
+    if (count == buffer.size()) {
+        out.swap(buffer);
+        if (!spares.empty()) {
+            buffer.swap(spares.back());
+            spares.pop_back();
+        }
+    } else {
+        if (!spares.empty()) {
+            out.swap(spares.back());
+            spares.pop_back();
+        }
+        // Cap reached: seal the oldest events, keep the rest as the next batch
+        out.assign(make_move_iterator(buffer.begin()),
+                   make_move_iterator(buffer.begin() + count));
+        buffer.erase(buffer.begin(), buffer.begin() + count);
+        // recv_time is not monotonic across traders, so the front event is
+        // not necessarily the oldest one left
+        batch_start_ns = buffer.front().recv_time;
+        latest_recv_ns = batch_start_ns;
+        buffer_bytes = 0;
+        for (const auto& ev : buffer) {
+            batch_start_ns = min(batch_start_ns, ev.recv_time);
+            latest_recv_ns = max(latest_recv_ns, ev.recv_time);
+            buffer_bytes += event_bytes(ev);
+        }
+    }
+
+    size_t out_bytes = 0;
+    for (auto& ev : out) {
         ev.batch_id = next_batch_id;
+        out_bytes += event_bytes(ev);
+        if (policy.max_in_flight > 0) {
+            auto it = loads.find(ev.trader_id);
+            if (it != loads.end() && it->second.open > 0 && --it->second.open == 0 && it->second.deferred == 0) {
+                loads.erase(it);
+            }
+        }
     }
+    stats.peak_batch_bytes = max(stats.peak_batch_bytes, out_bytes);
+    blocked = false;
+    release_deferred();
+    timer.set_events(out.size());
+    PipelineStats::record_batch_size(out.size());
 
-    cout << "[MicroBatcher] Emitting batch "
-         << next_batch_id
-         << " with "
-         << buffer.size()
-         << " events\n";
+    if (policy.log_batches) {
+        cout << "[MicroBatcher] Emitting batch "
+             << next_batch_id
+             << " with "
+             << out.size()
+             << " events\n";
+    }
 
     next_batch_id++;
-
-    vector<OrderEvent> out;
-    out.swap(buffer);
     return out;
 }
 
+void MicroBatcher::recycle(vector<OrderEvent>&& batch) {
+    if (spares.size() >= kMaxSpares || batch.capacity() == 0) return;
+    batch.clear();
+    spares.push_back(move(batch));
+}
+
+void MicroBatcher::set_window(TimeNs new_window_ns) {
+    policy.window_ns = new_window_ns;
+    window_ns = new_window_ns;
+    if (policy.adaptive) {
+        window_ns = clamp(window_ns, policy.min_window_ns, policy.max_window_ns);
+    }
+}
+
+void MicroBatcher::set_max_batch_size(size_t max_batch_size) {
+    policy.max_batch_size = max_batch_size;
+}
+
+void MicroBatcher::set_adaptive(bool adaptive, TimeNs min_window_ns, TimeNs max_window_ns) {
+    policy.adaptive = adaptive;
+    policy.min_window_ns = min(min_window_ns, max_window_ns);
+    policy.max_window_ns = max(min_window_ns, max_window_ns);
+    window_ns = adaptive ? adapted_window() : policy.window_ns;
+}
+
+void MicroBatcher::set_admission(size_t max_pending, size_t max_batch_bytes, size_t max_in_flight,
+                                 OverflowPolicy overflow) {
+    policy.max_pending = max_pending;
+    policy.max_batch_bytes = max_batch_bytes;
+    policy.max_in_flight = max_in_flight;
+    policy.overflow = overflow;
+
+    // Recount what is held, which was not tracked if there was no cap
+    loads.clear();
+    if (max_in_flight > 0) {
+        for (const auto& ev : buffer) loads[ev.trader_id].open++;
+        for (const auto& ev : deferred) loads[ev.trader_id].deferred++;
+    }
+}
+
+void MicroBatcher::observe_arrival(TimeNs recv_time) {
+    if (last_arrival_ns != 0) {
+        TimeNs gap = recv_time > last_arrival_ns ? recv_time - last_arrival_ns : 0;
+        if (gap_ewma_ns == 0) {
+            gap_ewma_ns = gap;
+        } else {
+            // EWMA with alpha = 1/8
+            int64_t delta = static_cast<int64_t>(gap) - static_cast<int64_t>(gap_ewma_ns);
+            gap_ewma_ns = static_cast<TimeNs>(static_cast<int64_t>(gap_ewma_ns) + delta / 8);
+        }
+    }
+    last_arrival_ns = max(last_arrival_ns, recv_time);
+}
+
+TimeNs MicroBatcher::adapted_window() const {
+    if (gap_ewma_ns == 0) {
+        return clamp(policy.window_ns, policy.min_window_ns, policy.max_window_ns);
+    }
+    // Quiet: even the widest window would not catch two orders, so there is
+    // nothing to equalize and batching only adds delay.
+    if (gap_ewma_ns * 2 > policy.max_window_ns) {
+        return policy.min_window_ns;
+    }
+    // Busy: size the window to collect roughly target_batch_size events
+    TimeNs w = gap_ewma_ns * static_cast<TimeNs>(policy.target_batch_size);
+    return clamp(w, policy.min_window_ns, policy.max_window_ns);
+}
+
 /*
 vector<OrderEvent> MicroBatcher::pop_batch() {
     for (auto& ev : buffer) {
@@ -49,4 +296,4 @@ vector<OrderEvent> MicroBatcher::pop_batch() {
     out.swap(buffer);
     return out;
 }
-*/
\ No newline at end of file
+*/
@@ -1,21 +1,132 @@
 #pragma once
+#include <deque>
+#include <unordered_map>
 #include <vector>
 #include "core/OrderEvent.h"
 
 using namespace std;
 
+// What submit() does with an order that would break an admission limit
+enum class OverflowPolicy : uint8_t {
+    REJECT,   // refuse it, saying which limit
+    DEFER,    // over its trader's cap: hold it for a later batch. A full
+              // batcher has nowhere to hold it and rejects.
+    BLOCK     // leave it with the producer, which matches the open batch
+              // (has_ready_batch() turns true) and submits it again
+};
+
+enum class Admission : uint8_t {
+    ACCEPTED,
+    DEFERRED,          // held back, joins a later batch
+    REJECTED_FULL,     // max_pending events already held
+    REJECTED_TRADER,   // its trader already has max_in_flight in the open batch
+    WOULD_BLOCK        // not taken: pop a batch, then submit it again
+};
+
+struct AdmissionStats {
+    uint64_t accepted = 0;
+    uint64_t deferred = 0;
+    uint64_t released = 0;          // deferred orders that joined a batch
+    uint64_t rejected_full = 0;
+    uint64_t rejected_trader = 0;
+    uint64_t blocked = 0;           // WOULD_BLOCK answers
+    size_t   peak_pending = 0;
+    size_t   peak_batch_bytes = 0;
+};
+
+// Batching policy. A batch is sealed when its window elapses or, if
+// max_batch_size is non-zero, as soon as it holds that many events.
+// The window runs from the batch's first arrival, so its members arrived
+// at most window_ns after it, except the one that seals the batch. Deferred
+// orders keep that bound: one is only released into a batch whose first
+// and newest arrivals are within window_ns of it, otherwise it waits for
+// the next, and the window then runs from it if it is the older.
+struct BatchPolicy {
+    TimeNs window_ns      = 100'000;
+    size_t max_batch_size = 0;        // 0 = unbounded
+
+    // Adaptive window: re-derived from the observed arrival rate each time
+    // a new batch opens, clamped to [min_window_ns, max_window_ns].
+    bool   adaptive          = false;
+    TimeNs min_window_ns     = 10'000;
+    TimeNs max_window_ns     = 1'000'000;
+    size_t target_batch_size = 16;   // events a busy window should collect
+
+    // Admission control, 0 = no limit. Memory held by the batcher stays
+    // within max_pending events however far matching falls behind.
+    size_t max_pending     = 0;       // events held: open batch plus deferred
+    size_t max_batch_bytes = 0;       // seal a batch before it exceeds this
+    size_t max_in_flight   = 0;       // per trader, in the open batch
+    OverflowPolicy overflow = OverflowPolicy::REJECT;
+
+    bool   log_batches = true;        // print a line per emitted batch
+};
+
 class MicroBatcher {
 public:
     explicit MicroBatcher(TimeNs batch_window_ns);
+    explicit MicroBatcher(const BatchPolicy& policy);
 
-    void submit(OrderEvent&& ev);
+    // ev is moved from unless the answer is WOULD_BLOCK
+    Admission submit(OrderEvent&& ev);
     bool has_ready_batch() const;
+    // True if the open batch's window has passed by wall time `now`, for
+    // sealing batches while no new orders arrive
+    bool has_expired_batch(TimeNs now) const;
+    // The batch's events move out with no copy; handing the vector back
+    // through recycle() once matched lets the next batches reuse its
+    // storage instead of regrowing the buffer
     vector<OrderEvent> pop_batch();
+    void recycle(vector<OrderEvent>&& batch);
+
+    // Live reconfiguration; buffered events are kept and the open batch
+    // is judged against the new settings.
+    void set_window(TimeNs window_ns);
+    void set_max_batch_size(size_t max_batch_size);
+    void set_adaptive(bool adaptive, TimeNs min_window_ns, TimeNs max_window_ns);
+    // Applies to later submissions; what is already held stays
+    void set_admission(size_t max_pending, size_t max_batch_bytes, size_t max_in_flight, OverflowPolicy overflow);
+
+    TimeNs get_window() const { return window_ns; }
+    const BatchPolicy& get_policy() const { return policy; }
+    size_t pending() const { return buffer.size() + deferred.size(); }
+    const AdmissionStats& admission_stats() const { return stats; }
+
+    // Bytes an event counts for against max_batch_bytes
+    static size_t event_bytes(const OrderEvent& ev) { return sizeof(OrderEvent) + ev.instrument.size(); }
 
 private:
-    TimeNs window_ns;
+    BatchPolicy policy;
+    TimeNs window_ns;       // window of the currently open batch
     TimeNs batch_start_ns;
+    TimeNs latest_recv_ns;  // recv_time is not monotonic across traders
     BatchID next_batch_id;
 
+    // EWMA of inter-arrival gap, used by the adaptive policy
+    TimeNs last_arrival_ns;
+    TimeNs gap_ewma_ns;
+
     vector<OrderEvent> buffer;
-};
\ No newline at end of file
+    vector<vector<OrderEvent>> spares;   // recycled batch storage, emptied
+    static constexpr size_t kMaxSpares = 4;
+
+    // Admission state. Orders are deferred in arrival order and a trader
+    // with deferred orders defers its later ones too, so each trader's
+    // orders still reach the book in the order it sent them.
+    struct TraderLoad {
+        uint32_t open = 0;       // in buffer
+        uint32_t deferred = 0;
+    };
+    size_t buffer_bytes;
+    bool blocked;                // a WOULD_BLOCK is waiting on the next pop
+    bool held_back;              // deferred orders wait for a fresh batch
+    deque<OrderEvent> deferred;
+    unordered_map<int, TraderLoad> loads;   // only with max_in_flight set
+    AdmissionStats stats;
+
+    void observe_arrival(TimeNs recv_time);
+    TimeNs adapted_window() const;
+    Admission admit(const OrderEvent& ev);
+    void append(OrderEvent&& ev);
+    void release_deferred();
+};
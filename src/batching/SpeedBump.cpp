@@ -0,0 +1,145 @@
+#include "batching/SpeedBump.h"
+#include "metrics/PipelineStats.h"
+#include <algorithm>
+using namespace std;
+
+static bool release_order(const OrderEvent& a, const OrderEvent& b) {
+    if (a.release_time != b.release_time) return a.release_time < b.release_time;
+    return a.order_id < b.order_id;
+}
+
+SpeedBump::SpeedBump(TimeNs tick, size_t slots)
+    : tick_ns(max<TimeNs>(1, tick)),
+      in_wheel(0),
+      cursor_tick(0),
+      now_ns(0),
+      next_batch_id(1),
+      max_latency_ns(0) {
+    size_t n = 1;
+    while (n < slots) n <<= 1;
+    wheel.resize(n);
+    mask = n - 1;
+}
+
+void SpeedBump::set_trader_latency(int trader_id, TimeNs latency) {
+    if (trader_id < 0) return;
+    if (static_cast<size_t>(trader_id) >= latency_ns.size()) {
+        latency_ns.resize(static_cast<size_t>(trader_id) + 1, 0);
+    }
+    TimeNs previous = latency_ns[static_cast<size_t>(trader_id)];
+    latency_ns[static_cast<size_t>(trader_id)] = latency;
+    // Rescan only when the slowest trader got faster, so setting up a large
+    // population stays linear
+    if (latency >= max_latency_ns) {
+        max_latency_ns = latency;
+    } else if (previous == max_latency_ns) {
+        max_latency_ns = *max_element(latency_ns.begin(), latency_ns.end());
+    }
+}
+
+TimeNs SpeedBump::delay_for(int trader_id) const {
+    TimeNs latency = 0;
+    if (trader_id >= 0 && static_cast<size_t>(trader_id) < latency_ns.size()) {
+        latency = latency_ns[static_cast<size_t>(trader_id)];
+    }
+    return max_latency_ns - min(latency, max_latency_ns);
+}
+
+void SpeedBump::submit(OrderEvent&& ev) {
+    StageTimer timer(Stage::SUBMIT, 1);
+    now_ns = max(now_ns, ev.recv_time);
+    ev.release_time = ev.recv_time + delay_for(ev.trader_id);
+    TimeNs release = ev.release_time;
+    place(Entry{release, move(ev)});
+}
+
+void SpeedBump::advance(TimeNs now) {
+    now_ns = max(now_ns, now);
+}
+
+void SpeedBump::place(Entry&& e) {
+    // Already due: goes in the bucket released next
+    uint64_t tick = max<uint64_t>(e.release_ns / tick_ns, cursor_tick);
+    if (tick - cursor_tick <= mask) {
+        wheel[tick & mask].push_back(move(e));
+        in_wheel++;
+    } else {
+        overflow.push_back(move(e));
+    }
+}
+
+// Move overflow entries that now fall within the wheel's span
+void SpeedBump::fold_overflow() {
+    size_t kept = 0;
+    for (size_t i = 0; i < overflow.size(); ++i) {
+        uint64_t tick = overflow[i].release_ns / tick_ns;
+        if (tick < cursor_tick || tick - cursor_tick <= mask) {
+            place(move(overflow[i]));
+        } else {
+            if (kept != i) overflow[kept] = move(overflow[i]);
+            kept++;
+        }
+    }
+    overflow.erase(overflow.begin() + static_cast<ptrdiff_t>(kept), overflow.end());
+}
+
+// Release the first non-empty tick at or before last_tick
+void SpeedBump::release_next(uint64_t last_tick, vector<OrderEvent>& out) {
+    while (cursor_tick <= last_tick && pending() > 0) {
+        if (in_wheel == 0) {
+            // Nothing in the wheel: jump straight to the next overflow tick
+            uint64_t first = UINT64_MAX;
+            for (const auto& e : overflow) first = min<uint64_t>(first, e.release_ns / tick_ns);
+            if (first > last_tick) return;
+            cursor_tick = max(cursor_tick, first);
+            fold_overflow();
+            continue;
+        }
+
+        auto& bucket = wheel[cursor_tick & mask];
+        bool found = !bucket.empty();
+        if (found) {
+            for (auto& e : bucket) out.push_back(move(e.ev));
+            sort(out.begin(), out.end(), release_order);
+            in_wheel -= bucket.size();
+            bucket.clear();
+        }
+        cursor_tick++;
+        if ((cursor_tick & mask) == 0) fold_overflow();
+        if (found) return;
+    }
+}
+
+void SpeedBump::emit(vector<OrderEvent>& out) {
+    if (out.empty()) return;
+    for (auto& ev : out) {
+        ev.batch_id = next_batch_id;
+    }
+    next_batch_id++;
+    PipelineStats::record_batch_size(out.size());
+}
+
+vector<OrderEvent> SpeedBump::pop_due() {
+    StageTimer timer(Stage::POP_BATCH, 0);
+    vector<OrderEvent> out;
+    uint64_t now_tick = now_ns / tick_ns;
+    if (now_tick > 0) {
+        release_next(now_tick - 1, out);
+        if (pending() == 0) {
+            // Idle: later orders are placed relative to the present
+            cursor_tick = max<uint64_t>(cursor_tick, now_tick);
+        }
+    }
+    timer.set_events(out.size());
+    emit(out);
+    return out;
+}
+
+vector<OrderEvent> SpeedBump::pop_next() {
+    StageTimer timer(Stage::POP_BATCH, 0);
+    vector<OrderEvent> out;
+    release_next(UINT64_MAX - 1, out);
+    timer.set_events(out.size());
+    emit(out);
+    return out;
+}
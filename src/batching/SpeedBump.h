@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include "core/OrderEvent.h"
+
+using namespace std;
+
+// Latency-equalizing delay for SPEED_BUMP mode. Every order is held until
+// recv_time + (max_latency - latency of its trader), i.e. until the slowest
+// trader's copy of the same decision would have arrived, and is then
+// released for continuous matching.
+//
+// Pending orders sit in a timing wheel of tick_ns buckets: submit and
+// release are O(1) per order however many are in flight. A bucket only ever
+// holds one tick's orders and is released as one batch, sorted by (release
+// time, order id); orders released in the same tick are the ones that count
+// as competing. Orders further out than the wheel's span wait in an
+// overflow list that is folded in once per revolution.
+//
+// Time advances with the latest recv_time submitted (as in MicroBatcher) or
+// explicitly through advance(). Released orders keep their recv_time and
+// carry release_time, which is their time priority in the book.
+class SpeedBump {
+public:
+    explicit SpeedBump(TimeNs tick_ns = 10'000, size_t slots = 1024);
+
+    // Latency of a trader (ids are dense, small integers). Unknown traders
+    // count as zero latency and get the full delay.
+    void set_trader_latency(int trader_id, TimeNs latency);
+    TimeNs get_max_latency() const { return max_latency_ns; }
+    TimeNs delay_for(int trader_id) const;
+
+    void submit(OrderEvent&& ev);
+    void advance(TimeNs now);
+
+    // The next tick whose time has fully passed, as one batch in release
+    // order; empty when none is due. Releases may be up to one tick late,
+    // never early.
+    vector<OrderEvent> pop_due();
+    // The next non-empty tick regardless of time, for draining
+    vector<OrderEvent> pop_next();
+
+    size_t pending() const { return in_wheel + overflow.size(); }
+    TimeNs get_tick() const { return tick_ns; }
+
+private:
+    struct Entry {
+        TimeNs release_ns;
+        OrderEvent ev;
+    };
+
+    TimeNs tick_ns;
+    size_t mask;
+    vector<vector<Entry>> wheel;
+    vector<Entry> overflow;
+    size_t in_wheel;
+    uint64_t cursor_tick;   // every tick before this has been released
+    TimeNs now_ns;
+    BatchID next_batch_id;
+
+    vector<TimeNs> latency_ns;   // by trader id
+    TimeNs max_latency_ns;
+
+    void place(Entry&& e);
+    void fold_overflow();
+    void release_next(uint64_t last_tick, vector<OrderEvent>& out);
+    void emit(vector<OrderEvent>& out);
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+#include "core/OrderEvent.h"
+
+// Competition outcomes settled by one arriving order
+struct ContentionOutcome {
+    int loser = -1;             // -1 = none
+    std::vector<int> winners;   // leaders of the competitions that closed
+};
+
+// Who contended for each price level when orders are matched one at a time
+// and there is no batch to compare within. Orders on the same side and
+// price whose recv_time falls within `horizon` of the first one form a
+// competition, the streaming counterpart of a batch: every order from a
+// trader other than the leader loses at once, and the leader wins once,
+// when the competition closes, so each competition has exactly one winner
+// as a batch does. One hash lookup per order. Arrivals are expected in
+// recv_time order; an earlier stamp arriving late was first all the same,
+// so it takes the lead and the leader it displaces loses. A competition
+// closes when a later arrival at its level starts a new one, when it is
+// swept out past the horizon of the latest arrival (amortized over
+// arrivals, so levels no longer traded do not accumulate), or at settle().
+class ContentionTracker {
+public:
+    explicit ContentionTracker(TimeNs horizon = 100'000) : horizon_(horizon) {}
+
+    void set_horizon(TimeNs horizon) { horizon_ = horizon; }
+    TimeNs get_horizon() const { return horizon_; }
+    void clear() {
+        levels_[0].clear();
+        levels_[1].clear();
+        latest_ = 0;
+        since_sweep_ = 0;
+    }
+
+    void on_arrival(Side side, Price price, TimeNs recv_time, int trader_id, ContentionOutcome& out) {
+        out.loser = -1;
+        out.winners.clear();
+        latest_ = std::max(latest_, recv_time);
+        if (++since_sweep_ >= std::max<size_t>(kMinSweep, levels_[0].size() + levels_[1].size())) {
+            sweep(out.winners);
+        }
+
+        auto& levels = levels_[side == Side::BUY ? 0 : 1];
+        auto [it, inserted] = levels.try_emplace(price, Window{recv_time, trader_id, false});
+        if (inserted) return;
+
+        Window& w = it->second;
+        if (recv_time > w.start && recv_time - w.start > horizon_) {
+            if (w.contested) out.winners.push_back(w.leader);
+            w = Window{recv_time, trader_id, false};
+            return;
+        }
+        if (recv_time < w.start) {
+            if (w.start - recv_time > horizon_) return;   // its own window is gone
+            w.start = recv_time;
+            if (trader_id == w.leader) return;
+            out.loser = w.leader;
+            w.leader = trader_id;
+            w.contested = true;
+            return;
+        }
+        if (trader_id == w.leader) return;
+        out.loser = trader_id;
+        w.contested = true;
+    }
+
+    // Close every open competition, appending the winners; the end of a stream
+    void settle(std::vector<int>& winners) {
+        for (auto& levels : levels_) {
+            for (const auto& [price, w] : levels) {
+                if (w.contested) winners.push_back(w.leader);
+            }
+            levels.clear();
+        }
+        since_sweep_ = 0;
+    }
+
+private:
+    static constexpr size_t kMinSweep = 4096;
+
+    struct Window {
+        TimeNs start;   // recv_time of the first order
+        int leader;
+        bool contested; // another trader has lost to the leader
+    };
+
+    TimeNs horizon_;
+    std::unordered_map<Price, Window> levels_[2];
+    TimeNs latest_ = 0;        // newest recv_time seen
+    size_t since_sweep_ = 0;   // arrivals since the last sweep
+
+    // Close windows no later arrival can join; one pass per as many
+    // arrivals as there are windows
+    void sweep(std::vector<int>& winners) {
+        since_sweep_ = 0;
+        for (auto& levels : levels_) {
+            for (auto it = levels.begin(); it != levels.end();) {
+                if (latest_ - it->second.start <= horizon_) {
+                    ++it;
+                    continue;
+                }
+                if (it->second.contested) winners.push_back(it->second.leader);
+                it = levels.erase(it);
+            }
+        }
+    }
+};
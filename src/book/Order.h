@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include "core/HugePages.h"
+#include "core/OrderEvent.h"
+
+struct Order {
+    OrderID order_id;
+    Price price;
+    Qty qty;
+    Qty remaining_qty;
+    TimeNs time;   // priority_time() of its event
+    BatchID batch_id;
+    int trader_id;
+    
+    Order(const OrderEvent& ev, int trader_id)
+        : order_id(ev.order_id), price(effective_price(ev)), qty(ev.qty),
+          remaining_qty(ev.qty), time(priority_time(ev)),
+          batch_id(ev.batch_id), trader_id(ev.trader_id != 0 ? ev.trader_id : trader_id) {}
+    explicit Order(const OrderEvent& ev) : Order(ev, ev.trader_id) {}
+};
+
+struct Trade {
+    OrderID buy_order_id;
+    OrderID sell_order_id;
+    Price price;
+    Qty qty;
+    TimeNs execution_time;
+    int buy_trader_id;
+    int sell_trader_id;
+};
+
+// Price-time priority queue for BUY orders (best price first, then earliest time)
+struct BuyOrderComparator {
+    bool operator()(const Order& a, const Order& b) const {
+        if (a.price != b.price) return a.price < b.price; // Lower price = lower priority
+        return a.time > b.time; // Later time = lower priority
+    }
+};
+
+// Price-time priority queue for SELL orders (best price first, then earliest time)
+struct SellOrderComparator {
+    bool operator()(const Order& a, const Order& b) const {
+        if (a.price != b.price) return a.price > b.price; // Higher price = lower priority
+        return a.time > b.time; // Later time = lower priority
+    }
+};
+
+// Fair priority: price first, then order_id (ignores time)
+struct FairBuyOrderComparator {
+    bool operator()(const Order& a, const Order& b) const {
+        if (a.price != b.price) return a.price < b.price;
+        return a.order_id > b.order_id; // Higher ID = lower priority
+    }
+};
+
+struct FairSellOrderComparator {
+    bool operator()(const Order& a, const Order& b) const {
+        if (a.price != b.price) return a.price > b.price;
+        return a.order_id > b.order_id; // Higher ID = lower priority
+    }
+};
+
+// Priority queue that can also take a run of orders in one operation. Large
+// books live in huge-page backed storage (see HugePages.h).
+template <typename Comparator>
+class OrderHeap
+    : public std::priority_queue<Order, std::vector<Order, HugePageAllocator<Order>>, Comparator> {
+public:
+    void reserve(size_t n) { this->c.reserve(n); }
+    size_t capacity() const { return this->c.capacity(); }
+
+    // Resting quantity that crosses(price) accepts, without popping anything,
+    // stopping once `wanted` is reached. A child never outranks its parent,
+    // so a subtree is skipped as soon as its root does not cross.
+    template <typename Crosses>
+    Qty available(Crosses crosses, Qty wanted) const {
+        Qty sum = 0;
+        sum_crossing(0, crosses, wanted, sum);
+        return sum;
+    }
+
+    template <typename It>
+    void bulk_push(It first, It last) {
+        auto& c = this->c;
+        size_t n = c.size();
+        size_t k = static_cast<size_t>(std::distance(first, last));
+        if (k == 0) return;
+        c.insert(c.end(), first, last);
+        // Re-heapify is O(n + k); individual sift-ups are O(k log n).
+        // Pick whichever is cheaper for this batch.
+        size_t log_n = 1;
+        while ((size_t(1) << log_n) < n) ++log_n;
+        if (k * log_n >= n + k) {
+            std::make_heap(c.begin(), c.end(), this->comp);
+        } else {
+            for (size_t i = n; i < c.size(); ++i) {
+                std::push_heap(c.begin(), c.begin() + i + 1, this->comp);
+            }
+        }
+    }
+
+private:
+    // Children of heap slot i are 2i+1 and 2i+2
+    template <typename Crosses>
+    void sum_crossing(size_t i, Crosses& crosses, Qty wanted, Qty& sum) const {
+        const auto& c = this->c;
+        if (i >= c.size() || sum >= wanted || !crosses(c[i].price)) return;
+        sum += c[i].remaining_qty;
+        sum_crossing(2 * i + 1, crosses, wanted, sum);
+        sum_crossing(2 * i + 2, crosses, wanted, sum);
+    }
+};
@@ -1,227 +1,243 @@
 #include "book/OrderBook.h"
-#include <chrono>
+#include "core/Clock.h"
+#include "metrics/PipelineStats.h"
+#include "batching/BatchColumns.h"
+#include "book/ParallelSort.h"
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
-OrderBook::OrderBook(MatchingMode mode) : mode_(mode) {}
+OrderBook::OrderBook(MatchingMode mode)
+    : mode_(mode), batch_timestamps_(false), band_(false), band_low_(0), band_high_(-1),
+      sort_pool_(nullptr), parallel_sort_threshold_(65536), reserved_(0) {}
 
 Price OrderBook::get_best_bid() const {
-    if (mode_ == MatchingMode::NAIVE_PRICE_TIME) {
-        if (buy_orders_naive_.empty()) return 0;
-        return buy_orders_naive_.top().price;
-    } else {
-        if (buy_orders_fair_.empty()) return 0;
-        return buy_orders_fair_.top().price;
-    }
+    return with_sides([](const auto& buys, const auto&) -> Price {
+        return buys.empty() ? 0 : buys.top().price;
+    });
 }
 
 Price OrderBook::get_best_ask() const {
-    if (mode_ == MatchingMode::NAIVE_PRICE_TIME) {
-        if (sell_orders_naive_.empty()) return 0;
-        return sell_orders_naive_.top().price;
-    } else {
-        if (sell_orders_fair_.empty()) return 0;
-        return sell_orders_fair_.top().price;
-    }
+    return with_sides([](const auto&, const auto& sells) -> Price {
+        return sells.empty() ? 0 : sells.top().price;
+    });
 }
 
 size_t OrderBook::get_buy_depth() const {
-    return mode_ == MatchingMode::NAIVE_PRICE_TIME 
-        ? buy_orders_naive_.size() 
-        : buy_orders_fair_.size();
+    return with_sides([](const auto& buys, const auto&) { return buys.size(); });
 }
 
 size_t OrderBook::get_sell_depth() const {
-    return mode_ == MatchingMode::NAIVE_PRICE_TIME 
-        ? sell_orders_naive_.size() 
-        : sell_orders_fair_.size();
+    return with_sides([](const auto&, const auto& sells) { return sells.size(); });
 }
 
 void OrderBook::clear() {
-    while (!buy_orders_naive_.empty()) buy_orders_naive_.pop();
-    while (!sell_orders_naive_.empty()) sell_orders_naive_.pop();
-    while (!buy_orders_fair_.empty()) buy_orders_fair_.pop();
-    while (!sell_orders_fair_.empty()) sell_orders_fair_.pop();
+    with_sides([](auto& buys, auto& sells) {
+        while (!buys.empty()) buys.pop();
+        while (!sells.empty()) sells.pop();
+    });
+    contention_.clear();
+}
+
+void OrderBook::set_price_band(Price low, Price high) {
+    std::vector<Order> resting_buys;
+    std::vector<Order> resting_sells;
+    with_sides([&](auto& buys, auto& sells) {
+        for (; !buys.empty(); buys.pop()) resting_buys.push_back(buys.top());
+        for (; !sells.empty(); sells.pop()) resting_sells.push_back(sells.top());
+    });
+
+    band_ = high >= low;
+    if (band_) {
+        Price max_levels = static_cast<Price>(PriceBandSide<BuyOrderComparator, true>::kMaxLevels);
+        band_low_ = low;
+        band_high_ = std::min(high, low + max_levels - 1);
+        size_t levels = static_cast<size_t>(band_high_ - band_low_ + 1);
+        band_buy_naive_.configure(band_low_, levels);
+        band_sell_naive_.configure(band_low_, levels);
+        band_buy_fair_.configure(band_low_, levels);
+        band_sell_fair_.configure(band_low_, levels);
+    } else {
+        band_low_ = 0;
+        band_high_ = -1;
+    }
+
+    with_sides([&](auto& buys, auto& sells) {
+        buys.bulk_push(resting_buys.begin(), resting_buys.end());
+        sells.bulk_push(resting_sells.begin(), resting_sells.end());
+    });
+    if (reserved_ > 0) reserve(reserved_);
+}
+
+void OrderBook::reserve(size_t orders) {
+    reserved_ = orders;
+    with_sides([orders](auto& buys, auto& sells) {
+        buys.reserve(orders);
+        sells.reserve(orders);
+    });
 }
 
 TimeNs OrderBook::get_current_time() {
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()
-    ).count();
+    return TscClock::now_ns();
 }
 
-std::vector<Trade> OrderBook::process_order(const OrderEvent& ev, int trader_id) {
+std::vector<Trade> OrderBook::process_order(const OrderEvent& ev, int trader_id, ContentionOutcome* contention) {
+    StageTimer timer(Stage::MATCH, 1);
+    if (contention) {
+        contention_.on_arrival(ev.side, effective_price(ev), ev.recv_time,
+                               ev.trader_id != 0 ? ev.trader_id : trader_id, *contention);
+    }
     Order order(ev, trader_id);
-    return match_order(order, ev.side == Side::BUY);
+    return match_order(order, ev, get_current_time());
 }
 
-std::vector<Trade> OrderBook::process_batch(const std::vector<OrderEvent>& batch, const std::vector<int>& trader_ids) {
+std::vector<Trade> OrderBook::process_batch(OrderSpan batch) {
     std::vector<Trade> all_trades;
+    size_t n = batch.size();
+    
+    passive_buys_.clear();
+    passive_sells_.clear();
+    marketable_.clear();
     
-    // Sort batch by priority before processing
-    std::vector<std::pair<OrderEvent, int>> orders_with_traders;
-    for (size_t i = 0; i < batch.size(); ++i) {
-        orders_with_traders.push_back({batch[i], trader_ids[i]});
+    {
+        // Screen the batch in column form. A buy is passive if it is below
+        // both the best resting ask and every sell in this batch (and
+        // symmetrically for sells). Passive orders cannot trade in this batch
+        // whatever the processing order, so only the marketable subset is
+        // sorted and matched and the rest is merged into the book in one
+        // operation. Passive IOC/FOK orders are simply dropped.
+        StageTimer timer(Stage::SCREEN, n);
+        columns_.assign(batch);
+        BatchSummary summary = summarize_batch(columns_);
+        Price buy_limit = std::min(summary.min_ask, resting_best_ask());
+        Price sell_limit = std::max(summary.max_bid, resting_best_bid());
+        
+        mask_.resize(n);
+        size_t marketable = marketable_mask(columns_, buy_limit, sell_limit, mask_.data());
+        marketable_.reserve(marketable);
+        for (size_t i = 0; i < n; ++i) {
+            if (mask_[i]) {
+                marketable_.push_back(static_cast<uint32_t>(i));
+            } else if (!rests_remainder(batch[i])) {
+                PipelineStats::record_discard(batch[i].qty, batch[i].tif == TimeInForce::FOK);
+            } else if (columns_.side[i] == 0) {
+                passive_buys_.emplace_back(batch[i]);
+            } else {
+                passive_sells_.emplace_back(batch[i]);
+            }
+        }
     }
     
-    // Sort based on mode
-    if (mode_ == MatchingMode::LATENCY_FAIR_BATCHED) {
-        // Fair mode: price first, then order_id
-        std::sort(orders_with_traders.begin(), orders_with_traders.end(),
-            [](const auto& a, const auto& b) {
-                const auto& ev_a = a.first;
-                const auto& ev_b = b.first;
-                
-                if (ev_a.side != ev_b.side) return ev_a.side == Side::BUY;
-                
-                if (ev_a.side == Side::BUY) {
-                    if (ev_a.price != ev_b.price) return ev_a.price > ev_b.price;
-                    return ev_a.order_id < ev_b.order_id;
-                } else {
-                    if (ev_a.price != ev_b.price) return ev_a.price < ev_b.price;
-                    return ev_a.order_id < ev_b.order_id;
-                }
-            });
-    } else {
-        // Naive mode: price first, then recv_time
-        std::sort(orders_with_traders.begin(), orders_with_traders.end(),
-            [](const auto& a, const auto& b) {
-                const auto& ev_a = a.first;
-                const auto& ev_b = b.first;
-                
-                if (ev_a.side != ev_b.side) return ev_a.side == Side::BUY;
-                
-                if (ev_a.side == Side::BUY) {
-                    if (ev_a.price != ev_b.price) return ev_a.price > ev_b.price;
-                    return ev_a.recv_time < ev_b.recv_time;
-                } else {
-                    if (ev_a.price != ev_b.price) return ev_a.price < ev_b.price;
-                    return ev_a.recv_time < ev_b.recv_time;
-                }
-            });
+    {
+        StageTimer timer(Stage::BATCH_SORT, marketable_.size());
+        // Buys before sells, best price first, then order_id (fair) or
+        // recv_time (naive), then arrival in the batch so the serial and
+        // parallel sorts agree exactly
+        const auto& c = columns_;
+        const std::vector<uint64_t>& tiebreak = mode_ == MatchingMode::LATENCY_FAIR_BATCHED
+            ? c.order_id : c.recv_time;
+        auto priority = [&](uint32_t a, uint32_t b) {
+            if (c.side[a] != c.side[b]) return c.side[a] < c.side[b];
+            if (c.price[a] != c.price[b]) {
+                return c.side[a] == 0 ? c.price[a] > c.price[b] : c.price[a] < c.price[b];
+            }
+            if (tiebreak[a] != tiebreak[b]) return tiebreak[a] < tiebreak[b];
+            return a < b;
+        };
+        parallel_sort(marketable_.data(), marketable_.size(), priority, sort_pool_,
+                      parallel_sort_threshold_, sort_scratch_);
     }
     
-    // Process sorted orders
-    for (const auto& [ev, trader_id] : orders_with_traders) {
-        Order order(ev, trader_id);
-        auto trades = match_order(order, ev.side == Side::BUY);
+    StageTimer timer(Stage::MATCH, n);
+    
+    // One execution timestamp for the whole batch, or one per matched order
+    TimeNs batch_time = batch_timestamps_ ? get_current_time() : 0;
+    
+    for (uint32_t i : marketable_) {
+        Order order(batch[i]);
+        TimeNs exec_time = batch_timestamps_ ? batch_time : get_current_time();
+        auto trades = match_order(order, batch[i], exec_time);
         all_trades.insert(all_trades.end(), trades.begin(), trades.end());
     }
     
+    with_sides([&](auto& buys, auto& sells) {
+        buys.bulk_push(passive_buys_.begin(), passive_buys_.end());
+        sells.bulk_push(passive_sells_.begin(), passive_sells_.end());
+    });
+    
     return all_trades;
 }
 
-std::vector<Trade> OrderBook::match_order(Order& order, bool is_buy) {
-    std::vector<Trade> trades;
-    TimeNs exec_time = get_current_time();
+// Best resting prices, with an empty side reported as an uncrossable sentinel
+Price OrderBook::resting_best_bid() const {
+    return with_sides([](const auto& buys, const auto&) {
+        return buys.empty() ? std::numeric_limits<Price>::min() : buys.top().price;
+    });
+}
+
+Price OrderBook::resting_best_ask() const {
+    return with_sides([](const auto&, const auto& sells) {
+        return sells.empty() ? std::numeric_limits<Price>::max() : sells.top().price;
+    });
+}
+
+// Match an incoming order against the opposite side, resting any remainder
+// on its own side if it is a GTC limit order and discarding it otherwise. A
+// FOK order first checks, without touching the book, that enough quantity
+// crosses. Works on heaps and price-band sides alike.
+template <typename Resting, typename Own>
+static void match_against(Order& order, bool is_buy, const OrderEvent& ev, TimeNs exec_time,
+                          Resting& resting, Own& own, std::vector<Trade>& trades) {
+    if (ev.tif == TimeInForce::FOK) {
+        Price limit = order.price;
+        auto crosses = [is_buy, limit](Price p) { return is_buy ? p <= limit : p >= limit; };
+        if (resting.available(crosses, order.remaining_qty) < order.remaining_qty) {
+            PipelineStats::record_discard(order.remaining_qty, true);
+            return;
+        }
+    }
     
-    if (mode_ == MatchingMode::NAIVE_PRICE_TIME) {
+    while (order.remaining_qty > 0 && !resting.empty()) {
+        Order best = resting.top();
+        if (is_buy ? best.price > order.price : best.price < order.price) break; // No match possible
+        
+        resting.pop();
+        
+        Qty trade_qty = std::min(order.remaining_qty, best.remaining_qty);
+        Price trade_price = best.price; // Take maker's price
+        
         if (is_buy) {
-            // Match against sell orders
-            while (order.remaining_qty > 0 && !sell_orders_naive_.empty()) {
-                auto best_sell = sell_orders_naive_.top();
-                if (best_sell.price > order.price) break; // No match possible
-                
-                sell_orders_naive_.pop();
-                
-                Qty trade_qty = std::min(order.remaining_qty, best_sell.remaining_qty);
-                Price trade_price = best_sell.price; // Price-time priority: take maker's price
-                
-                trades.push_back({order.order_id, best_sell.order_id, trade_price, trade_qty, exec_time,
-                                 order.trader_id, best_sell.trader_id});
-                
-                order.remaining_qty -= trade_qty;
-                best_sell.remaining_qty -= trade_qty;
-                
-                if (best_sell.remaining_qty > 0) {
-                    sell_orders_naive_.push(best_sell);
-                }
-            }
-            
-            // Add remaining quantity to book
-            if (order.remaining_qty > 0) {
-                buy_orders_naive_.push(order);
-            }
+            trades.push_back({order.order_id, best.order_id, trade_price, trade_qty, exec_time,
+                             order.trader_id, best.trader_id});
         } else {
-            // Match against buy orders
-            while (order.remaining_qty > 0 && !buy_orders_naive_.empty()) {
-                auto best_buy = buy_orders_naive_.top();
-                if (best_buy.price < order.price) break; // No match possible
-                
-                buy_orders_naive_.pop();
-                
-                Qty trade_qty = std::min(order.remaining_qty, best_buy.remaining_qty);
-                Price trade_price = best_buy.price; // Price-time priority: take maker's price
-                
-                trades.push_back({best_buy.order_id, order.order_id, trade_price, trade_qty, exec_time,
-                                 best_buy.trader_id, order.trader_id});
-                
-                order.remaining_qty -= trade_qty;
-                best_buy.remaining_qty -= trade_qty;
-                
-                if (best_buy.remaining_qty > 0) {
-                    buy_orders_naive_.push(best_buy);
-                }
-            }
-            
-            // Add remaining quantity to book
-            if (order.remaining_qty > 0) {
-                sell_orders_naive_.push(order);
-            }
+            trades.push_back({best.order_id, order.order_id, trade_price, trade_qty, exec_time,
+                             best.trader_id, order.trader_id});
         }
-    } else {
-        // Fair mode
-        if (is_buy) {
-            while (order.remaining_qty > 0 && !sell_orders_fair_.empty()) {
-                auto best_sell = sell_orders_fair_.top();
-                if (best_sell.price > order.price) break;
-                
-                sell_orders_fair_.pop();
-                
-                Qty trade_qty = std::min(order.remaining_qty, best_sell.remaining_qty);
-                Price trade_price = best_sell.price;
-                
-                trades.push_back({order.order_id, best_sell.order_id, trade_price, trade_qty, exec_time,
-                                 order.trader_id, best_sell.trader_id});
-                
-                order.remaining_qty -= trade_qty;
-                best_sell.remaining_qty -= trade_qty;
-                
-                if (best_sell.remaining_qty > 0) {
-                    sell_orders_fair_.push(best_sell);
-                }
-            }
-            
-            if (order.remaining_qty > 0) {
-                buy_orders_fair_.push(order);
-            }
-        } else {
-            while (order.remaining_qty > 0 && !buy_orders_fair_.empty()) {
-                auto best_buy = buy_orders_fair_.top();
-                if (best_buy.price < order.price) break;
-                
-                buy_orders_fair_.pop();
-                
-                Qty trade_qty = std::min(order.remaining_qty, best_buy.remaining_qty);
-                Price trade_price = best_buy.price;
-                
-                trades.push_back({best_buy.order_id, order.order_id, trade_price, trade_qty, exec_time,
-                                 best_buy.trader_id, order.trader_id});
-                
-                order.remaining_qty -= trade_qty;
-                best_buy.remaining_qty -= trade_qty;
-                
-                if (best_buy.remaining_qty > 0) {
-                    buy_orders_fair_.push(best_buy);
-                }
-            }
-            
-            if (order.remaining_qty > 0) {
-                sell_orders_fair_.push(order);
-            }
+        
+        order.remaining_qty -= trade_qty;
+        best.remaining_qty -= trade_qty;
+        
+        if (best.remaining_qty > 0) {
+            resting.push(best);
         }
     }
     
-    return trades;
+    if (order.remaining_qty == 0) return;
+    if (rests_remainder(ev)) {
+        own.push(order);
+    } else {
+        PipelineStats::record_discard(order.remaining_qty, false);
+    }
 }
 
+std::vector<Trade> OrderBook::match_order(Order& order, const OrderEvent& ev, TimeNs exec_time) {
+    std::vector<Trade> trades;
+    with_sides([&](auto& buys, auto& sells) {
+        if (ev.side == Side::BUY) {
+            match_against(order, true, ev, exec_time, sells, buys, trades);
+        } else {
+            match_against(order, false, ev, exec_time, buys, sells, trades);
+        }
+    });
+    return trades;
+}
\ No newline at end of file
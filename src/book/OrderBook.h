@@ -2,73 +2,25 @@
 
 #include <map>
 #include <vector>
-#include <queue>
 #include "core/OrderEvent.h"
 #include "core/MatchingMode.h"
+#include "book/Order.h"
+#include "book/PriceBand.h"
+#include "book/ContentionTracker.h"
+#include "batching/BatchColumns.h"
 
-struct Order {
-    OrderID order_id;
-    Price price;
-    Qty qty;
-    Qty remaining_qty;
-    TimeNs recv_time;
-    BatchID batch_id;
-    int trader_id;
-    
-    Order(const OrderEvent& ev, int trader_id)
-        : order_id(ev.order_id), price(ev.price), qty(ev.qty),
-          remaining_qty(ev.qty), recv_time(ev.recv_time),
-          batch_id(ev.batch_id), trader_id(ev.trader_id != 0 ? ev.trader_id : trader_id) {}
-};
-
-struct Trade {
-    OrderID buy_order_id;
-    OrderID sell_order_id;
-    Price price;
-    Qty qty;
-    TimeNs execution_time;
-    int buy_trader_id;
-    int sell_trader_id;
-};
-
-// Price-time priority queue for BUY orders (best price first, then earliest time)
-struct BuyOrderComparator {
-    bool operator()(const Order& a, const Order& b) const {
-        if (a.price != b.price) return a.price < b.price; // Lower price = lower priority
-        return a.recv_time > b.recv_time; // Later time = lower priority
-    }
-};
-
-// Price-time priority queue for SELL orders (best price first, then earliest time)
-struct SellOrderComparator {
-    bool operator()(const Order& a, const Order& b) const {
-        if (a.price != b.price) return a.price > b.price; // Higher price = lower priority
-        return a.recv_time > b.recv_time; // Later time = lower priority
-    }
-};
-
-// Fair priority: price first, then order_id (ignores recv_time)
-struct FairBuyOrderComparator {
-    bool operator()(const Order& a, const Order& b) const {
-        if (a.price != b.price) return a.price < b.price;
-        return a.order_id > b.order_id; // Higher ID = lower priority
-    }
-};
-
-struct FairSellOrderComparator {
-    bool operator()(const Order& a, const Order& b) const {
-        if (a.price != b.price) return a.price > b.price;
-        return a.order_id > b.order_id; // Higher ID = lower priority
-    }
-};
+class WorkStealingPool;
 
 class OrderBook {
 public:
     explicit OrderBook(MatchingMode mode);
     
-    // Process a single order (naive mode) or batch (fair mode)
-    std::vector<Trade> process_order(const OrderEvent& ev, int trader_id);
-    std::vector<Trade> process_batch(const std::vector<OrderEvent>& batch, const std::vector<int>& trader_ids);
+    // Process a single order (naive mode) or batch (fair mode). With
+    // `contention`, the order is also checked against recent arrivals at its
+    // price level (see ContentionTracker). A batch is only borrowed for the
+    // call; every order's trader is its ev.trader_id.
+    std::vector<Trade> process_order(const OrderEvent& ev, int trader_id, ContentionOutcome* contention = nullptr);
+    std::vector<Trade> process_batch(OrderSpan batch);
     
     // Get current best bid/ask
     Price get_best_bid() const;
@@ -79,19 +31,100 @@ public:
     size_t get_sell_depth() const;
     
     void clear();
+    
+    // Stamp every trade in a batch with one execution time read at the start
+    // of the batch instead of reading the clock per matched order
+    void set_batch_timestamps(bool enabled) { batch_timestamps_ = enabled; }
+    bool get_batch_timestamps() const { return batch_timestamps_; }
+    
+    // Keep resting orders in direct-indexed levels over [low, high] (at most
+    // PriceBandSide::kMaxLevels ticks) instead of heaps; prices outside the
+    // band fall back to a heap. high < low switches back to heaps. Resting
+    // orders are carried over.
+    void set_price_band(Price low, Price high);
+    bool has_price_band() const { return band_; }
+    Price get_band_low() const { return band_low_; }
+    Price get_band_high() const { return band_high_; }
+    
+    // Sort batches of at least `threshold` marketable orders on pool
+    // (nullptr = always single-threaded)
+    void set_parallel_sort(WorkStealingPool* pool, size_t threshold) {
+        sort_pool_ = pool;
+        parallel_sort_threshold_ = threshold;
+    }
+    WorkStealingPool* get_sort_pool() const { return sort_pool_; }
+    size_t get_parallel_sort_threshold() const { return parallel_sort_threshold_; }
+    
+    // Pre-size resting storage for `orders` per side so it is mapped (and
+    // prefaulted, per HugePages policy) now rather than while matching.
+    // With a price band only the out-of-band heaps are reserved.
+    void reserve(size_t orders);
+    size_t get_reserved() const { return reserved_; }
+    
+    // Window within which same-level arrivals count as competing
+    void set_contention_horizon(TimeNs horizon) { contention_.set_horizon(horizon); }
+    TimeNs get_contention_horizon() const { return contention_.get_horizon(); }
+    // Close the competitions process_order left open, appending their winners
+    void settle_contention(std::vector<int>& winners) { contention_.settle(winners); }
 
 private:
     MatchingMode mode_;
+    bool batch_timestamps_;
+    bool band_;
+    Price band_low_;
+    Price band_high_;
+    WorkStealingPool* sort_pool_;
+    size_t parallel_sort_threshold_;
+    size_t reserved_;
+    ContentionTracker contention_;
     
     // Naive mode: use priority queues with recv_time
-    std::priority_queue<Order, std::vector<Order>, BuyOrderComparator> buy_orders_naive_;
-    std::priority_queue<Order, std::vector<Order>, SellOrderComparator> sell_orders_naive_;
+    OrderHeap<BuyOrderComparator> buy_orders_naive_;
+    OrderHeap<SellOrderComparator> sell_orders_naive_;
     
     // Fair mode: use priority queues with order_id
-    std::priority_queue<Order, std::vector<Order>, FairBuyOrderComparator> buy_orders_fair_;
-    std::priority_queue<Order, std::vector<Order>, FairSellOrderComparator> sell_orders_fair_;
+    OrderHeap<FairBuyOrderComparator> buy_orders_fair_;
+    OrderHeap<FairSellOrderComparator> sell_orders_fair_;
+    
+    // Price-band storage, same priorities
+    PriceBandSide<BuyOrderComparator, true> band_buy_naive_;
+    PriceBandSide<SellOrderComparator, false> band_sell_naive_;
+    PriceBandSide<FairBuyOrderComparator, true> band_buy_fair_;
+    PriceBandSide<FairSellOrderComparator, false> band_sell_fair_;
+    
+    // Per-batch scratch, kept to reuse capacity
+    BatchColumns columns_;
+    std::vector<uint8_t> mask_;
+    std::vector<uint32_t> marketable_;
+    std::vector<uint32_t> sort_scratch_;
+    std::vector<Order> passive_buys_;
+    std::vector<Order> passive_sells_;
+    
+    // Call fn(buys, sells) on the containers of the active mode and storage.
+    // SPEED_BUMP uses price-time priority by the time of release.
+    template <typename Fn>
+    decltype(auto) with_sides(Fn&& fn) {
+        if (mode_ != MatchingMode::LATENCY_FAIR_BATCHED) {
+            if (band_) return fn(band_buy_naive_, band_sell_naive_);
+            return fn(buy_orders_naive_, sell_orders_naive_);
+        }
+        if (band_) return fn(band_buy_fair_, band_sell_fair_);
+        return fn(buy_orders_fair_, sell_orders_fair_);
+    }
+    
+    template <typename Fn>
+    decltype(auto) with_sides(Fn&& fn) const {
+        if (mode_ != MatchingMode::LATENCY_FAIR_BATCHED) {
+            if (band_) return fn(band_buy_naive_, band_sell_naive_);
+            return fn(buy_orders_naive_, sell_orders_naive_);
+        }
+        if (band_) return fn(band_buy_fair_, band_sell_fair_);
+        return fn(buy_orders_fair_, sell_orders_fair_);
+    }
     
-    std::vector<Trade> match_order(Order& order, bool is_buy);
+    std::vector<Trade> match_order(Order& order, const OrderEvent& ev, TimeNs exec_time);
+    Price resting_best_bid() const;
+    Price resting_best_ask() const;
     static TimeNs get_current_time();
 };
 
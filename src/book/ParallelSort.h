@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "core/WorkStealingPool.h"
+
+// Sort [data, data + n) on a WorkStealingPool: the range is cut into one run
+// per thread and each run is sorted as a task; then the output is split at
+// splitters sampled from the sorted runs, and each output slice is filled by
+// an independent k-way merge of the matching pieces of every run. Below
+// `threshold` elements (or without a pool) this is plain std::sort.
+//
+// comp must be a strict weak ordering; equal elements end up in an
+// unspecified order, as with std::sort.
+template <typename T, typename Comp>
+void parallel_sort(T* data, size_t n, Comp comp, WorkStealingPool* pool, size_t threshold,
+                   std::vector<T>& scratch) {
+    size_t threads = pool ? pool->workers() + 1 : 1;
+    if (n < threshold || threads < 2 || n < threads * 2) {
+        std::sort(data, data + n, comp);
+        return;
+    }
+
+    // 1. Sort runs in place
+    size_t runs = threads;
+    std::vector<size_t> run_begin(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) run_begin[r] = n * r / runs;
+    pool->parallel_for(runs, [&](size_t r) {
+        std::sort(data + run_begin[r], data + run_begin[r + 1], comp);
+    });
+
+    // 2. Splitters: evenly spaced samples from every run, sorted, then
+    //    every runs-th one
+    size_t slices = runs;
+    std::vector<T> samples;
+    samples.reserve(runs * slices);
+    for (size_t r = 0; r < runs; ++r) {
+        size_t len = run_begin[r + 1] - run_begin[r];
+        for (size_t s = 1; s <= slices; ++s) {
+            samples.push_back(data[run_begin[r] + (len * s) / (slices + 1)]);
+        }
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+
+    // cut[s][r]: where slice s starts in run r (lower_bound of its splitter)
+    std::vector<std::vector<size_t>> cut(slices + 1, std::vector<size_t>(runs));
+    for (size_t r = 0; r < runs; ++r) {
+        cut[0][r] = run_begin[r];
+        cut[slices][r] = run_begin[r + 1];
+    }
+    for (size_t s = 1; s < slices; ++s) {
+        const T& splitter = samples[s * runs];
+        for (size_t r = 0; r < runs; ++r) {
+            cut[s][r] = static_cast<size_t>(
+                std::lower_bound(data + run_begin[r], data + run_begin[r + 1], splitter, comp) - data);
+        }
+    }
+    std::vector<size_t> out_begin(slices + 1, 0);
+    for (size_t s = 0; s < slices; ++s) {
+        size_t len = 0;
+        for (size_t r = 0; r < runs; ++r) len += cut[s + 1][r] - cut[s][r];
+        out_begin[s + 1] = out_begin[s] + len;
+    }
+
+    // 3. k-way merge each slice into scratch
+    scratch.resize(n);
+    pool->parallel_for(slices, [&](size_t s) {
+        std::vector<std::pair<size_t, size_t>> heads;   // (next, end) per run
+        for (size_t r = 0; r < runs; ++r) {
+            if (cut[s][r] < cut[s + 1][r]) heads.push_back({cut[s][r], cut[s + 1][r]});
+        }
+        // Min-heap on the current head of each run
+        auto later = [&](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+            return comp(data[b.first], data[a.first]);
+        };
+        std::make_heap(heads.begin(), heads.end(), later);
+        T* out = scratch.data() + out_begin[s];
+        while (!heads.empty()) {
+            std::pop_heap(heads.begin(), heads.end(), later);
+            auto& h = heads.back();
+            *out++ = data[h.first++];
+            if (h.first == h.second) {
+                heads.pop_back();
+            } else {
+                std::push_heap(heads.begin(), heads.end(), later);
+            }
+        }
+    });
+    // Only after every merge has read its inputs
+    pool->parallel_for(slices, [&](size_t s) {
+        std::copy(scratch.data() + out_begin[s], scratch.data() + out_begin[s + 1], data + out_begin[s]);
+    });
+}
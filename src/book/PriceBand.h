@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "book/Order.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Lowest / highest set bit of a non-zero word
+inline unsigned lowest_bit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(w));
+#endif
+}
+
+inline unsigned highest_bit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, w);
+    return static_cast<unsigned>(i);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(w));
+#endif
+}
+
+// One side of a book over a fixed band of price ticks.
+//
+// Level i holds the resting orders at price low + i in priority order, and a
+// three-level bitmap (64^3 = 262144 levels max) marks non-empty levels, so
+// the best level is found with three ctz/clz steps instead of a heap walk.
+// Orders priced outside the band go to an OrderHeap that top() consults as
+// well. Exposes the same interface as OrderHeap so the matching code can use
+// either.
+template <typename Comparator, bool IsBuy>
+class PriceBandSide {
+public:
+    static constexpr size_t kMaxLevels = 64 * 64 * 64;
+
+    // Drops any resting orders
+    void configure(Price low, size_t levels) {
+        low_ = low;
+        levels_.assign(std::min(levels, kMaxLevels), Level{});
+        l0_.assign((levels_.size() + 63) / 64, 0);
+        l1_.assign((l0_.size() + 63) / 64, 0);
+        l2_ = 0;
+        in_band_ = 0;
+        overflow_ = OrderHeap<Comparator>();
+    }
+
+    bool empty() const { return in_band_ == 0 && overflow_.empty(); }
+    size_t size() const { return in_band_ + overflow_.size(); }
+    size_t overflow_size() const { return overflow_.size(); }
+    // Levels grow per price; only the out-of-band heap can be pre-sized
+    void reserve(size_t n) { overflow_.reserve(n); }
+
+    const Order& top() const {
+        if (in_band_ == 0) return overflow_.top();
+        const Level& lv = levels_[best_level()];
+        const Order& band_top = lv.orders[lv.head];
+        if (overflow_.empty() || !comp_(band_top, overflow_.top())) return band_top;
+        return overflow_.top();
+    }
+
+    void pop() {
+        if (in_band_ == 0 || (!overflow_.empty() && comp_(band_top_ref(), overflow_.top()))) {
+            overflow_.pop();
+            return;
+        }
+        size_t idx = best_level();
+        Level& lv = levels_[idx];
+        ++lv.head;
+        --in_band_;
+        if (lv.head == lv.orders.size()) {
+            lv.orders.clear();
+            lv.head = 0;
+            clear_bit(idx);
+        } else if (lv.head * 2 > lv.orders.size()) {
+            // A level that never empties would otherwise keep every order it
+            // ever filled; moving the rest down costs no more than the pops
+            lv.orders.erase(lv.orders.begin(), lv.orders.begin() + static_cast<std::ptrdiff_t>(lv.head));
+            lv.head = 0;
+        }
+    }
+
+    void push(const Order& order) {
+        if (order.price < low_ || order.price >= low_ + static_cast<Price>(levels_.size())) {
+            overflow_.push(order);
+            return;
+        }
+        size_t idx = static_cast<size_t>(order.price - low_);
+        Level& lv = levels_[idx];
+        if (lv.head == lv.orders.size()) {
+            lv.orders.clear();
+            lv.head = 0;
+            set_bit(idx);
+        }
+        ++in_band_;
+
+        // Common cases first: lowest priority (new arrival) goes to the back,
+        // highest (a partially filled maker going back) into the freed head slot
+        if (lv.head == lv.orders.size() || !comp_(lv.orders.back(), order)) {
+            lv.orders.push_back(order);
+        } else if (lv.head > 0 && comp_(lv.orders[lv.head], order)) {
+            lv.orders[--lv.head] = order;
+        } else {
+            auto first = lv.orders.begin() + static_cast<std::ptrdiff_t>(lv.head);
+            auto pos = std::partition_point(first, lv.orders.end(),
+                                            [&](const Order& o) { return !comp_(o, order); });
+            lv.orders.insert(pos, order);
+        }
+    }
+
+    template <typename It>
+    void bulk_push(It first, It last) {
+        for (; first != last; ++first) push(*first);
+    }
+
+    // Same contract as OrderHeap::available: levels are visited best first
+    // through the bitmap, so empty ticks in between cost nothing
+    template <typename Crosses>
+    Qty available(Crosses crosses, Qty wanted) const {
+        Qty sum = 0;
+        size_t idx = in_band_ > 0 ? best_level() : kNoLevel;
+        for (; idx != kNoLevel && sum < wanted && crosses(low_ + static_cast<Price>(idx)); idx = next_level(idx)) {
+            const Level& lv = levels_[idx];
+            for (size_t k = lv.head; k < lv.orders.size() && sum < wanted; ++k) {
+                sum += lv.orders[k].remaining_qty;
+            }
+        }
+        if (sum < wanted) sum += overflow_.available(crosses, wanted - sum);
+        return sum;
+    }
+
+private:
+    struct Level {
+        std::vector<Order> orders;   // [head, end) resting, best first
+        size_t head = 0;
+    };
+
+    Price low_ = 0;
+    std::vector<Level, HugePageAllocator<Level>> levels_;   // up to 8MB at full width
+    std::vector<uint64_t> l0_;       // bit per level
+    std::vector<uint64_t> l1_;       // bit per non-zero l0 word
+    uint64_t l2_ = 0;                // bit per non-zero l1 word
+    size_t in_band_ = 0;
+    OrderHeap<Comparator> overflow_;
+    Comparator comp_;
+
+    const Order& band_top_ref() const {
+        const Level& lv = levels_[best_level()];
+        return lv.orders[lv.head];
+    }
+
+    // Highest non-empty level for bids, lowest for asks
+    size_t best_level() const {
+        if (IsBuy) {
+            size_t i2 = highest_bit(l2_);
+            size_t i1 = i2 * 64 + highest_bit(l1_[i2]);
+            return i1 * 64 + highest_bit(l0_[i1]);
+        }
+        size_t i2 = lowest_bit(l2_);
+        size_t i1 = i2 * 64 + lowest_bit(l1_[i2]);
+        return i1 * 64 + lowest_bit(l0_[i1]);
+    }
+
+    static constexpr size_t kNoLevel = ~size_t(0);
+
+    // Next non-empty level after idx in priority order (lower prices for
+    // bids, higher for asks), or kNoLevel
+    size_t next_level(size_t idx) const {
+        size_t w0 = idx / 64, w1 = w0 / 64;
+        if (IsBuy) {
+            uint64_t b0 = l0_[w0] & ((uint64_t(1) << (idx % 64)) - 1);
+            if (b0) return w0 * 64 + highest_bit(b0);
+            uint64_t b1 = l1_[w1] & ((uint64_t(1) << (w0 % 64)) - 1);
+            if (!b1) {
+                uint64_t b2 = l2_ & ((uint64_t(1) << w1) - 1);
+                if (!b2) return kNoLevel;
+                w1 = highest_bit(b2);
+                b1 = l1_[w1];
+            }
+            w0 = w1 * 64 + highest_bit(b1);
+            return w0 * 64 + highest_bit(l0_[w0]);
+        }
+        uint64_t b0 = l0_[w0] & ((~uint64_t(0) << (idx % 64)) << 1);
+        if (b0) return w0 * 64 + lowest_bit(b0);
+        uint64_t b1 = l1_[w1] & ((~uint64_t(0) << (w0 % 64)) << 1);
+        if (!b1) {
+            uint64_t b2 = l2_ & ((~uint64_t(0) << w1) << 1);
+            if (!b2) return kNoLevel;
+            w1 = lowest_bit(b2);
+            b1 = l1_[w1];
+        }
+        w0 = w1 * 64 + lowest_bit(b1);
+        return w0 * 64 + lowest_bit(l0_[w0]);
+    }
+
+    void set_bit(size_t idx) {
+        size_t w0 = idx / 64, w1 = w0 / 64;
+        l0_[w0] |= uint64_t(1) << (idx % 64);
+        l1_[w1] |= uint64_t(1) << (w0 % 64);
+        l2_ |= uint64_t(1) << w1;
+    }
+
+    void clear_bit(size_t idx) {
+        size_t w0 = idx / 64, w1 = w0 / 64;
+        l0_[w0] &= ~(uint64_t(1) << (idx % 64));
+        if (l0_[w0] != 0) return;
+        l1_[w1] &= ~(uint64_t(1) << (w0 % 64));
+        if (l1_[w1] != 0) return;
+        l2_ &= ~(uint64_t(1) << w1);
+    }
+};
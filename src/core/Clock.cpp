@@ -0,0 +1,44 @@
+#include "core/Clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static bool has_invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) return false;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#elif defined(_M_X64) || defined(_M_IX86)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned int>(regs[0]) < 0x80000007) return false;
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+TscClock::TscClock()
+    : use_tsc_(false), base_ticks_(0), base_ns_(0), ns_per_tick_(1.0) {
+#ifdef FAIRORDER_HAS_RDTSC
+    if (!has_invariant_tsc()) return;
+
+    // Calibrate against steady_clock over a short busy-wait (~10ms)
+    TimeNs ns0 = steady_ns();
+    uint64_t t0 = __rdtsc();
+    TimeNs ns1 = ns0;
+    while (ns1 - ns0 < 10'000'000) {
+        ns1 = steady_ns();
+    }
+    uint64_t t1 = __rdtsc();
+    if (t1 <= t0) return;
+
+    use_tsc_ = true;
+    base_ticks_ = t0;
+    base_ns_ = ns0;
+    ns_per_tick_ = static_cast<double>(ns1 - ns0) / static_cast<double>(t1 - t0);
+#endif
+}
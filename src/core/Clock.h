@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include "Types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FAIRORDER_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define FAIRORDER_HAS_RDTSC 1
+#endif
+
+// Cheap timestamp source for the hot path.
+//
+// ticks() reads the TSC when the CPU advertises an invariant TSC (constant
+// rate, not stopped in idle states), otherwise it falls back to
+// steady_clock nanoseconds. Raw ticks are converted to nanoseconds only when
+// needed, using a one-off calibration against steady_clock, so converted
+// values share steady_clock's epoch and can be compared with other
+// steady_clock-based TimeNs values.
+class TscClock {
+public:
+    static uint64_t ticks() {
+#ifdef FAIRORDER_HAS_RDTSC
+        if (instance().use_tsc_) return __rdtsc();
+#endif
+        return steady_ns();
+    }
+
+    static TimeNs to_ns(uint64_t ticks) {
+        const TscClock& c = instance();
+        if (!c.use_tsc_) return ticks;
+        int64_t delta = static_cast<int64_t>(ticks - c.base_ticks_);
+        int64_t delta_ns = static_cast<int64_t>(static_cast<double>(delta) * c.ns_per_tick_);
+        return static_cast<TimeNs>(static_cast<int64_t>(c.base_ns_) + delta_ns);
+    }
+
+    static TimeNs now_ns() { return to_ns(ticks()); }
+
+    static bool using_tsc() { return instance().use_tsc_; }
+    static double ns_per_tick() { return instance().ns_per_tick_; }
+
+    static TimeNs steady_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+private:
+    TscClock();
+    static const TscClock& instance() {
+        static const TscClock clock;
+        return clock;
+    }
+
+    bool use_tsc_;
+    uint64_t base_ticks_;
+    TimeNs base_ns_;
+    double ns_per_tick_;
+};
@@ -0,0 +1,164 @@
+#include "core/HugePages.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::mutex& policy_mutex() {
+    static std::mutex m;
+    return m;
+}
+
+MemoryPolicy& current_policy() {
+    static MemoryPolicy p;
+    return p;
+}
+
+struct Counters {
+    std::atomic<uint64_t> regions{0};
+    std::atomic<uint64_t> hugetlb_bytes{0};
+    std::atomic<uint64_t> thp_bytes{0};
+    std::atomic<uint64_t> plain_bytes{0};
+    std::atomic<uint64_t> numa_bound_bytes{0};
+    std::atomic<uint64_t> prefaulted_bytes{0};
+};
+
+Counters& counters() {
+    static Counters c;
+    return c;
+}
+
+size_t round_up(size_t bytes) {
+    return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+#ifdef __linux__
+// mbind(2) without libnuma
+constexpr int kMpolPreferred = 1;
+
+bool bind_node(void* p, size_t bytes, int node) {
+    if (node < 0 || node >= 64) return false;
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, p, bytes, kMpolPreferred, &mask, sizeof(mask) * 8 + 1, 0) == 0;
+}
+
+void prefault(void* p, size_t bytes) {
+    // One write per 4KB page (huge pages fault in whole on the first)
+    volatile char* c = static_cast<volatile char*>(p);
+    for (size_t off = 0; off < bytes; off += 4096) {
+        c[off] = c[off];
+    }
+}
+
+int resolve_node(const MemoryPolicy& policy) {
+    return policy.numa_node == -2 ? HugePages::current_node() : policy.numa_node;
+}
+#endif
+
+} // namespace
+
+void HugePages::set_policy(const MemoryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(policy_mutex());
+    current_policy() = policy;
+}
+
+MemoryPolicy HugePages::policy() {
+    std::lock_guard<std::mutex> lock(policy_mutex());
+    return current_policy();
+}
+
+MemoryStats HugePages::stats() {
+    const Counters& c = counters();
+    MemoryStats s;
+    s.regions = c.regions.load();
+    s.hugetlb_bytes = c.hugetlb_bytes.load();
+    s.thp_bytes = c.thp_bytes.load();
+    s.plain_bytes = c.plain_bytes.load();
+    s.numa_bound_bytes = c.numa_bound_bytes.load();
+    s.prefaulted_bytes = c.prefaulted_bytes.load();
+    return s;
+}
+
+int HugePages::current_node() {
+#ifdef __linux__
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+    return 0;
+}
+
+void* HugePages::map(size_t bytes) {
+    size_t len = round_up(bytes);
+#ifdef __linux__
+    MemoryPolicy policy = HugePages::policy();
+    Counters& c = counters();
+
+    void* p = MAP_FAILED;
+    bool hugetlb = false;
+    if (policy.huge_pages) {
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugetlb = p != MAP_FAILED;
+    }
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+    }
+
+    if (hugetlb) {
+        c.hugetlb_bytes += len;
+    } else if (policy.huge_pages && madvise(p, len, MADV_HUGEPAGE) == 0) {
+        c.thp_bytes += len;
+    } else {
+        c.plain_bytes += len;
+    }
+    if (bind_node(p, len, resolve_node(policy))) c.numa_bound_bytes += len;
+    if (policy.prefault) {
+        prefault(p, len);
+        c.prefaulted_bytes += len;
+    }
+    c.regions++;
+    return p;
+#else
+    void* p = std::malloc(len);
+    if (!p) throw std::bad_alloc();
+    return p;
+#endif
+}
+
+void HugePages::unmap(void* p, size_t bytes) {
+    if (!p) return;
+#ifdef __linux__
+    munmap(p, round_up(bytes));
+#else
+    (void)bytes;
+    std::free(p);
+#endif
+}
+
+std::string HugePages::advise(void* p, size_t bytes) {
+    std::string applied;
+#ifdef __linux__
+    MemoryPolicy policy = HugePages::policy();
+    if (policy.huge_pages && madvise(p, bytes, MADV_HUGEPAGE) == 0) applied += "thp ";
+    int node = resolve_node(policy);
+    if (bind_node(p, bytes, node)) applied += "node" + std::to_string(node) + " ";
+    if (policy.prefault) {
+        prefault(p, bytes);
+        applied += "prefault ";
+    }
+#else
+    (void)p;
+    (void)bytes;
+#endif
+    if (!applied.empty()) applied.pop_back();
+    return applied;
+}
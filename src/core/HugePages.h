@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+// Placement policy for large allocations (book storage, rings).
+//
+// Regions of kHugeAllocMin bytes or more are mapped directly in 2MB units:
+// first with MAP_HUGETLB (reserved huge pages), else as ordinary anonymous
+// memory with MADV_HUGEPAGE so transparent huge pages can back it. With a
+// NUMA node set, the region is bound there (MPOL_PREFERRED) before it is
+// touched, and with prefault every page is written once up front so the
+// first order to land on it does not take the page fault. Smaller
+// allocations and non-Linux builds use the normal heap.
+struct MemoryPolicy {
+    bool huge_pages = false;
+    int  numa_node  = -1;    // -1 = first touch, -2 = node of the calling thread
+    bool prefault   = true;
+};
+
+struct MemoryStats {
+    uint64_t regions = 0;
+    uint64_t hugetlb_bytes = 0;    // MAP_HUGETLB mappings
+    uint64_t thp_bytes = 0;        // madvise(MADV_HUGEPAGE) mappings
+    uint64_t plain_bytes = 0;      // large mappings without huge pages
+    uint64_t numa_bound_bytes = 0;
+    uint64_t prefaulted_bytes = 0;
+};
+
+constexpr size_t kHugePageSize = size_t(2) << 20;
+constexpr size_t kHugeAllocMin = size_t(1) << 20;
+
+class HugePages {
+public:
+    static void set_policy(const MemoryPolicy& policy);
+    static MemoryPolicy policy();
+    static MemoryStats stats();
+
+    // Map at least `bytes` (rounded up to kHugePageSize) under the current
+    // policy. Never returns nullptr; throws std::bad_alloc.
+    static void* map(size_t bytes);
+    static void unmap(void* p, size_t bytes);
+
+    // Apply THP advice, NUMA binding and prefault to an existing mapping
+    // (e.g. a shared-memory segment). Returns what was applied.
+    static std::string advise(void* p, size_t bytes);
+
+    // NUMA node the calling thread is running on (0 if unknown)
+    static int current_node();
+};
+
+// STL allocator: large blocks through HugePages::map, small ones through
+// the ordinary heap. The choice depends only on the size, so deallocate
+// always matches allocate whatever the policy is by then.
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= kHugeAllocMin) return static_cast<T*>(HugePages::map(bytes));
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= kHugeAllocMin) {
+            HugePages::unmap(p, bytes);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
@@ -0,0 +1,114 @@
+#include "core/JobExecutor.h"
+#include "core/Clock.h"
+
+#include <algorithm>
+
+JobExecutor::JobExecutor(size_t workers) : stopping_(false), next_id_(1) {
+    for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+        threads_.emplace_back(&JobExecutor::worker_loop, this);
+    }
+}
+
+JobExecutor::~JobExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& job : jobs_) job->progress.cancel.store(true);
+    }
+    work_ready_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void JobExecutor::worker_loop() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (stopping_) return;
+            job = queue_.front();
+            queue_.pop_front();
+            job->started_ns.store(TscClock::now_ns());
+            job->state.store(JobState::RUNNING);
+        }
+
+        job->work(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job->finished_ns.store(TscClock::now_ns());
+            job->state.store(job->progress.cancel.load() ? JobState::CANCELLED : JobState::DONE);
+            job->work = nullptr;   // release whatever the job captured
+        }
+        job_finished_.notify_all();
+    }
+}
+
+std::shared_ptr<Job> JobExecutor::submit(const std::string& label, std::function<void(Job&)> work) {
+    auto job = std::make_shared<Job>();
+    job->label = label;
+    job->work = std::move(work);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->id = next_id_++;
+        jobs_.push_back(job);
+        queue_.push_back(job);
+    }
+    work_ready_.notify_one();
+    return job;
+}
+
+std::vector<std::shared_ptr<Job>> JobExecutor::list() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_;
+}
+
+std::shared_ptr<Job> JobExecutor::find(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& job : jobs_) {
+        if (job->id == id) return job;
+    }
+    return nullptr;
+}
+
+bool JobExecutor::cancel(int id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(jobs_.begin(), jobs_.end(), [id](const auto& j) { return j->id == id; });
+        if (it == jobs_.end()) return false;
+        Job& job = **it;
+        JobState state = job.state.load();
+        if (state == JobState::DONE || state == JobState::CANCELLED) return false;
+        job.progress.cancel.store(true);
+        if (state == JobState::QUEUED) {
+            queue_.erase(std::remove(queue_.begin(), queue_.end(), *it), queue_.end());
+            job.state.store(JobState::CANCELLED);
+            job.finished_ns.store(TscClock::now_ns());
+            job.work = nullptr;
+        }
+    }
+    job_finished_.notify_all();
+    return true;
+}
+
+void JobExecutor::wait(int id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_finished_.wait(lock, [&] {
+        for (const auto& job : jobs_) {
+            if (id != -1 && job->id != id) continue;
+            JobState state = job->state.load();
+            if (state == JobState::QUEUED || state == JobState::RUNNING) return false;
+        }
+        return true;
+    });
+}
+
+const char* JobExecutor::state_name(JobState state) {
+    switch (state) {
+        case JobState::QUEUED:    return "queued";
+        case JobState::RUNNING:   return "running";
+        case JobState::DONE:      return "done";
+        case JobState::CANCELLED: return "cancelled";
+    }
+    return "?";
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/Types.h"
+
+// Counters a running job publishes; any thread may read them
+struct JobProgress {
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> batches{0};
+    std::atomic<bool> cancel{false};     // set by cancel(); the job polls it
+};
+
+enum class JobState { QUEUED, RUNNING, DONE, CANCELLED };
+
+struct Job {
+    int id = 0;
+    std::string label;
+    JobProgress progress;
+    std::atomic<JobState> state{JobState::QUEUED};
+    std::atomic<TimeNs> started_ns{0};
+    std::atomic<TimeNs> finished_ns{0};
+    std::function<void(Job&)> work;
+};
+
+// Fixed pool of threads running submitted jobs first-come first-served, one
+// job per thread. Cancellation is cooperative: a queued job is dropped, a
+// running one sees progress.cancel and is expected to return early.
+class JobExecutor {
+public:
+    explicit JobExecutor(size_t workers);
+    ~JobExecutor();   // cancels whatever has not finished and joins
+
+    JobExecutor(const JobExecutor&) = delete;
+    JobExecutor& operator=(const JobExecutor&) = delete;
+
+    size_t workers() const { return threads_.size(); }
+
+    std::shared_ptr<Job> submit(const std::string& label, std::function<void(Job&)> work);
+    std::vector<std::shared_ptr<Job>> list() const;
+    std::shared_ptr<Job> find(int id) const;
+
+    // false if the id is unknown or the job has already finished
+    bool cancel(int id);
+    // Block until job id (-1 = every job) is finished or cancelled
+    void wait(int id);
+
+    static const char* state_name(JobState state);
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable job_finished_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    std::vector<std::shared_ptr<Job>> jobs_;
+    std::vector<std::thread> threads_;
+    bool stopping_;
+    int next_id_;
+
+    void worker_loop();
+};
@@ -2,6 +2,7 @@
 
 enum class MatchingMode {
     NAIVE_PRICE_TIME,      // Traditional: process immediately, recv_time breaks ties
-    LATENCY_FAIR_BATCHED   // Fair: batch orders, ignore recv_time within batch
+    LATENCY_FAIR_BATCHED,  // Fair: batch orders, ignore recv_time within batch
+    SPEED_BUMP             // Fair: delay orders to equalize trader latency, then match continuously
 };
 
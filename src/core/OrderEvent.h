@@ -1,5 +1,8 @@
 #pragma once
+#include <cstddef>
+#include <limits>
 #include <string>
+#include <vector>
 #include "Types.h"
 using namespace std;
 
@@ -13,6 +16,17 @@ enum class EventType : uint8_t {
     CANCEL
 };
 
+enum class TimeInForce : uint8_t {
+    GTC,    // rest whatever does not fill
+    IOC,    // fill what is available now, discard the rest
+    FOK     // fill completely now or not at all
+};
+
+enum class OrderType : uint8_t {
+    LIMIT,
+    MARKET  // no price limit; never rests, so GTC behaves as IOC
+};
+
 struct OrderEvent {
     EventType type;
     OrderID   order_id;
@@ -20,8 +34,46 @@ struct OrderEvent {
     Side      side;
     Price     price;
     Qty       qty;
+    TimeInForce tif = TimeInForce::GTC;
+    OrderType order_type = OrderType::LIMIT;
 
     TimeNs    recv_time;   // when engine received it
+    TimeNs    release_time = 0;   // when a speed bump let it through, 0 = not held
     BatchID   batch_id;    // assigned by MicroBatcher
     int       trader_id;   // trader who submitted this order
 };
+
+// Price the order matches up to: market orders cross any resting price
+inline Price effective_price(const OrderEvent& ev) {
+    if (ev.order_type != OrderType::MARKET) return ev.price;
+    return ev.side == Side::BUY ? numeric_limits<Price>::max() : numeric_limits<Price>::min();
+}
+
+// When the order reached the book, its time priority
+inline TimeNs priority_time(const OrderEvent& ev) {
+    return ev.release_time != 0 ? ev.release_time : ev.recv_time;
+}
+
+// Borrowed read-only view of contiguous order events, e.g. a batch still
+// owned by whoever popped it from the batcher (std::span is C++20)
+class OrderSpan {
+public:
+    OrderSpan() : data_(nullptr), size_(0) {}
+    OrderSpan(const OrderEvent* data, size_t size) : data_(data), size_(size) {}
+    OrderSpan(const vector<OrderEvent>& events) : data_(events.data()), size_(events.size()) {}
+
+    const OrderEvent* begin() const { return data_; }
+    const OrderEvent* end() const { return data_ + size_; }
+    const OrderEvent& operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const OrderEvent* data_;
+    size_t size_;
+};
+
+// Whether an unfilled remainder is added to the book
+inline bool rests_remainder(const OrderEvent& ev) {
+    return ev.tif == TimeInForce::GTC && ev.order_type == OrderType::LIMIT;
+}
@@ -0,0 +1,82 @@
+#include "core/WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(size_t workers) : queued_(0), stopping_(false) {
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_.store(true);
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+// Pop from the home deque's back, else steal from the front of the others
+bool WorkStealingPool::try_run(size_t home) {
+    std::function<void()> task;
+    size_t n = workers_.size();
+    for (size_t k = 0; k < n && !task; ++k) {
+        Worker& w = *workers_[(home + k) % n];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) continue;
+        if (k == 0) {
+            task = std::move(w.tasks.back());
+            w.tasks.pop_back();
+        } else {
+            task = std::move(w.tasks.front());
+            w.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+    while (true) {
+        if (try_run(index)) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [&] {
+            return stopping_.load() || queued_.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping_.load()) return;
+    }
+}
+
+void WorkStealingPool::parallel_for(size_t n, const std::function<void(size_t)>& fn) {
+    if (n == 0) return;
+    if (workers_.empty()) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    // Counted before any task is visible: a worker that takes one at once
+    // must not decrement queued_ below zero (it is unsigned)
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        queued_.fetch_add(n, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> remaining(n);
+    for (size_t i = 0; i < n; ++i) {
+        Worker& w = *workers_[i % workers_.size()];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.tasks.push_back([&fn, &remaining, i] {
+            fn(i);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    wake_.notify_all();
+
+    // Help until our tasks are done; the last ones may be running elsewhere
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!try_run(0)) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker runs
+// its own tasks newest-first and, when it runs dry, steals the oldest task
+// from another worker. The thread that calls parallel_for() works through
+// the same deques until its tasks are done, so a pool of N workers gives
+// N + 1 threads on the job.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t workers);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t workers() const { return workers_.size(); }
+
+    // Run fn(i) for every i in [0, n) and return when all have finished.
+    // Not reentrant: fn must not call parallel_for on the same pool.
+    void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_;
+    std::atomic<bool> stopping_;
+
+    bool try_run(size_t home);
+    void worker_loop(size_t index);
+};
@@ -0,0 +1,125 @@
+#include "engine/ExecutionFanout.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Spin, then yield, then nap: a busy run is picked up within nanoseconds,
+// an idle consumer costs next to no CPU
+void back_off(unsigned& idle) {
+    if (idle < 64) {
+        ++idle;
+    } else if (idle < 128) {
+        ++idle;
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+} // namespace
+
+ExecutionFanout::ExecutionFanout(size_t capacity)
+    : cursor_(0), claimed_(0), cached_min_(0), writer_waits_(0), running_(false) {
+    size_t size = 1;
+    while (size < std::max<size_t>(capacity, 2)) size <<= 1;
+    ring_.resize(size);
+    mask_ = size - 1;
+}
+
+ExecutionFanout::~ExecutionFanout() {
+    stop();
+}
+
+void ExecutionFanout::add_consumer(const std::string& name, Handler handler) {
+    auto c = std::make_unique<Consumer>();
+    c->name = name;
+    c->handler = std::move(handler);
+    c->sequence.store(claimed_, std::memory_order_relaxed);
+    consumers_.push_back(std::move(c));
+}
+
+void ExecutionFanout::start() {
+    if (running_.exchange(true)) return;
+    for (auto& c : consumers_) {
+        Consumer* consumer = c.get();
+        consumer->thread = std::thread([this, consumer] { consume(*consumer); });
+    }
+}
+
+void ExecutionFanout::stop() {
+    if (!running_.load(std::memory_order_relaxed)) return;
+    publish();
+    running_.store(false, std::memory_order_release);
+    for (auto& c : consumers_) {
+        if (c->thread.joinable()) c->thread.join();
+    }
+}
+
+uint64_t ExecutionFanout::min_sequence() const {
+    uint64_t min = claimed_;
+    for (const auto& c : consumers_) {
+        min = std::min(min, c->sequence.load(std::memory_order_acquire));
+    }
+    return min;
+}
+
+ExecutionEvent& ExecutionFanout::claim() {
+    if (claimed_ - cached_min_ >= ring_.size()) {
+        // The slowest consumer may be waiting on slots claimed but not yet published
+        publish();
+        cached_min_ = min_sequence();
+        unsigned idle = 0;
+        while (claimed_ - cached_min_ >= ring_.size()) {
+            ++writer_waits_;
+            back_off(idle);
+            cached_min_ = min_sequence();
+        }
+    }
+    return ring_[claimed_++ & mask_];
+}
+
+void ExecutionFanout::flush() {
+    publish();
+    unsigned idle = 0;
+    while (min_sequence() < claimed_) back_off(idle);
+    cached_min_ = claimed_;
+}
+
+void ExecutionFanout::consume(Consumer& c) {
+    uint64_t next = c.sequence.load(std::memory_order_relaxed);
+    unsigned idle = 0;
+    for (;;) {
+        uint64_t available = cursor_.load(std::memory_order_acquire);
+        if (available == next) {
+            // Drain whatever was published before stop() before leaving
+            if (!running_.load(std::memory_order_acquire) &&
+                cursor_.load(std::memory_order_acquire) == next) {
+                break;
+            }
+            back_off(idle);
+            continue;
+        }
+        idle = 0;
+
+        // At most two runs: up to the end of the ring, then from its start
+        while (next < available) {
+            size_t index = static_cast<size_t>(next & mask_);
+            size_t n = static_cast<size_t>(std::min<uint64_t>(available - next, ring_.size() - index));
+            c.handler(&ring_[index], n);
+            next += n;
+            c.runs.fetch_add(1, std::memory_order_relaxed);
+        }
+        c.sequence.store(next, std::memory_order_release);
+    }
+}
+
+std::vector<ExecutionFanout::ConsumerStats> ExecutionFanout::stats() const {
+    uint64_t published = cursor_.load(std::memory_order_acquire);
+    std::vector<ConsumerStats> out;
+    for (const auto& c : consumers_) {
+        uint64_t done = c->sequence.load(std::memory_order_acquire);
+        out.push_back({c->name, done, c->runs.load(std::memory_order_relaxed), published - std::min(done, published)});
+    }
+    return out;
+}
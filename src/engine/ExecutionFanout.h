@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/OrderEvent.h"
+#include "book/Order.h"
+
+enum class ExecKind : uint8_t {
+    ORDER,   // an order the engine processed
+    FILL,    // a trade
+    WIN,     // a competition won, by trader
+    LOSS,    // a competition lost, by trader
+    BOOK,    // top of book after a batch
+    BATCH    // end of a batch: everything before it belongs to it
+};
+
+// The archived fields of an order (OrderEvent without its instrument string)
+struct OrderRecord {
+    OrderID order_id;
+    Price   price;
+    Qty     qty;
+    TimeNs  recv_time;
+    BatchID batch_id;
+    int     trader_id;
+    Side    side;
+    TimeInForce tif;
+    OrderType   order_type;
+};
+
+struct BookTop {
+    Price  best_bid;     // 0 = no bids
+    Price  best_ask;     // 0 = no asks
+    size_t buy_depth;
+    size_t sell_depth;
+};
+
+struct BatchMark {
+    TimeNs start;        // matching started
+    TimeNs end;          // last event of the batch published
+    size_t orders;
+    size_t trades;
+};
+
+// One slot of the output ring, a single cache line
+struct ExecutionEvent {
+    ExecKind kind;
+    union {
+        OrderRecord order;
+        Trade       fill;
+        int         trader_id;
+        BookTop     book;
+        BatchMark   batch;
+    };
+};
+
+// Single-writer, multi-reader ring of execution events in the style of the
+// LMAX disruptor. The matcher claims slots and publishes them with one
+// release store per batch; each consumer runs on its own thread, follows
+// the published cursor at its own pace and hands its handler every
+// contiguous run it finds, so a consumer that falls behind catches up in
+// a few large calls. The writer only waits when the ring is full, i.e.
+// when the slowest consumer is a whole ring behind.
+//
+// Consumers are added before start(). claim(), publish(), flush() and
+// stop() belong to the writer, which may change threads only across a
+// synchronizing handoff (a join, a mutex).
+class ExecutionFanout {
+public:
+    using Handler = std::function<void(const ExecutionEvent* events, size_t count)>;
+
+    struct ConsumerStats {
+        std::string name;
+        uint64_t processed;
+        uint64_t runs;       // handler calls
+        uint64_t lag;        // published events not yet processed
+    };
+
+    explicit ExecutionFanout(size_t capacity = 1 << 16);   // rounded up to a power of two
+    ~ExecutionFanout();
+
+    ExecutionFanout(const ExecutionFanout&) = delete;
+    ExecutionFanout& operator=(const ExecutionFanout&) = delete;
+
+    void add_consumer(const std::string& name, Handler handler);
+    void start();
+    // Publishes what is claimed, lets every consumer drain it and joins them
+    void stop();
+
+    // Next slot to fill. Publishes the pending slots and waits when the ring is full.
+    ExecutionEvent& claim();
+    // Makes every claimed slot visible to the consumers
+    void publish() { cursor_.store(claimed_, std::memory_order_release); }
+    // publish(), then wait until every consumer has processed everything;
+    // afterwards the consumers' writes are visible to the caller
+    void flush();
+
+    size_t capacity() const { return ring_.size(); }
+    uint64_t published() const { return cursor_.load(std::memory_order_acquire); }
+    uint64_t writer_waits() const { return writer_waits_; }
+    std::vector<ConsumerStats> stats() const;
+
+private:
+    struct Consumer {
+        alignas(64) std::atomic<uint64_t> sequence{0};   // next event to process
+        std::atomic<uint64_t> runs{0};
+        std::string name;
+        Handler handler;
+        std::thread thread;
+    };
+
+    std::vector<ExecutionEvent> ring_;
+    uint64_t mask_;
+    alignas(64) std::atomic<uint64_t> cursor_;   // events published
+    alignas(64) uint64_t claimed_;               // writer only
+    uint64_t cached_min_;                        // writer's view of the slowest consumer
+    uint64_t writer_waits_;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+    std::atomic<bool> running_;
+
+    uint64_t min_sequence() const;
+    void consume(Consumer& c);
+};
@@ -0,0 +1,50 @@
+#include "engine/MarketData.h"
+#include <sstream>
+
+std::string MarketDataSnapshot::format() const {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(2);
+    oss << "Bid " << (best_bid ? std::to_string(best_bid) : "-") << " / Ask "
+        << (best_ask ? std::to_string(best_ask) : "-") << "  (depth " << buy_depth << " / " << sell_depth << ")\n"
+        << "Last " << last_price << " x " << last_qty << ", " << trades << " trades, volume " << volume
+        << ", VWAP " << vwap() << ", " << batches << " batches\n";
+    return oss.str();
+}
+
+void MarketDataBuilder::on_events(const ExecutionEvent* events, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        const ExecutionEvent& ev = events[i];
+        switch (ev.kind) {
+            case ExecKind::FILL:
+                state_.last_price = ev.fill.price;
+                state_.last_qty = ev.fill.qty;
+                state_.trades++;
+                state_.volume += ev.fill.qty;
+                state_.notional += static_cast<double>(ev.fill.price) * static_cast<double>(ev.fill.qty);
+                break;
+            case ExecKind::BOOK:
+                state_.best_bid = ev.book.best_bid;
+                state_.best_ask = ev.book.best_ask;
+                state_.buy_depth = ev.book.buy_depth;
+                state_.sell_depth = ev.book.sell_depth;
+                break;
+            case ExecKind::BATCH:
+                state_.batches++;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+MarketDataSnapshot MarketDataBuilder::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+void MarketDataBuilder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = MarketDataSnapshot();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include "engine/ExecutionFanout.h"
+
+struct MarketDataSnapshot {
+    Price    best_bid = 0;
+    Price    best_ask = 0;
+    size_t   buy_depth = 0;
+    size_t   sell_depth = 0;
+    Price    last_price = 0;
+    Qty      last_qty = 0;
+    uint64_t trades = 0;
+    Qty      volume = 0;
+    double   notional = 0.0;   // sum of price * qty
+    uint64_t batches = 0;
+
+    double vwap() const { return volume > 0 ? notional / static_cast<double>(volume) : 0.0; }
+    std::string format() const;
+};
+
+// Market-data view built from the execution ring: top of book, last trade,
+// volume and VWAP. on_events() runs on its consumer thread and takes the
+// mutex once per run of events; snapshot() may be called from any thread.
+class MarketDataBuilder {
+public:
+    void on_events(const ExecutionEvent* events, size_t count);
+    MarketDataSnapshot snapshot() const;
+    void clear();
+
+private:
+    MarketDataSnapshot state_;
+    mutable std::mutex mutex_;
+};
@@ -1,31 +1,70 @@
 #include "engine/MatchingEngine.h"
+#include "metrics/PipelineStats.h"
+#include "archive/ColumnArchive.h"
+#include "core/Clock.h"
 #include <iostream>
 #include <map>
 
 MatchingEngine::MatchingEngine(MatchingMode mode)
-    : mode_(mode), order_book_(mode) {}
+    : mode_(mode), order_book_(mode), archive_(nullptr), output_(nullptr), record_outcomes_(false) {}
+
+void MatchingEngine::set_archive(ArchiveWriter* archive) {
+    archive_ = archive;
+    metrics_.set_keep_history(archive_ == nullptr);
+}
 
 void MatchingEngine::set_mode(MatchingMode mode) {
     mode_ = mode;
+    bool batch_timestamps = order_book_.get_batch_timestamps();
+    bool band = order_book_.has_price_band();
+    Price band_low = order_book_.get_band_low();
+    Price band_high = order_book_.get_band_high();
+    WorkStealingPool* sort_pool = order_book_.get_sort_pool();
+    size_t sort_threshold = order_book_.get_parallel_sort_threshold();
+    size_t reserved = order_book_.get_reserved();
+    TimeNs horizon = order_book_.get_contention_horizon();
     order_book_ = OrderBook(mode);
+    order_book_.set_contention_horizon(horizon);
+    order_book_.set_batch_timestamps(batch_timestamps);
+    order_book_.set_parallel_sort(sort_pool, sort_threshold);
+    if (band) {
+        order_book_.set_price_band(band_low, band_high);
+    }
+    if (reserved > 0) {
+        order_book_.reserve(reserved);
+    }
     metrics_.reset();
+    rolling_.clear();
+    outcomes_.clear();
 }
 
-void MatchingEngine::process_batch(const std::vector<OrderEvent>& batch, const std::vector<int>& trader_ids) {
-    if (batch.empty()) return;
+std::vector<Trade> MatchingEngine::process_batch(OrderSpan batch) {
+    if (batch.empty()) return {};
+    TimeNs start = TscClock::now_ns();
 
     // Group orders by price and side to find competitions
     std::map<std::pair<Price, Side>, std::vector<std::pair<size_t, int>>> competitions;
     for (size_t i = 0; i < batch.size(); ++i) {
-        competitions[{batch[i].price, batch[i].side}].push_back({i, trader_ids[i]});
+        competitions[{effective_price(batch[i]), batch[i].side}].push_back({i, batch[i].trader_id});
     }
 
-    auto trades = order_book_.process_batch(batch, trader_ids);
-    
-    // Record all trades
-    for (const auto& trade : trades) {
-        metrics_.record_trade(trade, false);
+    std::vector<Trade> trades;
+    if (mode_ == MatchingMode::SPEED_BUMP) {
+        // Orders come out of the speed bump in release order and are matched
+        // one at a time, as they would be continuously
+        for (size_t i = 0; i < batch.size(); ++i) {
+            auto fills = order_book_.process_order(batch[i], batch[i].trader_id);
+            trades.insert(trades.end(), fills.begin(), fills.end());
+        }
+    } else {
+        trades = order_book_.process_batch(batch);
     }
+    PipelineStats::record_book_depth(order_book_.get_buy_depth(), order_book_.get_sell_depth());
+    
+    StageTimer timer(Stage::METRICS, batch.size());
+    
+    winners_.clear();
+    losers_.clear();
     
     // For each price/side combination with multiple traders, determine winner
     for (const auto& [price_side, competitors] : competitions) {
@@ -47,8 +86,9 @@ void MatchingEngine::process_batch(const std::vector<OrderEvent>& batch, const s
                     // Fair mode: lower order_id wins
                     is_better = (ev.order_id < winner_ev.order_id);
                 } else {
-                    // Naive mode: earlier recv_time wins
-                    is_better = (ev.recv_time < winner_ev.recv_time);
+                    // Naive mode: earlier recv_time wins (the release time
+                    // under a speed bump)
+                    is_better = (priority_time(ev) < priority_time(winner_ev));
                 }
             }
             
@@ -58,30 +98,186 @@ void MatchingEngine::process_batch(const std::vector<OrderEvent>& batch, const s
             }
         }
         
-        // Record win for winner, losses for others
+        // Win for the winner, losses for the others
         if (winner_trader_id != -1) {
-            metrics_.record_trade_win(winner_trader_id);
+            winners_.push_back(winner_trader_id);
             for (const auto& [idx, trader_id] : competitors) {
-                if (trader_id != winner_trader_id) {
-                    metrics_.record_trade_loss(trader_id);
-                }
+                if (trader_id != winner_trader_id) losers_.push_back(trader_id);
             }
         }
     }
+    
+    if (output_) {
+        publish_batch(batch, trades, start);
+        return trades;
+    }
+    
+    // Readers see a batch's submissions, fills and wins together
+    FairnessMetrics::UpdateScope publish(metrics_);
+    for (const auto& ev : batch) {
+        metrics_.record_order_submission(ev.trader_id);
+    }
+    for (const auto& trade : trades) {
+        metrics_.record_trade(trade, false);
+    }
+    for (int id : winners_) metrics_.record_trade_win(id);
+    for (int id : losers_) metrics_.record_trade_loss(id);
+    
+    if (archive_) {
+        for (const auto& ev : batch) archive_->append_order(ev);
+        for (const auto& trade : trades) archive_->append_trade(trade, false);
+    }
+    
+    if (record_outcomes_) outcomes_.record(winners_, losers_);
+    TimeNs end = TscClock::now_ns();
+    rolling_.record_batch(end, end - start, batch.size(), trades, winners_, losers_);
+    return trades;
 }
 
-void MatchingEngine::process_order(const OrderEvent& ev, int trader_id) {
-    metrics_.record_order_submission(trader_id);
+std::vector<Trade> MatchingEngine::process_order(const OrderEvent& ev, int trader_id) {
+    TimeNs start = TscClock::now_ns();
+    auto trades = order_book_.process_order(ev, trader_id, &contention_);
+    PipelineStats::record_book_depth(order_book_.get_buy_depth(), order_book_.get_sell_depth());
+    
+    StageTimer timer(Stage::METRICS, 1);
+    winners_.assign(contention_.winners.begin(), contention_.winners.end());
+    losers_.clear();
+    if (contention_.loser != -1) losers_.push_back(contention_.loser);
     
-    auto trades = order_book_.process_order(ev, trader_id);
+    if (output_) {
+        publish_batch(OrderSpan(&ev, 1), trades, start, trader_id);
+        return trades;
+    }
     
+    FairnessMetrics::UpdateScope publish(metrics_);
+    metrics_.record_order_submission(trader_id);
     for (const auto& trade : trades) {
         metrics_.record_trade(trade, false);
     }
+    for (int id : winners_) metrics_.record_trade_win(id);
+    for (int id : losers_) metrics_.record_trade_loss(id);
+    
+    if (archive_) {
+        archive_->append_order(ev);
+        for (const auto& trade : trades) archive_->append_trade(trade, false);
+    }
+    
+    if (record_outcomes_) outcomes_.record(winners_, losers_);
+    TimeNs end = TscClock::now_ns();
+    rolling_.record_batch(end, end - start, 1, trades, winners_, losers_);
+    return trades;
+}
+
+void MatchingEngine::settle_contention() {
+    TimeNs start = TscClock::now_ns();
+    winners_.clear();
+    losers_.clear();
+    order_book_.settle_contention(winners_);
+    if (winners_.empty()) return;
+    
+    // Recorded as an empty batch carrying only the wins
+    if (output_) {
+        publish_batch(OrderSpan(), {}, start);
+        return;
+    }
     
-    // Note: In naive mode, we process orders immediately, so we can't easily detect
-    // competitions within a batch. However, we can track competitions by looking
-    // at orders that execute against the same price level in the book.
-    // For now, we'll track this differently - by checking if multiple orders
-    // at the same price executed around the same time.
+    FairnessMetrics::UpdateScope publish(metrics_);
+    for (int id : winners_) metrics_.record_trade_win(id);
+    if (record_outcomes_) outcomes_.record(winners_, losers_);
+    TimeNs end = TscClock::now_ns();
+    rolling_.record_batch(end, end - start, 0, {}, winners_, losers_);
+}
+
+void MatchingEngine::publish_batch(OrderSpan orders, const std::vector<Trade>& trades, TimeNs start, int trader_id) {
+    ExecutionFanout& out = *output_;
+    for (const auto& ev : orders) {
+        ExecutionEvent& slot = out.claim();
+        slot.kind = ExecKind::ORDER;
+        slot.order = OrderRecord{ev.order_id, ev.price, ev.qty, ev.recv_time, ev.batch_id,
+                                 trader_id != 0 ? trader_id : ev.trader_id, ev.side, ev.tif, ev.order_type};
+    }
+    for (const auto& trade : trades) {
+        ExecutionEvent& slot = out.claim();
+        slot.kind = ExecKind::FILL;
+        slot.fill = trade;
+    }
+    for (int id : winners_) {
+        ExecutionEvent& slot = out.claim();
+        slot.kind = ExecKind::WIN;
+        slot.trader_id = id;
+    }
+    for (int id : losers_) {
+        ExecutionEvent& slot = out.claim();
+        slot.kind = ExecKind::LOSS;
+        slot.trader_id = id;
+    }
+    ExecutionEvent& book = out.claim();
+    book.kind = ExecKind::BOOK;
+    book.book = BookTop{order_book_.get_best_bid(), order_book_.get_best_ask(),
+                        order_book_.get_buy_depth(), order_book_.get_sell_depth()};
+    ExecutionEvent& mark = out.claim();
+    mark.kind = ExecKind::BATCH;
+    mark.batch = BatchMark{start, TscClock::now_ns(), orders.size(), trades.size()};
+    out.publish();
+}
+
+ExecutionFanout::Handler MatchingEngine::metrics_consumer() {
+    return [this](const ExecutionEvent* events, size_t count) {
+        FairnessMetrics::UpdateScope publish(metrics_);
+        for (size_t i = 0; i < count; ++i) {
+            const ExecutionEvent& ev = events[i];
+            switch (ev.kind) {
+                case ExecKind::ORDER:
+                    metrics_.record_order_submission(ev.order.trader_id);
+                    break;
+                case ExecKind::FILL:
+                    metrics_.record_trade(ev.fill, false);
+                    if (rolling_.enabled()) out_trades_.push_back(ev.fill);
+                    break;
+                case ExecKind::WIN:
+                    metrics_.record_trade_win(ev.trader_id);
+                    out_winners_.push_back(ev.trader_id);
+                    break;
+                case ExecKind::LOSS:
+                    metrics_.record_trade_loss(ev.trader_id);
+                    out_losers_.push_back(ev.trader_id);
+                    break;
+                case ExecKind::BOOK:
+                    break;
+                case ExecKind::BATCH:
+                    if (record_outcomes_) outcomes_.record(out_winners_, out_losers_);
+                    rolling_.record_batch(ev.batch.end, ev.batch.end - ev.batch.start, ev.batch.orders,
+                                          out_trades_, out_winners_, out_losers_);
+                    out_trades_.clear();
+                    out_winners_.clear();
+                    out_losers_.clear();
+                    break;
+            }
+        }
+    };
+}
+
+ExecutionFanout::Handler MatchingEngine::journal_consumer() {
+    return [this](const ExecutionEvent* events, size_t count) {
+        if (!archive_) return;
+        for (size_t i = 0; i < count; ++i) {
+            const ExecutionEvent& ev = events[i];
+            if (ev.kind == ExecKind::FILL) {
+                archive_->append_trade(ev.fill, false);
+            } else if (ev.kind == ExecKind::ORDER) {
+                OrderEvent order{};
+                order.type = EventType::NEW;
+                order.order_id = ev.order.order_id;
+                order.side = ev.order.side;
+                order.price = ev.order.price;
+                order.qty = ev.order.qty;
+                order.tif = ev.order.tif;
+                order.order_type = ev.order.order_type;
+                order.recv_time = ev.order.recv_time;
+                order.batch_id = ev.order.batch_id;
+                order.trader_id = ev.order.trader_id;
+                archive_->append_order(order);
+            }
+        }
+    };
 }
@@ -5,23 +5,84 @@
 #include "core/MatchingMode.h"
 #include "book/OrderBook.h"
 #include "metrics/FairnessMetrics.h"
+#include "metrics/RollingMetrics.h"
+#include "metrics/Bootstrap.h"
+#include "engine/ExecutionFanout.h"
+
+class ArchiveWriter;
 
 class MatchingEngine {
 public:
     explicit MatchingEngine(MatchingMode mode);
     
-    void process_batch(const std::vector<OrderEvent>& batch, const std::vector<int>& trader_ids);
-    void process_order(const OrderEvent& ev, int trader_id);
+    // Both return the trades produced, after recording them in the metrics.
+    // process_order is the streaming path: competitions are attributed as
+    // orders arrive, from the book's per-level contention tracking.
+    // A batch is borrowed for the call (see OrderBook::process_batch).
+    std::vector<Trade> process_batch(OrderSpan batch);
+    std::vector<Trade> process_order(const OrderEvent& ev, int trader_id);
+    // A streaming competition's win is counted when it closes; this closes
+    // the ones still open and records their wins (call at the end of a stream)
+    void settle_contention();
     
     MatchingMode get_mode() const { return mode_; }
     void set_mode(MatchingMode mode);
     
+    void set_batch_timestamps(bool enabled) { order_book_.set_batch_timestamps(enabled); }
+    void set_price_band(Price low, Price high) { order_book_.set_price_band(low, high); }
+    void set_parallel_sort(WorkStealingPool* pool, size_t threshold) { order_book_.set_parallel_sort(pool, threshold); }
+    void reserve_book(size_t orders) { order_book_.reserve(orders); }
+    // process_order: same-level arrivals this close compete (default 100us)
+    void set_contention_horizon(TimeNs horizon) { order_book_.set_contention_horizon(horizon); }
+    
+    // Append every processed order and trade to archive (nullptr = off).
+    // The in-memory trade history is dropped while archiving.
+    void set_archive(ArchiveWriter* archive);
+    
+    // Publish orders, fills, competition outcomes, the top of book and a
+    // batch mark to output instead of recording them inline (nullptr =
+    // inline). The metrics and rolling windows are then written only by
+    // metrics_consumer() and the archive only by journal_consumer(), each
+    // on its own ring thread; flush the ring before reading them or
+    // changing the engine's settings.
+    void set_output(ExecutionFanout* output) { output_ = output; }
+    ExecutionFanout* get_output() const { return output_; }
+    ExecutionFanout::Handler metrics_consumer();
+    ExecutionFanout::Handler journal_consumer();
+    
     const OrderBook& get_order_book() const { return order_book_; }
     const FairnessMetrics& get_metrics() const { return metrics_; }
     FairnessMetrics& get_metrics() { return metrics_; }
+    
+    // Keep every contested batch's winners and losers for resampling
+    // (off by default; cleared with the metrics)
+    void set_record_outcomes(bool enabled) { record_outcomes_ = enabled; }
+    const BatchOutcomeLog& get_outcomes() const { return outcomes_; }
+    
+    // Recent per-interval history, alongside the cumulative metrics
+    const RollingMetrics& get_rolling() const { return rolling_; }
+    RollingMetrics& get_rolling() { return rolling_; }
 
 private:
     MatchingMode mode_;
     OrderBook order_book_;
     FairnessMetrics metrics_;
+    RollingMetrics rolling_;
+    ArchiveWriter* archive_;
+    ExecutionFanout* output_;
+    BatchOutcomeLog outcomes_;
+    bool record_outcomes_;
+    
+    // Competition outcomes of the current batch, for rolling_
+    ContentionOutcome contention_;
+    std::vector<int> winners_;
+    std::vector<int> losers_;
+    
+    // The batch metrics_consumer() is collecting for rolling_ (its thread only)
+    std::vector<Trade> out_trades_;
+    std::vector<int> out_winners_;
+    std::vector<int> out_losers_;
+    
+    // trader_id overrides the events' own when nonzero (see process_order)
+    void publish_batch(OrderSpan orders, const std::vector<Trade>& trades, TimeNs start, int trader_id = 0);
 };
\ No newline at end of file
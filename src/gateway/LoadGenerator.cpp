@@ -0,0 +1,194 @@
+// Load generator for the order gateway.
+//
+// Opens N TCP connections to the gateway, and on each one a writer thread
+// logs in and pipelines NEW_ORDER frames in large writes while a reader
+// thread counts the ACK/REJECT/FILL frames coming back. Prints send and
+// round-trip rates.
+
+#include "gateway/Protocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 9000;
+    int connections = 4;
+    uint64_t messages = 1'000'000;   // per connection
+    size_t frames_per_write = 1024;
+    int traders = 4;
+};
+
+struct ConnectionCounters {
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> acks{0};
+    std::atomic<uint64_t> rejects{0};
+    std::atomic<uint64_t> fills{0};
+};
+
+static int connect_to(const LoadConfig& cfg) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg.port);
+    if (inet_pton(AF_INET, cfg.host.c_str(), &addr.sin_addr) != 1 ||
+        connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static void writer(int fd, int conn_index, const LoadConfig& cfg, ConnectionCounters& counters) {
+    std::mt19937 rng(static_cast<uint32_t>(conn_index * 7919 + 17));
+    std::uniform_int_distribution<int> price_dist(-5, 5);
+    std::uniform_int_distribution<int> qty_dist(1, 10);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+
+    std::vector<WireMessage> frames(cfg.frames_per_write);
+    uint64_t client_order_id = 1;
+    int32_t trader_id = 1 + (conn_index % cfg.traders);
+
+    WireMessage login = make_wire_message(MsgType::LOGIN, 0, trader_id, 0, 0, 0);
+    if (send(fd, &login, kWireMessageSize, MSG_NOSIGNAL) != static_cast<ssize_t>(kWireMessageSize)) return;
+
+    while (client_order_id <= cfg.messages) {
+        size_t n = 0;
+        while (n < frames.size() && client_order_id <= cfg.messages) {
+            frames[n++] = make_wire_message(MsgType::NEW_ORDER, static_cast<uint8_t>(side_dist(rng)), trader_id,
+                                            client_order_id++, 100 + price_dist(rng), qty_dist(rng));
+        }
+
+        const char* p = reinterpret_cast<const char*>(frames.data());
+        size_t left = n * kWireMessageSize;
+        while (left > 0) {
+            ssize_t w = send(fd, p, left, MSG_NOSIGNAL);
+            if (w <= 0) return;
+            p += w;
+            left -= static_cast<size_t>(w);
+        }
+        counters.sent.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+static void reader(int fd, const LoadConfig& cfg, ConnectionCounters& counters) {
+    std::vector<char> buf(256 * 1024);
+    size_t carry = 0;
+
+    while (counters.acks.load(std::memory_order_relaxed) +
+           counters.rejects.load(std::memory_order_relaxed) < cfg.messages) {
+        ssize_t r = recv(fd, buf.data() + carry, buf.size() - carry, 0);
+        if (r <= 0) return;
+
+        size_t len = carry + static_cast<size_t>(r);
+        size_t frames = len / kWireMessageSize;
+        uint64_t acks = 0, rejects = 0, fills = 0;
+        for (size_t i = 0; i < frames; ++i) {
+            switch (static_cast<MsgType>(buf[i * kWireMessageSize])) {
+                case MsgType::ACK:    ++acks; break;
+                case MsgType::REJECT: ++rejects; break;
+                case MsgType::FILL:   ++fills; break;
+                default: break;
+            }
+        }
+        counters.acks.fetch_add(acks, std::memory_order_relaxed);
+        counters.rejects.fetch_add(rejects, std::memory_order_relaxed);
+        counters.fills.fetch_add(fills, std::memory_order_relaxed);
+
+        carry = len - frames * kWireMessageSize;
+        std::memmove(buf.data(), buf.data() + frames * kWireMessageSize, carry);
+    }
+}
+
+static void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --host <addr>        Gateway address (default 127.0.0.1)\n"
+              << "  --port <port>        Gateway port (default 9000)\n"
+              << "  --connections <N>    Parallel connections (default 4)\n"
+              << "  --messages <N>       Orders per connection (default 1000000)\n"
+              << "  --batch <N>          Frames per write() (default 1024)\n"
+              << "  --traders <N>        Distinct trader ids across connections (default 4)\n";
+}
+
+int main(int argc, char** argv) {
+    LoadConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "error: " << arg << " requires an argument\n";
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--host") cfg.host = value;
+        else if (arg == "--port") cfg.port = static_cast<uint16_t>(std::stoi(value));
+        else if (arg == "--connections") cfg.connections = std::max(1, std::stoi(value));
+        else if (arg == "--messages") cfg.messages = std::stoull(value);
+        else if (arg == "--batch") cfg.frames_per_write = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--traders") cfg.traders = std::max(1, std::stoi(value));
+        else {
+            std::cerr << "error: unknown option '" << arg << "'\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<int> fds;
+    for (int c = 0; c < cfg.connections; ++c) {
+        int fd = connect_to(cfg);
+        if (fd < 0) {
+            std::cerr << "error: cannot connect to " << cfg.host << ":" << cfg.port << "\n";
+            for (int open_fd : fds) close(open_fd);
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+
+    std::vector<ConnectionCounters> counters(cfg.connections);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < cfg.connections; ++c) {
+        threads.emplace_back(reader, fds[c], std::cref(cfg), std::ref(counters[c]));
+        threads.emplace_back(writer, fds[c], c, std::cref(cfg), std::ref(counters[c]));
+    }
+    for (auto& t : threads) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t sent = 0, acks = 0, rejects = 0, fills = 0;
+    for (const auto& c : counters) {
+        sent += c.sent.load();
+        acks += c.acks.load();
+        rejects += c.rejects.load();
+        fills += c.fills.load();
+    }
+    for (int fd : fds) close(fd);
+
+    std::cout << "Connections:     " << cfg.connections << "\n"
+              << "Orders sent:     " << sent << "\n"
+              << "Acks / rejects:  " << acks << " / " << rejects << "\n"
+              << "Fills received:  " << fills << "\n"
+              << "Elapsed:         " << secs << " s\n"
+              << "Order rate:      " << (secs > 0 ? sent / secs : 0.0) << " msg/s\n"
+              << "Total msg rate:  " << (secs > 0 ? (sent + acks + rejects + fills) / secs : 0.0) << " msg/s\n";
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "gateway/OrderGateway.h"
+#include "core/Clock.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr uint64_t kListenerId = 0;
+static constexpr int kMaxEvents = 256;
+
+static bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+OrderGateway::OrderGateway(MatchingEngine& engine, MicroBatcher& batcher)
+    : engine_(engine),
+      batcher_(batcher),
+      listen_fd_(-1),
+      epoll_fd_(-1),
+      running_(false),
+      next_conn_id_(1),
+      next_order_id_(1),
+      read_buf_(64 * 1024) {}
+
+OrderGateway::~OrderGateway() {
+    for (auto& [id, conn] : connections_) {
+        close(conn.fd);
+    }
+    if (listen_fd_ >= 0) close(listen_fd_);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+}
+
+bool OrderGateway::listen(uint16_t port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        last_error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        last_error_ = std::string("bind: ") + std::strerror(errno);
+        return false;
+    }
+    if (::listen(listen_fd_, SOMAXCONN) < 0 || !set_nonblocking(listen_fd_)) {
+        last_error_ = std::string("listen: ") + std::strerror(errno);
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(0);
+    if (epoll_fd_ < 0) {
+        last_error_ = std::string("epoll_create1: ") + std::strerror(errno);
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kListenerId;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+    return true;
+}
+
+void OrderGateway::run(TimeNs duration_ns) {
+    running_.store(true, std::memory_order_relaxed);
+    TimeNs deadline = duration_ns > 0 ? TscClock::now_ns() + duration_ns : 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        poll_once(1);
+        if (deadline != 0 && TscClock::now_ns() >= deadline) break;
+    }
+
+    // Match whatever is still buffered and deliver the last reports
+    while (batcher_.pending() > 0) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+    flush_dirty();
+    running_.store(false, std::memory_order_relaxed);
+}
+
+void OrderGateway::poll_once(int timeout_ms) {
+    epoll_event events[kMaxEvents];
+    int n = epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+
+    for (int i = 0; i < n; ++i) {
+        uint64_t id = events[i].data.u64;
+        if (id == kListenerId) {
+            accept_all();
+            continue;
+        }
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            close_connection(id);
+            continue;
+        }
+        if (events[i].events & EPOLLIN) {
+            read_connection(id);
+        }
+        if ((events[i].events & EPOLLOUT) && connections_.count(id)) {
+            flush(id);
+        }
+    }
+
+    // A batch whose window has passed must not wait for the next arrival
+    drain_batches(TscClock::now_ns());
+    flush_dirty();
+}
+
+void OrderGateway::accept_all() {
+    while (true) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) return;  // EAGAIN or transient error
+
+        set_nonblocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint64_t id = next_conn_id_++;
+        connections_[id] = Connection{fd, 0, {}, {}, 0, false, false, false};
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        stats_.connections_accepted++;
+    }
+}
+
+void OrderGateway::read_connection(uint64_t conn_id) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) return;
+    Connection& conn = it->second;
+
+    while (true) {
+        ssize_t r = read(conn.fd, read_buf_.data(), read_buf_.size());
+        stats_.read_calls++;
+
+        if (r <= 0) {
+            if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                close_connection(conn_id);
+            }
+            return;
+        }
+
+        // One ingress timestamp per read(): every frame in it arrived together
+        TimeNs recv_time = TscClock::now_ns();
+
+        // Decode in place unless a partial frame is carried over
+        const char* data = read_buf_.data();
+        size_t len = static_cast<size_t>(r);
+        if (!conn.in.empty()) {
+            conn.in.insert(conn.in.end(), read_buf_.data(), read_buf_.data() + r);
+            data = conn.in.data();
+            len = conn.in.size();
+        }
+
+        size_t frames = len / kWireMessageSize;
+        for (size_t f = 0; f < frames; ++f) {
+            handle_message(conn_id, decode_wire_message(data + f * kWireMessageSize), recv_time);
+        }
+
+        size_t consumed = frames * kWireMessageSize;
+        if (conn.in.empty()) {
+            conn.in.assign(data + consumed, data + len);
+        } else {
+            conn.in.erase(conn.in.begin(), conn.in.begin() + static_cast<std::ptrdiff_t>(consumed));
+        }
+
+        if (static_cast<size_t>(r) < read_buf_.size()) return;  // socket drained
+        if (conn.out.size() - conn.out_pos > kOutPauseBytes) return;  // flush() pauses it
+    }
+}
+
+void OrderGateway::handle_message(uint64_t conn_id, const WireMessage& msg, TimeNs recv_time) {
+    stats_.messages_in++;
+    MsgType type = static_cast<MsgType>(msg.type);
+    Connection& conn = connections_.at(conn_id);
+
+    if (type == MsgType::LOGIN) {
+        if (conn.trader_id != 0 || msg.trader_id <= 0) {
+            enqueue(conn_id, make_wire_message(MsgType::REJECT, msg.side, msg.trader_id, msg.client_order_id,
+                                               0, 0, RejectReason::BAD_LOGIN));
+            return;
+        }
+        conn.trader_id = msg.trader_id;
+        return;
+    }
+
+    // Attributed to the session, not to the frame's own trader_id
+    int32_t trader_id = conn.trader_id;
+    if (type == MsgType::CANCEL) {
+        // The book has no cancel path yet
+        enqueue(conn_id, make_wire_message(MsgType::REJECT, msg.side, trader_id, msg.client_order_id,
+                                           0, 0, RejectReason::CANCEL_UNSUPPORTED));
+        stats_.orders_rejected++;
+        return;
+    }
+
+    RejectReason reason = RejectReason::NONE;
+    TimeInForce tif = TimeInForce::GTC;
+    OrderType order_type = OrderType::LIMIT;
+    if (type != MsgType::NEW_ORDER) {
+        reason = RejectReason::BAD_MESSAGE;
+    } else if (trader_id == 0) {
+        reason = RejectReason::NOT_LOGGED_IN;
+    } else if (msg.side > 1) {
+        reason = RejectReason::BAD_SIDE;
+    } else if (msg.qty <= 0) {
+        reason = RejectReason::BAD_QTY;
+    } else if (!decode_order_type(msg.reason, tif, order_type)) {
+        reason = RejectReason::BAD_ORDER_TYPE;
+    }
+    if (reason != RejectReason::NONE) {
+        enqueue(conn_id, make_wire_message(MsgType::REJECT, msg.side, trader_id, msg.client_order_id,
+                                           msg.price, msg.qty, reason));
+        stats_.orders_rejected++;
+        return;
+    }
+
+    OrderID order_id = next_order_id_++;
+    owners_[order_id] = OrderOwner{conn_id, msg.client_order_id, trader_id, msg.qty};
+
+    OrderEvent ev;
+    ev.type = EventType::NEW;
+    ev.order_id = order_id;
+    ev.instrument = "GW";
+    ev.side = msg.side == 0 ? Side::BUY : Side::SELL;
+    ev.price = msg.price;
+    ev.qty = msg.qty;
+    ev.tif = tif;
+    ev.order_type = order_type;
+    ev.recv_time = recv_time;
+    ev.batch_id = 0;
+    ev.trader_id = trader_id;
+
+    // A blocking batcher hands the order back until the open batch is matched
+    Admission admission;
+    while ((admission = batcher_.submit(std::move(ev))) == Admission::WOULD_BLOCK) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+    if (admission == Admission::REJECTED_FULL || admission == Admission::REJECTED_TRADER) {
+        owners_.erase(order_id);
+        enqueue(conn_id, make_wire_message(MsgType::REJECT, msg.side, trader_id, msg.client_order_id,
+                                           msg.price, msg.qty,
+                                           admission == Admission::REJECTED_FULL ? RejectReason::BATCHER_FULL
+                                                                                 : RejectReason::TRADER_LIMIT));
+        stats_.orders_rejected++;
+        return;
+    }
+
+    enqueue(conn_id, make_wire_message(MsgType::ACK, msg.side, trader_id, msg.client_order_id,
+                                       msg.price, msg.qty));
+    stats_.orders_accepted++;
+
+    while (batcher_.has_ready_batch()) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+}
+
+void OrderGateway::drain_batches(TimeNs now) {
+    while (batcher_.has_expired_batch(now)) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+}
+
+void OrderGateway::dispatch_batch(std::vector<OrderEvent>&& batch) {
+    if (batch.empty()) return;
+    stats_.batches++;
+
+    auto trades = engine_.process_batch(batch);
+    for (const auto& t : trades) {
+        send_fill(t.buy_order_id, Side::BUY, t.price, t.qty);
+        send_fill(t.sell_order_id, Side::SELL, t.price, t.qty);
+    }
+
+    // IOC, FOK and market orders are finished once their batch is matched
+    for (const auto& ev : batch) {
+        if (rests_remainder(ev)) continue;
+        auto it = owners_.find(ev.order_id);
+        if (it == owners_.end()) continue;  // fully filled
+
+        const OrderOwner& owner = it->second;
+        enqueue(owner.conn_id, make_wire_message(MsgType::EXPIRED, ev.side == Side::BUY ? 0 : 1, owner.trader_id,
+                                                 owner.client_order_id, ev.price, owner.remaining));
+        stats_.orders_expired++;
+        owners_.erase(it);
+    }
+
+    batcher_.recycle(std::move(batch));
+}
+
+void OrderGateway::send_fill(OrderID order_id, Side side, Price price, Qty qty) {
+    auto it = owners_.find(order_id);
+    if (it == owners_.end()) return;
+
+    OrderOwner& owner = it->second;
+    if (connections_.count(owner.conn_id)) {
+        enqueue(owner.conn_id, make_wire_message(MsgType::FILL, side == Side::BUY ? 0 : 1, owner.trader_id,
+                                                 owner.client_order_id, price, qty));
+        stats_.fills_sent++;
+    }
+    owner.remaining -= qty;
+    if (owner.remaining <= 0) {
+        owners_.erase(it);
+    }
+}
+
+void OrderGateway::enqueue(uint64_t conn_id, const WireMessage& msg) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) return;
+
+    Connection& conn = it->second;
+    const char* bytes = reinterpret_cast<const char*>(&msg);
+    conn.out.insert(conn.out.end(), bytes, bytes + kWireMessageSize);
+    stats_.messages_out++;
+    if (!conn.dirty) {
+        conn.dirty = true;
+        dirty_.push_back(conn_id);
+    }
+}
+
+void OrderGateway::flush_dirty() {
+    for (uint64_t id : dirty_) {
+        auto it = connections_.find(id);
+        if (it == connections_.end()) continue;
+        it->second.dirty = false;
+        flush(id);
+    }
+    dirty_.clear();
+}
+
+bool OrderGateway::flush(uint64_t conn_id) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) return false;
+    Connection& conn = it->second;
+
+    while (conn.out_pos < conn.out.size()) {
+        ssize_t w = send(conn.fd, conn.out.data() + conn.out_pos, conn.out.size() - conn.out_pos, MSG_NOSIGNAL);
+        stats_.write_calls++;
+        if (w < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            close_connection(conn_id);
+            return false;
+        }
+        conn.out_pos += static_cast<size_t>(w);
+    }
+
+    size_t unsent = conn.out.size() - conn.out_pos;
+    if (unsent == 0) {
+        conn.out.clear();
+        conn.out_pos = 0;
+    } else if (unsent > kOutCloseBytes) {
+        close_connection(conn_id);
+        return false;
+    }
+
+    // Arm EPOLLOUT only while the kernel buffer is full, and stop reading
+    // orders from a client that is not reading their reports
+    update_events(conn_id, conn, unsent > 0, unsent > kOutPauseBytes);
+    return true;
+}
+
+void OrderGateway::update_events(uint64_t conn_id, Connection& conn, bool want_write, bool paused) {
+    if (want_write == conn.want_write && paused == conn.paused) return;
+    epoll_event ev{};
+    ev.events = (paused ? 0u : uint32_t(EPOLLIN)) | (want_write ? uint32_t(EPOLLOUT) : 0u);
+    ev.data.u64 = conn_id;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.want_write = want_write;
+    conn.paused = paused;
+}
+
+void OrderGateway::close_connection(uint64_t conn_id) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) return;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections_.erase(it);
+
+    // Its orders stay in the book with no one to report to; drop their
+    // routing entries so owners_ does not grow with every disconnect
+    for (auto o = owners_.begin(); o != owners_.end();) {
+        o = o->second.conn_id == conn_id ? owners_.erase(o) : std::next(o);
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/OrderEvent.h"
+#include "gateway/Protocol.h"
+#include "engine/MatchingEngine.h"
+#include "batching/MicroBatcher.h"
+
+struct GatewayStats {
+    uint64_t connections_accepted = 0;
+    uint64_t messages_in = 0;
+    uint64_t messages_out = 0;
+    uint64_t orders_accepted = 0;
+    uint64_t orders_rejected = 0;
+    uint64_t fills_sent = 0;
+    uint64_t orders_expired = 0;   // IOC/FOK/market remainders discarded
+    uint64_t batches = 0;
+    uint64_t read_calls = 0;
+    uint64_t write_calls = 0;
+};
+
+// TCP order gateway (Linux, epoll, non-blocking sockets).
+//
+// Decodes WireMessage frames straight into OrderEvents, stamps recv_time once
+// per read() at ingress, and feeds the MicroBatcher. Sealed batches go to the
+// MatchingEngine on the same thread, and ACK/FILL frames are appended to
+// per-connection output buffers that are flushed with one send() per
+// connection per event-loop pass. Orders are attributed to the trader id
+// the connection logged in with. A connection that does not read its
+// reports is no longer read from once kOutPauseBytes are unsent, and is
+// closed past kOutCloseBytes (fills of its resting orders still arrive).
+class OrderGateway {
+public:
+    OrderGateway(MatchingEngine& engine, MicroBatcher& batcher);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // Bind and listen on 0.0.0.0:port. Returns false and sets last_error().
+    bool listen(uint16_t port);
+
+    // Run the event loop until stop() or the duration elapses (0 = forever)
+    void run(TimeNs duration_ns);
+    void poll_once(int timeout_ms);
+    void stop() { running_.store(false, std::memory_order_relaxed); }
+
+    const GatewayStats& stats() const { return stats_; }
+    const std::string& last_error() const { return last_error_; }
+
+private:
+    struct Connection {
+        int fd;
+        int32_t trader_id;       // bound by LOGIN, 0 before
+        std::vector<char> in;    // unconsumed bytes (partial frame)
+        std::vector<char> out;   // pending output frames
+        size_t out_pos;
+        bool dirty;              // queued for flush this pass
+        bool want_write;         // EPOLLOUT armed
+        bool paused;             // EPOLLIN disarmed until the output drains
+    };
+
+    static constexpr size_t kOutPauseBytes = 1 << 20;
+    static constexpr size_t kOutCloseBytes = 16 << 20;
+
+    // Resting/working order ownership, for routing fills
+    struct OrderOwner {
+        uint64_t conn_id;
+        uint64_t client_order_id;
+        int32_t  trader_id;
+        Qty      remaining;
+    };
+
+    MatchingEngine& engine_;
+    MicroBatcher& batcher_;
+
+    int listen_fd_;
+    int epoll_fd_;
+    std::atomic<bool> running_;
+    std::string last_error_;
+
+    uint64_t next_conn_id_;
+    OrderID next_order_id_;
+    std::unordered_map<uint64_t, Connection> connections_;
+    std::unordered_map<OrderID, OrderOwner> owners_;
+    std::vector<uint64_t> dirty_;
+    std::vector<char> read_buf_;
+    GatewayStats stats_;
+
+    void accept_all();
+    void read_connection(uint64_t conn_id);
+    void handle_message(uint64_t conn_id, const WireMessage& msg, TimeNs recv_time);
+    void drain_batches(TimeNs now);
+    void dispatch_batch(std::vector<OrderEvent>&& batch);
+    void send_fill(OrderID order_id, Side side, Price price, Qty qty);
+
+    void enqueue(uint64_t conn_id, const WireMessage& msg);
+    void flush_dirty();
+    bool flush(uint64_t conn_id);
+    void update_events(uint64_t conn_id, Connection& conn, bool want_write, bool paused);
+    void close_connection(uint64_t conn_id);
+};
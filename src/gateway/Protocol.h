@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "core/OrderEvent.h"
+#include "core/Types.h"
+
+// Gateway wire protocol.
+//
+// Every message, in both directions, is one fixed 32-byte frame in host
+// (little-endian) byte order, so a TCP stream is decoded by cutting it into
+// 32-byte slices with no length prefix or parsing.
+//
+//   client -> engine: LOGIN, NEW_ORDER, CANCEL
+//   engine -> client: ACK, REJECT, FILL, EXPIRED
+//
+// A TCP client sends LOGIN with its trader_id first; it gets no reply
+// unless refused (REJECT BAD_LOGIN: a second LOGIN or an id <= 0). Its
+// orders are attributed to that id, whatever their own trader_id field
+// holds, and orders before it get REJECT NOT_LOGGED_IN. Shared memory
+// binds the trader to the client slot instead and takes no LOGIN.
+//
+// NEW_ORDER carries its order type in the reason field: bits 0-1 time in
+// force (0 GTC, 1 IOC, 2 FOK), bit 2 market order (price ignored). IOC, FOK
+// and market orders get one EXPIRED frame, with the discarded qty, once the
+// batch they were matched in leaves a remainder.
+//
+// Orders refused by the batcher's admission control get REJECT with
+// BATCHER_FULL or TRADER_LIMIT. Over shared memory with the latency model
+// on, admission happens when the delay ends, so that REJECT follows the ACK.
+
+enum class MsgType : uint8_t {
+    NEW_ORDER = 1,
+    CANCEL    = 2,
+    ACK       = 3,
+    REJECT    = 4,
+    FILL      = 5,
+    EXPIRED   = 6,
+    LOGIN     = 7
+};
+
+enum class RejectReason : uint16_t {
+    NONE               = 0,
+    BAD_MESSAGE        = 1,
+    BAD_QTY            = 2,
+    BAD_SIDE           = 3,
+    CANCEL_UNSUPPORTED = 4,
+    UNKNOWN_ORDER      = 5,
+    BAD_ORDER_TYPE     = 6,
+    BATCHER_FULL       = 7,   // admission: too many orders pending
+    TRADER_LIMIT       = 8,   // admission: this trader's in-flight cap
+    NOT_LOGGED_IN      = 9,
+    BAD_LOGIN          = 10
+};
+
+#pragma pack(push, 1)
+struct WireMessage {
+    uint8_t  type;             // MsgType
+    uint8_t  side;             // 0 = BUY, 1 = SELL
+    uint16_t reason;           // RejectReason (REJECT) or order type flags (NEW_ORDER)
+    int32_t  trader_id;
+    uint64_t client_order_id;  // echoed back on ACK/REJECT/FILL
+    int64_t  price;            // limit price (NEW) or execution price (FILL)
+    int64_t  qty;              // order qty (NEW/ACK) or fill qty (FILL)
+};
+#pragma pack(pop)
+
+constexpr uint16_t kOrderTifMask = 0x3;
+constexpr uint16_t kOrderMarket  = 0x4;
+
+// Order type flags of a NEW_ORDER; false if they are not a valid combination
+inline bool decode_order_type(uint16_t flags, TimeInForce& tif, OrderType& type) {
+    uint16_t tif_bits = flags & kOrderTifMask;
+    if (tif_bits > static_cast<uint16_t>(TimeInForce::FOK) || (flags & ~(kOrderTifMask | kOrderMarket))) {
+        return false;
+    }
+    tif = static_cast<TimeInForce>(tif_bits);
+    type = (flags & kOrderMarket) ? OrderType::MARKET : OrderType::LIMIT;
+    return true;
+}
+
+inline uint16_t encode_order_type(TimeInForce tif, OrderType type) {
+    return static_cast<uint16_t>(static_cast<uint16_t>(tif) | (type == OrderType::MARKET ? kOrderMarket : 0));
+}
+
+static_assert(sizeof(WireMessage) == 32, "WireMessage must be exactly 32 bytes");
+
+constexpr size_t kWireMessageSize = sizeof(WireMessage);
+
+inline WireMessage make_wire_message(MsgType type, uint8_t side, int32_t trader_id,
+                                     uint64_t client_order_id, int64_t price, int64_t qty,
+                                     RejectReason reason = RejectReason::NONE) {
+    WireMessage m;
+    m.type = static_cast<uint8_t>(type);
+    m.side = side;
+    m.reason = static_cast<uint16_t>(reason);
+    m.trader_id = trader_id;
+    m.client_order_id = client_order_id;
+    m.price = price;
+    m.qty = qty;
+    return m;
+}
+
+inline WireMessage decode_wire_message(const char* frame) {
+    WireMessage m;
+    std::memcpy(&m, frame, kWireMessageSize);
+    return m;
+}
@@ -0,0 +1,180 @@
+#include "ipc/SharedMemory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "core/HugePages.h"
+
+static size_t align64(size_t n) {
+    return (n + 63) & ~static_cast<size_t>(63);
+}
+
+static std::string shm_path(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+// Offsets inside one slot
+static size_t inbound_header_offset() { return align64(sizeof(ShmSlotControl)); }
+static size_t inbound_data_offset() { return inbound_header_offset() + align64(sizeof(SpscRingHeader)); }
+static size_t outbound_header_offset(uint64_t cap) {
+    return inbound_data_offset() + align64(SpscRing<WireMessage>::bytes_for(cap));
+}
+static size_t outbound_data_offset(uint64_t cap) {
+    return outbound_header_offset(cap) + align64(sizeof(SpscRingHeader));
+}
+
+ShmSegment::ShmSegment()
+    : base_(nullptr), size_(0), owner_(false), header_(nullptr) {}
+
+ShmSegment::~ShmSegment() {
+    if (base_) {
+        if (owner_) header_->engine_alive.store(0, std::memory_order_release);
+        munmap(base_, size_);
+    }
+    if (owner_) shm_unlink(shm_path(name_).c_str());
+}
+
+size_t ShmSegment::slot_stride(uint64_t ring_capacity) {
+    return align64(outbound_data_offset(ring_capacity) + SpscRing<WireMessage>::bytes_for(ring_capacity));
+}
+
+bool ShmSegment::create(const std::string& name, uint32_t slots, uint64_t ring_capacity) {
+    if (slots == 0 || ring_capacity == 0 || (ring_capacity & (ring_capacity - 1)) != 0) {
+        last_error_ = "slots must be > 0 and ring capacity a power of two";
+        return false;
+    }
+
+    std::string path = shm_path(name);
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        last_error_ = std::string("shm_open: ") + std::strerror(errno);
+        return false;
+    }
+
+    size_t stride = slot_stride(ring_capacity);
+    size_t size = align64(sizeof(ShmSegmentHeader)) + stride * slots;
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        last_error_ = std::string("ftruncate: ") + std::strerror(errno);
+        close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        last_error_ = std::string("mmap: ") + std::strerror(errno);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    name_ = name;
+    base_ = base;
+    size_ = size;
+    owner_ = true;
+    // Rings are hot on both sides; have them resident before traders attach
+    placement_ = HugePages::advise(base, size);
+
+    header_ = new (base) ShmSegmentHeader;
+    header_->version = kShmVersion;
+    header_->slots = slots;
+    header_->ring_capacity = ring_capacity;
+    header_->slot_stride = stride;
+    header_->engine_alive.store(1, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < slots; ++i) {
+        char* slot = slot_base(i);
+        auto* ctl = new (slot) ShmSlotControl;
+        ctl->attached.store(0, std::memory_order_relaxed);
+        ctl->trader_id = static_cast<int32_t>(i + 1);
+        SpscRing<WireMessage>::init(new (slot + inbound_header_offset()) SpscRingHeader, ring_capacity);
+        SpscRing<WireMessage>::init(new (slot + outbound_header_offset(ring_capacity)) SpscRingHeader, ring_capacity);
+    }
+
+    // Publish last: attachers check the magic before trusting the layout
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kShmMagic;
+    return true;
+}
+
+bool ShmSegment::attach(const std::string& name) {
+    std::string path = shm_path(name);
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        last_error_ = std::string("shm_open: ") + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(ShmSegmentHeader)) {
+        last_error_ = "segment is too small";
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        last_error_ = std::string("mmap: ") + std::strerror(errno);
+        return false;
+    }
+
+    auto* header = static_cast<ShmSegmentHeader*>(base);
+    if (header->magic != kShmMagic || header->version != kShmVersion) {
+        last_error_ = "not a FairOrder segment (bad magic or version)";
+        munmap(base, size);
+        return false;
+    }
+
+    name_ = name;
+    base_ = base;
+    size_ = size;
+    owner_ = false;
+    header_ = header;
+    return true;
+}
+
+bool ShmSegment::claim_slot(int trader_id) {
+    if (!header_ || trader_id < 1 || static_cast<uint32_t>(trader_id) > header_->slots) {
+        last_error_ = "no slot for trader " + std::to_string(trader_id);
+        return false;
+    }
+    uint32_t expected = 0;
+    if (!slot_control(static_cast<uint32_t>(trader_id - 1))->attached.compare_exchange_strong(expected, 1)) {
+        last_error_ = "slot for trader " + std::to_string(trader_id) + " is already attached";
+        return false;
+    }
+    return true;
+}
+
+void ShmSegment::release_slot(int trader_id) {
+    if (!header_ || trader_id < 1 || static_cast<uint32_t>(trader_id) > header_->slots) return;
+    slot_control(static_cast<uint32_t>(trader_id - 1))->attached.store(0, std::memory_order_release);
+}
+
+char* ShmSegment::slot_base(uint32_t slot) {
+    return static_cast<char*>(base_) + align64(sizeof(ShmSegmentHeader)) + header_->slot_stride * slot;
+}
+
+ShmSlotControl* ShmSegment::slot_control(uint32_t slot) {
+    return reinterpret_cast<ShmSlotControl*>(slot_base(slot));
+}
+
+SpscRing<WireMessage> ShmSegment::inbound(uint32_t slot) {
+    char* s = slot_base(slot);
+    return SpscRing<WireMessage>(reinterpret_cast<SpscRingHeader*>(s + inbound_header_offset()),
+                                 reinterpret_cast<WireMessage*>(s + inbound_data_offset()));
+}
+
+SpscRing<WireMessage> ShmSegment::outbound(uint32_t slot) {
+    char* s = slot_base(slot);
+    uint64_t cap = header_->ring_capacity;
+    return SpscRing<WireMessage>(reinterpret_cast<SpscRingHeader*>(s + outbound_header_offset(cap)),
+                                 reinterpret_cast<WireMessage*>(s + outbound_data_offset(cap)));
+}
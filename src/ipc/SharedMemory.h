@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "gateway/Protocol.h"
+#include "ipc/SpscRing.h"
+
+// Shared-memory segment (POSIX shm, /dev/shm/<name>) holding one slot per
+// trader process. Each slot has an inbound ring (trader -> engine, NEW_ORDER
+// and CANCEL frames) and an outbound ring (engine -> trader, ACK/REJECT/FILL
+// frames), both carrying the gateway's 32-byte WireMessage.
+//
+// Layout: [ShmSegmentHeader][slot 0][slot 1]...  with every slot laid out as
+// [ShmSlotControl][inbound header][inbound data][outbound header][outbound data]
+// and each section 64-byte aligned.
+
+constexpr uint64_t kShmMagic = 0x4641495253484d31ULL;  // "FAIRSHM1"
+constexpr uint32_t kShmVersion = 1;
+
+struct ShmSegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slots;
+    uint64_t ring_capacity;
+    uint64_t slot_stride;
+    std::atomic<uint32_t> engine_alive;
+};
+
+struct ShmSlotControl {
+    alignas(64) std::atomic<uint32_t> attached;  // 1 while a trader process owns the slot
+    int32_t trader_id;                            // slot i serves trader i + 1
+};
+
+class ShmSegment {
+public:
+    ShmSegment();
+    ~ShmSegment();
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    // Engine side: create (replacing any stale segment) and unlink on destruction
+    bool create(const std::string& name, uint32_t slots, uint64_t ring_capacity);
+    // Trader side: map an existing segment
+    bool attach(const std::string& name);
+
+    // Trader side: claim / release the slot of a trader id
+    bool claim_slot(int trader_id);
+    void release_slot(int trader_id);
+
+    uint32_t slots() const { return header_ ? header_->slots : 0; }
+    ShmSegmentHeader* header() { return header_; }
+    ShmSlotControl* slot_control(uint32_t slot);
+    SpscRing<WireMessage> inbound(uint32_t slot);
+    SpscRing<WireMessage> outbound(uint32_t slot);
+
+    const std::string& last_error() const { return last_error_; }
+    // Huge-page / NUMA / prefault treatment applied by create()
+    const std::string& placement() const { return placement_; }
+
+private:
+    std::string name_;
+    void* base_;
+    size_t size_;
+    bool owner_;
+    ShmSegmentHeader* header_;
+    std::string last_error_;
+    std::string placement_;
+
+    char* slot_base(uint32_t slot);
+    static size_t slot_stride(uint64_t ring_capacity);
+};
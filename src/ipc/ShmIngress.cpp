@@ -0,0 +1,229 @@
+#include "ipc/ShmIngress.h"
+#include "core/Clock.h"
+
+static constexpr size_t kDrainPerSlot = 256;
+
+ShmIngress::ShmIngress(MatchingEngine& engine, MicroBatcher& batcher, ShmSegment& segment)
+    : engine_(engine),
+      batcher_(batcher),
+      segment_(segment),
+      next_order_id_(1),
+      running_(false),
+      scratch_(kDrainPerSlot) {
+    for (uint32_t i = 0; i < segment_.slots(); ++i) {
+        slots_.push_back(Slot{segment_.inbound(i), segment_.outbound(i), 0, {}, {}});
+    }
+}
+
+void ShmIngress::set_slot_delay(uint32_t slot, TimeNs delay_ns) {
+    if (slot < slots_.size()) slots_[slot].delay_ns = delay_ns;
+}
+
+void ShmIngress::run(TimeNs duration_ns) {
+    running_.store(true, std::memory_order_relaxed);
+    TimeNs deadline = duration_ns > 0 ? TscClock::now_ns() + duration_ns : 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        poll_once();
+        if (deadline != 0 && TscClock::now_ns() >= deadline) break;
+    }
+
+    // Release everything still held, match it and deliver the last reports
+    release_delayed(~TimeNs(0));
+    while (batcher_.pending() > 0) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+    flush_backlogs();
+    running_.store(false, std::memory_order_relaxed);
+}
+
+size_t ShmIngress::poll_once() {
+    size_t consumed = 0;
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+        size_t n = slots_[i].in.pop_many(scratch_.data(), scratch_.size());
+        if (n == 0) continue;
+        TimeNs now = TscClock::now_ns();
+        for (size_t k = 0; k < n; ++k) {
+            handle_message(i, scratch_[k], now);
+        }
+        consumed += n;
+    }
+
+    TimeNs now = TscClock::now_ns();
+    release_delayed(now);
+    while (batcher_.has_expired_batch(now)) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+    flush_backlogs();
+    return consumed;
+}
+
+void ShmIngress::handle_message(uint32_t slot, const WireMessage& msg, TimeNs now) {
+    stats_.messages_in++;
+    MsgType type = static_cast<MsgType>(msg.type);
+    int32_t trader_id = static_cast<int32_t>(slot + 1);
+
+    RejectReason reason = RejectReason::NONE;
+    TimeInForce tif = TimeInForce::GTC;
+    OrderType order_type = OrderType::LIMIT;
+    if (type == MsgType::CANCEL) {
+        reason = RejectReason::CANCEL_UNSUPPORTED;
+    } else if (type != MsgType::NEW_ORDER) {
+        reason = RejectReason::BAD_MESSAGE;
+    } else if (msg.side > 1) {
+        reason = RejectReason::BAD_SIDE;
+    } else if (msg.qty <= 0) {
+        reason = RejectReason::BAD_QTY;
+    } else if (!decode_order_type(msg.reason, tif, order_type)) {
+        reason = RejectReason::BAD_ORDER_TYPE;
+    }
+    if (reason != RejectReason::NONE) {
+        send(slot, make_wire_message(MsgType::REJECT, msg.side, trader_id, msg.client_order_id,
+                                     msg.price, msg.qty, reason));
+        stats_.orders_rejected++;
+        return;
+    }
+
+    OrderID order_id = next_order_id_++;
+    owners_[order_id] = OrderOwner{slot, msg.client_order_id, msg.qty};
+
+    OrderEvent ev;
+    ev.type = EventType::NEW;
+    ev.order_id = order_id;
+    ev.instrument = "SHM";
+    ev.side = msg.side == 0 ? Side::BUY : Side::SELL;
+    ev.price = msg.price;
+    ev.qty = msg.qty;
+    ev.tif = tif;
+    ev.order_type = order_type;
+    ev.recv_time = now;
+    ev.batch_id = 0;
+    ev.trader_id = trader_id;  // the slot, not the frame, identifies the trader
+
+    Slot& s = slots_[slot];
+    if (s.delay_ns > 0) {
+        // Answered once the batcher has taken or refused it
+        ev.recv_time = now + s.delay_ns;
+        s.delayed.push_back(PendingOrder{ev.recv_time, std::move(ev)});
+        stats_.delayed++;
+        return;
+    }
+
+    submit_order(std::move(ev));
+    while (batcher_.has_ready_batch()) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+}
+
+void ShmIngress::release_delayed(TimeNs now) {
+    // Merge the per-slot FIFOs in release order so the batcher still sees
+    // recv_time in arrival order across traders
+    while (true) {
+        Slot* next = nullptr;
+        for (auto& s : slots_) {
+            if (!s.delayed.empty() && s.delayed.front().release_time <= now &&
+                (!next || s.delayed.front().release_time < next->delayed.front().release_time)) {
+                next = &s;
+            }
+        }
+        if (!next) return;
+
+        submit_order(std::move(next->delayed.front().ev));
+        next->delayed.pop_front();
+        while (batcher_.has_ready_batch()) {
+            dispatch_batch(batcher_.pop_batch());
+        }
+    }
+}
+
+bool ShmIngress::submit_order(OrderEvent&& ev) {
+    OrderID order_id = ev.order_id;
+    Side side = ev.side;
+    Price price = ev.price;
+    Qty qty = ev.qty;
+
+    // A blocking batcher hands the order back until the open batch is matched
+    Admission admission;
+    while ((admission = batcher_.submit(std::move(ev))) == Admission::WOULD_BLOCK) {
+        dispatch_batch(batcher_.pop_batch());
+    }
+    bool accepted = admission != Admission::REJECTED_FULL && admission != Admission::REJECTED_TRADER;
+
+    // Exactly one answer per order, after admission
+    auto it = owners_.find(order_id);
+    if (it != owners_.end()) {
+        const OrderOwner& owner = it->second;
+        uint8_t wire_side = side == Side::BUY ? 0 : 1;
+        int32_t trader_id = static_cast<int32_t>(owner.slot + 1);
+        if (accepted) {
+            send(owner.slot, make_wire_message(MsgType::ACK, wire_side, trader_id, owner.client_order_id, price, qty));
+        } else {
+            send(owner.slot, make_wire_message(MsgType::REJECT, wire_side, trader_id, owner.client_order_id, price, qty,
+                                               admission == Admission::REJECTED_FULL ? RejectReason::BATCHER_FULL
+                                                                                     : RejectReason::TRADER_LIMIT));
+            owners_.erase(it);
+        }
+    }
+    if (accepted) {
+        stats_.orders_accepted++;
+    } else {
+        stats_.orders_rejected++;
+    }
+    return accepted;
+}
+
+void ShmIngress::dispatch_batch(std::vector<OrderEvent>&& batch) {
+    if (batch.empty()) return;
+    stats_.batches++;
+
+    auto trades = engine_.process_batch(batch);
+    for (const auto& t : trades) {
+        for (int leg = 0; leg < 2; ++leg) {
+            OrderID id = leg == 0 ? t.buy_order_id : t.sell_order_id;
+            auto it = owners_.find(id);
+            if (it == owners_.end()) continue;
+
+            OrderOwner& owner = it->second;
+            send(owner.slot, make_wire_message(MsgType::FILL, static_cast<uint8_t>(leg),
+                                               static_cast<int32_t>(owner.slot + 1),
+                                               owner.client_order_id, t.price, t.qty));
+            stats_.fills_sent++;
+            owner.remaining -= t.qty;
+            if (owner.remaining <= 0) owners_.erase(it);
+        }
+    }
+
+    // IOC, FOK and market orders are finished once their batch is matched
+    for (const auto& ev : batch) {
+        if (rests_remainder(ev)) continue;
+        auto it = owners_.find(ev.order_id);
+        if (it == owners_.end()) continue;  // fully filled
+
+        const OrderOwner& owner = it->second;
+        send(owner.slot, make_wire_message(MsgType::EXPIRED, ev.side == Side::BUY ? 0 : 1,
+                                           static_cast<int32_t>(owner.slot + 1), owner.client_order_id,
+                                           ev.price, owner.remaining));
+        stats_.orders_expired++;
+        owners_.erase(it);
+    }
+
+    batcher_.recycle(std::move(batch));
+}
+
+void ShmIngress::send(uint32_t slot, const WireMessage& msg) {
+    Slot& s = slots_[slot];
+    stats_.messages_out++;
+    // Keep report order: once anything is parked, queue behind it
+    if (!s.backlog.empty() || !s.out.try_push(msg)) {
+        s.backlog.push_back(msg);
+        stats_.outbound_stalls++;
+    }
+}
+
+void ShmIngress::flush_backlogs() {
+    for (auto& s : slots_) {
+        while (!s.backlog.empty() && s.out.try_push(s.backlog.front())) {
+            s.backlog.pop_front();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/OrderEvent.h"
+#include "ipc/SharedMemory.h"
+#include "engine/MatchingEngine.h"
+#include "batching/MicroBatcher.h"
+
+struct ShmIngressStats {
+    uint64_t messages_in = 0;
+    uint64_t messages_out = 0;
+    uint64_t orders_accepted = 0;
+    uint64_t orders_rejected = 0;
+    uint64_t fills_sent = 0;
+    uint64_t orders_expired = 0;  // IOC/FOK/market remainders discarded
+    uint64_t batches = 0;
+    uint64_t delayed = 0;         // orders held by the latency model
+    uint64_t outbound_stalls = 0; // reports parked because a trader's ring was full
+};
+
+// Engine side of the shared-memory transport. Busy-polls every trader's
+// inbound ring, turns frames into OrderEvents for the MicroBatcher and
+// writes ACK/REJECT/FILL frames back to the owning trader's outbound ring.
+//
+// Each slot can carry an artificial one-way delay (e.g. the trader's
+// artificial_latency_ns): an order first seen at t is released to the
+// batcher with recv_time = t + delay. The delay is constant per slot, so a
+// FIFO per slot keeps release order without a heap.
+class ShmIngress {
+public:
+    ShmIngress(MatchingEngine& engine, MicroBatcher& batcher, ShmSegment& segment);
+
+    void set_slot_delay(uint32_t slot, TimeNs delay_ns);
+
+    // Poll until stop() or the duration elapses (0 = forever)
+    void run(TimeNs duration_ns);
+    // One pass over all rings; returns the number of frames consumed
+    size_t poll_once();
+    void stop() { running_.store(false, std::memory_order_relaxed); }
+
+    const ShmIngressStats& stats() const { return stats_; }
+
+private:
+    struct PendingOrder {
+        TimeNs release_time;
+        OrderEvent ev;
+    };
+
+    struct Slot {
+        SpscRing<WireMessage> in;
+        SpscRing<WireMessage> out;
+        TimeNs delay_ns;
+        std::deque<PendingOrder> delayed;   // FIFO: constant delay per slot
+        std::deque<WireMessage> backlog;    // reports waiting for ring space
+    };
+
+    struct OrderOwner {
+        uint32_t slot;
+        uint64_t client_order_id;
+        Qty remaining;
+    };
+
+    MatchingEngine& engine_;
+    MicroBatcher& batcher_;
+    ShmSegment& segment_;
+    std::vector<Slot> slots_;
+    std::unordered_map<OrderID, OrderOwner> owners_;
+    OrderID next_order_id_;
+    std::atomic<bool> running_;
+    ShmIngressStats stats_;
+    std::vector<WireMessage> scratch_;
+
+    void handle_message(uint32_t slot, const WireMessage& msg, TimeNs now);
+    void release_delayed(TimeNs now);
+    // Admission through the batcher, then the order's one ACK or REJECT
+    bool submit_order(OrderEvent&& ev);
+    void dispatch_batch(std::vector<OrderEvent>&& batch);
+    void send(uint32_t slot, const WireMessage& msg);
+    void flush_backlogs();
+};
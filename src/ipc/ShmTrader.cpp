@@ -0,0 +1,127 @@
+// Trader process for the shared-memory transport.
+//
+// Attaches to the engine's segment, claims the slot of one trader id and
+// streams NEW_ORDER frames into its inbound ring while draining ACK/FILL
+// frames from the outbound ring. Reports throughput and order -> ACK round
+// trip latency as seen from this process.
+
+#include "ipc/SharedMemory.h"
+#include "core/Clock.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct TraderConfig {
+    std::string name = "fairorder";
+    int trader_id = 1;
+    uint64_t orders = 100'000;
+    int price_center = 100;
+};
+
+static void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --name <segment>   Shared-memory segment name (default fairorder)\n"
+              << "  --trader <id>      Trader id / slot to claim (default 1)\n"
+              << "  --orders <N>       Orders to send (default 100000)\n";
+}
+
+int main(int argc, char** argv) {
+    TraderConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "error: " << arg << " requires an argument\n";
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--name") cfg.name = value;
+        else if (arg == "--trader") cfg.trader_id = std::stoi(value);
+        else if (arg == "--orders") cfg.orders = std::stoull(value);
+        else {
+            std::cerr << "error: unknown option '" << arg << "'\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    ShmSegment segment;
+    if (!segment.attach(cfg.name) || !segment.claim_slot(cfg.trader_id)) {
+        std::cerr << "error: " << segment.last_error() << "\n";
+        return 1;
+    }
+
+    uint32_t slot = static_cast<uint32_t>(cfg.trader_id - 1);
+    SpscRing<WireMessage> out_ring = segment.inbound(slot);   // we produce the engine's inbound
+    SpscRing<WireMessage> in_ring = segment.outbound(slot);
+
+    std::mt19937 rng(static_cast<uint32_t>(cfg.trader_id * 104729));
+    std::uniform_int_distribution<int> price_dist(-5, 5);
+    std::uniform_int_distribution<int> qty_dist(1, 10);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+
+    std::vector<uint64_t> sent_ticks(cfg.orders + 1, 0);
+    std::vector<uint64_t> rtt_ticks;
+    rtt_ticks.reserve(cfg.orders);
+    std::vector<WireMessage> reports(256);
+
+    uint64_t next_id = 1, acks = 0, rejects = 0, fills = 0;
+    uint64_t start = TscClock::ticks();
+
+    while ((acks + rejects) < cfg.orders) {
+        bool progress = false;
+        if (next_id <= cfg.orders) {
+            WireMessage m = make_wire_message(MsgType::NEW_ORDER, static_cast<uint8_t>(side_dist(rng)),
+                                              cfg.trader_id, next_id, cfg.price_center + price_dist(rng),
+                                              qty_dist(rng));
+            uint64_t now = TscClock::ticks();
+            if (out_ring.try_push(m)) {
+                sent_ticks[next_id++] = now;
+                progress = true;
+            }
+        }
+
+        size_t n = in_ring.pop_many(reports.data(), reports.size());
+        uint64_t now = TscClock::ticks();
+        for (size_t i = 0; i < n; ++i) {
+            const WireMessage& r = reports[i];
+            switch (static_cast<MsgType>(r.type)) {
+                case MsgType::ACK:
+                    ++acks;
+                    if (r.client_order_id <= cfg.orders) rtt_ticks.push_back(now - sent_ticks[r.client_order_id]);
+                    break;
+                case MsgType::REJECT: ++rejects; break;
+                case MsgType::FILL:   ++fills; break;
+                default: break;
+            }
+        }
+
+        if (!progress && n == 0 &&
+            segment.header()->engine_alive.load(std::memory_order_acquire) == 0) {
+            std::cerr << "engine went away\n";
+            break;
+        }
+    }
+
+    double secs = (TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(start)) / 1e9;
+    segment.release_slot(cfg.trader_id);
+
+    std::sort(rtt_ticks.begin(), rtt_ticks.end());
+    auto pct = [&](double p) -> double {
+        if (rtt_ticks.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(p * static_cast<double>(rtt_ticks.size() - 1));
+        return static_cast<double>(rtt_ticks[idx]) * TscClock::ns_per_tick();
+    };
+
+    std::cout << "Trader " << cfg.trader_id << ": " << (next_id - 1) << " orders, "
+              << acks << " acks, " << rejects << " rejects, " << fills << " fills in " << secs << " s\n"
+              << "  order rate:   " << (secs > 0 ? (next_id - 1) / secs : 0.0) << " msg/s\n"
+              << "  ack RTT (ns): p50 " << pct(0.50) << "  p99 " << pct(0.99) << "  max " << pct(1.0) << "\n";
+    return 0;
+}
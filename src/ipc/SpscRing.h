@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Control block of a single-producer/single-consumer ring that lives in
+// shared memory. head and tail sit on their own cache lines so the producer
+// and consumer never write the same line.
+struct SpscRingHeader {
+    alignas(64) std::atomic<uint64_t> head;   // next slot to write (producer)
+    alignas(64) std::atomic<uint64_t> tail;   // next slot to read (consumer)
+    alignas(64) uint64_t capacity;            // power of two
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory rings need address-free lock-free atomics");
+
+// Process-local view of a ring: header plus element array, both possibly in
+// a mapping shared with another process. Each side keeps a cached copy of
+// the other side's index and only re-reads it when the ring looks full/empty.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "ring elements are copied across processes");
+
+public:
+    SpscRing() : hdr_(nullptr), data_(nullptr), mask_(0), cached_head_(0), cached_tail_(0) {}
+    SpscRing(SpscRingHeader* hdr, T* data)
+        : hdr_(hdr), data_(data), mask_(hdr->capacity - 1),
+          cached_head_(hdr->head.load(std::memory_order_acquire)),
+          cached_tail_(hdr->tail.load(std::memory_order_acquire)) {}
+
+    static void init(SpscRingHeader* hdr, uint64_t capacity) {
+        hdr->head.store(0, std::memory_order_relaxed);
+        hdr->tail.store(0, std::memory_order_relaxed);
+        hdr->capacity = capacity;
+    }
+
+    static size_t bytes_for(uint64_t capacity) { return capacity * sizeof(T); }
+
+    // Producer side
+    bool try_push(const T& item) {
+        uint64_t head = hdr_->head.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = hdr_->tail.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) return false;
+        }
+        data_[head & mask_] = item;
+        hdr_->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: drain up to max items with one index publish
+    size_t pop_many(T* out, size_t max) {
+        uint64_t tail = hdr_->tail.load(std::memory_order_relaxed);
+        if (cached_head_ == tail) {
+            cached_head_ = hdr_->head.load(std::memory_order_acquire);
+            if (cached_head_ == tail) return 0;
+        }
+        size_t n = static_cast<size_t>(cached_head_ - tail);
+        if (n > max) n = max;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = data_[(tail + i) & mask_];
+        }
+        hdr_->tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    bool valid() const { return hdr_ != nullptr; }
+
+private:
+    SpscRingHeader* hdr_;
+    T* data_;
+    uint64_t mask_;
+    uint64_t cached_head_;  // consumer's view of head
+    uint64_t cached_tail_;  // producer's view of tail
+};
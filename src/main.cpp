@@ -1,8 +1,89 @@
 #include "ui/CLI.h"
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "\n"
+              << "Without options, starts the interactive CLI.\n"
+              << "\n"
+              << "Scripted mode (runs commands, then writes results):\n"
+              << "  --script <file>      Read CLI commands from file, one per line ('#' comments)\n"
+              << "  -e, --exec <cmd>     Run a CLI command (repeatable, runs after --script)\n"
+              << "  --format <json|csv>  Result format (default json)\n"
+              << "  --output <file>      Write results to file instead of stdout\n"
+              << "  -q, --quiet          Suppress human-readable output\n"
+              << "  -h, --help           Show this message\n"
+              << "\n"
+              << "Example:\n"
+              << "  " << prog << " -q --format csv -e \"window 50us\" -e \"experiment 5000\"\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        CLI cli;
+        cli.run();
+        return 0;
+    }
+
+    BatchOptions options;
+    std::vector<std::string> commands;
+    std::vector<std::string> exec_commands;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "error: " << name << " requires an argument\n";
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--script") {
+            const char* path = next("--script");
+            if (!path) return 2;
+            std::ifstream file(path);
+            if (!file) {
+                std::cerr << "error: cannot open script " << path << "\n";
+                return 2;
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                commands.push_back(line);
+            }
+        } else if (arg == "-e" || arg == "--exec") {
+            const char* cmd = next("--exec");
+            if (!cmd) return 2;
+            exec_commands.push_back(cmd);
+        } else if (arg == "--format") {
+            const char* fmt = next("--format");
+            if (!fmt) return 2;
+            options.format = fmt;
+            if (options.format != "json" && options.format != "csv") {
+                std::cerr << "error: unknown format '" << options.format << "' (use json or csv)\n";
+                return 2;
+            }
+        } else if (arg == "--output") {
+            const char* path = next("--output");
+            if (!path) return 2;
+            options.output_path = path;
+        } else if (arg == "-q" || arg == "--quiet") {
+            options.quiet = true;
+        } else {
+            std::cerr << "error: unknown option '" << arg << "'\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    commands.insert(commands.end(), exec_commands.begin(), exec_commands.end());
 
-int main() {
     CLI cli;
-    cli.run();
-    return 0;
+    return cli.run_batch(commands, options);
 }
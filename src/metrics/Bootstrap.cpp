@@ -0,0 +1,215 @@
+#include "metrics/Bootstrap.h"
+#include "core/WorkStealingPool.h"
+#include "simulation/TraderPopulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+void BatchOutcomeLog::record(const std::vector<int>& winners, const std::vector<int>& losers) {
+    if (winners.empty() && losers.empty()) return;
+    first_.push_back(static_cast<uint32_t>(outcomes_.size()));
+    for (int id : winners) outcomes_.push_back({id, 1});
+    for (int id : losers) outcomes_.push_back({id, 0});
+}
+
+void BatchOutcomeLog::clear() {
+    first_.clear();
+    outcomes_.clear();
+}
+
+namespace {
+
+// Win/loss counts of one sample over dense trader keys, reset after each
+// statistic by walking only the keys it touched
+struct Tally {
+    std::vector<uint32_t> won;
+    std::vector<uint32_t> lost;
+    std::vector<uint32_t> touched;
+    std::vector<uint64_t> group_won;
+    std::vector<uint64_t> group_lost;
+
+    Tally(size_t keys, size_t groups)
+        : won(keys, 0), lost(keys, 0), group_won(groups, 0), group_lost(groups, 0) {}
+
+    void add(uint32_t key, int was_won) {
+        if (won[key] + lost[key] == 0) touched.push_back(key);
+        won[key] += static_cast<uint32_t>(was_won);
+        lost[key] += static_cast<uint32_t>(1 - was_won);
+    }
+};
+
+struct Sample {
+    double fairness;
+    double reduction;
+    std::vector<double> win_rates;
+};
+
+class Resampler {
+public:
+    Resampler(const BatchOutcomeLog& log, const TraderPopulation& population) : log_(log) {
+        const auto& report = population.report_traders();
+        groups_ = report.size();
+        if (groups_ >= 2) {
+            auto by_latency = [](const Trader& a, const Trader& b) {
+                return a.artificial_latency_ns < b.artificial_latency_ns;
+            };
+            fastest_ = static_cast<size_t>(std::min_element(report.begin(), report.end(), by_latency) - report.begin());
+            slowest_ = static_cast<size_t>(std::max_element(report.begin(), report.end(), by_latency) - report.begin());
+        }
+
+        // Dense key per outcome, and the report trader of each key
+        std::unordered_map<int, uint32_t> key_of;
+        keys_.reserve(log.outcomes());
+        for (size_t b = 0; b < log.batches(); ++b) {
+            for (const auto* o = log.begin(b); o != log.end(b); ++o) {
+                auto [it, inserted] = key_of.try_emplace(o->trader_id, static_cast<uint32_t>(group_of_.size()));
+                if (inserted) group_of_.push_back(population.report_index(o->trader_id));
+                keys_.push_back(it->second);
+            }
+        }
+    }
+
+    Tally make_tally() const { return Tally(group_of_.size(), groups_); }
+
+    // Every batch once: the point estimate
+    Sample full(Tally& t) const {
+        for (size_t b = 0; b < log_.batches(); ++b) add_batch(t, b);
+        return collect(t);
+    }
+
+    // batches() draws with replacement from a generator seeded by the replicate
+    Sample replicate(Tally& t, uint64_t seed, size_t index) const {
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                          static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32)};
+        std::mt19937_64 rng(seq);
+        std::uniform_int_distribution<size_t> pick(0, log_.batches() - 1);
+        for (size_t n = log_.batches(); n > 0; --n) add_batch(t, pick(rng));
+        return collect(t);
+    }
+
+private:
+    const BatchOutcomeLog& log_;
+    std::vector<uint32_t> keys_;    // parallel to the log's outcomes
+    std::vector<int> group_of_;     // report_index() per key, -1 = none
+    size_t groups_ = 0;
+    size_t fastest_ = 0;
+    size_t slowest_ = 0;
+
+    void add_batch(Tally& t, size_t b) const {
+        const auto* base = log_.begin(0);
+        for (const auto* o = log_.begin(b); o != log_.end(b); ++o) {
+            t.add(keys_[static_cast<size_t>(o - base)], o->won);
+        }
+    }
+
+    // The run's figures from the tally, which is left cleared
+    Sample collect(Tally& t) const {
+        // Spread index as WinRateIndex computes it: 1 - (max rate - lowest nonzero rate)
+        double max_rate = 0.0, min_positive = 1.0;
+        for (uint32_t k : t.touched) {
+            double rate = static_cast<double>(t.won[k]) / static_cast<double>(t.won[k] + t.lost[k]);
+            max_rate = std::max(max_rate, rate);
+            if (rate > 0.0) min_positive = std::min(min_positive, rate);
+            int g = group_of_[k];
+            if (g >= 0) {
+                t.group_won[static_cast<size_t>(g)] += t.won[k];
+                t.group_lost[static_cast<size_t>(g)] += t.lost[k];
+            }
+            t.won[k] = t.lost[k] = 0;
+        }
+        t.touched.clear();
+
+        Sample s;
+        s.fairness = max_rate > 0.0 ? 1.0 - (max_rate - min_positive) : 0.0;
+        s.win_rates.resize(groups_);
+        for (size_t g = 0; g < groups_; ++g) {
+            uint64_t total = t.group_won[g] + t.group_lost[g];
+            s.win_rates[g] = total > 0 ? static_cast<double>(t.group_won[g]) / static_cast<double>(total) : 0.0;
+        }
+        s.reduction = 0.0;
+        if (groups_ >= 2 && t.group_won[fastest_] + t.group_lost[fastest_] > 0 &&
+            t.group_won[slowest_] + t.group_lost[slowest_] > 0) {
+            s.reduction = 1.0 - (std::abs(s.win_rates[fastest_] - 0.5) + std::abs(s.win_rates[slowest_] - 0.5)) / 2.0;
+        }
+        std::fill(t.group_won.begin(), t.group_won.end(), 0);
+        std::fill(t.group_lost.begin(), t.group_lost.end(), 0);
+        return s;
+    }
+};
+
+// Percentile interval, interpolating between order statistics
+ConfidenceInterval percentile_interval(std::vector<double> samples, double estimate, double level) {
+    ConfidenceInterval ci;
+    ci.estimate = ci.low = ci.high = estimate;
+    if (samples.empty()) return ci;
+    std::sort(samples.begin(), samples.end());
+    auto quantile = [&](double q) {
+        double pos = q * static_cast<double>(samples.size() - 1);
+        size_t lo = static_cast<size_t>(pos);
+        size_t hi = std::min(lo + 1, samples.size() - 1);
+        return samples[lo] + (pos - static_cast<double>(lo)) * (samples[hi] - samples[lo]);
+    };
+    double tail = (1.0 - level) / 2.0;
+    ci.low = quantile(tail);
+    ci.high = quantile(1.0 - tail);
+    return ci;
+}
+
+} // namespace
+
+BootstrapResult bootstrap_fairness(const BatchOutcomeLog& log, const TraderPopulation& population,
+                                   size_t replicates, double level, uint64_t seed, WorkStealingPool* pool) {
+    BootstrapResult result;
+    result.batches = log.batches();
+    result.level = level;
+    size_t groups = population.report_traders().size();
+    result.win_rates.resize(groups);
+    result.win_rate_samples.resize(groups);
+    if (log.batches() == 0 || replicates == 0) return result;
+
+    Resampler resampler(log, population);
+    Tally tally = resampler.make_tally();
+    Sample estimate = resampler.full(tally);
+
+    std::vector<Sample> samples(replicates);
+    // A few tasks per thread for balance; each keeps one tally across its replicates
+    size_t tasks = pool ? std::min(replicates, (pool->workers() + 1) * 4) : 1;
+    auto run_task = [&](size_t task) {
+        Tally t = resampler.make_tally();
+        for (size_t r = task * replicates / tasks; r < (task + 1) * replicates / tasks; ++r) {
+            samples[r] = resampler.replicate(t, seed, r);
+        }
+    };
+    if (pool) {
+        pool->parallel_for(tasks, run_task);
+    } else {
+        run_task(0);
+    }
+
+    result.replicates = replicates;
+    result.fairness_samples.reserve(replicates);
+    result.reduction_samples.reserve(replicates);
+    for (auto& v : result.win_rate_samples) v.reserve(replicates);
+    for (const auto& s : samples) {
+        result.fairness_samples.push_back(s.fairness);
+        result.reduction_samples.push_back(s.reduction);
+        for (size_t g = 0; g < groups; ++g) result.win_rate_samples[g].push_back(s.win_rates[g]);
+    }
+    result.fairness_index = percentile_interval(result.fairness_samples, estimate.fairness, level);
+    result.latency_advantage_reduction = percentile_interval(result.reduction_samples, estimate.reduction, level);
+    for (size_t g = 0; g < groups; ++g) {
+        result.win_rates[g] = percentile_interval(result.win_rate_samples[g], estimate.win_rates[g], level);
+    }
+    return result;
+}
+
+ConfidenceInterval difference_interval(const std::vector<double>& a, double a_estimate,
+                                       const std::vector<double>& b, double b_estimate, double level) {
+    std::vector<double> diffs;
+    size_t n = std::min(a.size(), b.size());
+    diffs.reserve(n);
+    for (size_t i = 0; i < n; ++i) diffs.push_back(b[i] - a[i]);
+    return percentile_interval(std::move(diffs), b_estimate - a_estimate, level);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class TraderPopulation;
+class WorkStealingPool;
+
+// Competition outcomes batch by batch, the unit a bootstrap resamples.
+// Only batches with at least one competition are kept, as one index into
+// a flat array of (trader, won) pairs: 8 bytes per outcome, 4 per batch.
+class BatchOutcomeLog {
+public:
+    struct Outcome {
+        int trader_id;
+        int won;   // 1 = win, 0 = loss
+    };
+
+    void record(const std::vector<int>& winners, const std::vector<int>& losers);
+    void clear();
+
+    size_t batches() const { return first_.size(); }
+    size_t outcomes() const { return outcomes_.size(); }
+    // Batch b's outcomes are [begin(b), end(b))
+    const Outcome* begin(size_t b) const { return outcomes_.data() + first_[b]; }
+    const Outcome* end(size_t b) const {
+        return outcomes_.data() + (b + 1 < first_.size() ? first_[b + 1] : outcomes_.size());
+    }
+
+private:
+    std::vector<uint32_t> first_;
+    std::vector<Outcome> outcomes_;
+};
+
+struct ConfidenceInterval {
+    double estimate = 0.0;   // on the recorded batches
+    double low = 0.0;
+    double high = 0.0;
+};
+
+struct BootstrapResult {
+    size_t batches = 0;      // contested batches resampled
+    size_t replicates = 0;   // 0 = not computed
+    double level = 0.95;
+    ConfidenceInterval fairness_index;
+    ConfidenceInterval latency_advantage_reduction;
+    std::vector<ConfidenceInterval> win_rates;   // by population.report_traders()
+
+    // Replicate values, kept so two runs' intervals can be differenced
+    std::vector<double> fairness_samples;
+    std::vector<double> reduction_samples;
+    std::vector<std::vector<double>> win_rate_samples;   // [trader][replicate]
+};
+
+// Percentile bootstrap over batches: each replicate draws batches() batches
+// with replacement and recomputes the fairness index over all traders, and
+// the win rates and latency advantage reduction over the population's
+// report traders, as a run's results are. Replicates are split into tasks on
+// `pool` (serial when null), each with its own generator seeded from `seed`
+// and its task number, so results do not depend on the thread count.
+BootstrapResult bootstrap_fairness(const BatchOutcomeLog& log, const TraderPopulation& population,
+                                   size_t replicates, double level, uint64_t seed, WorkStealingPool* pool);
+
+// Interval of b - a from paired replicates of two independent runs
+ConfidenceInterval difference_interval(const std::vector<double>& a, double a_estimate,
+                                       const std::vector<double>& b, double b_estimate, double level);
@@ -3,92 +3,272 @@
 #include <iomanip>
 #include <sstream>
 #include <cmath>
+#include <thread>
 
-FairnessMetrics::FairnessMetrics() {}
+namespace {
+
+// Single writer: a plain load/store pair, no read-modify-write needed
+inline void bump(std::atomic<uint64_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+FairnessMetrics::FairnessMetrics()
+    : block_count_(0), trade_count_(0), seq_(0), update_depth_(0), indices_dirty_(false), keep_history_(true) {
+    for (auto& b : blocks_) b.store(nullptr, std::memory_order_relaxed);
+}
+
+FairnessMetrics::FairnessMetrics(const FairnessMetrics& other) : FairnessMetrics() {
+    assign(other);
+}
+
+FairnessMetrics& FairnessMetrics::operator=(const FairnessMetrics& other) {
+    if (this != &other) assign(other);
+    return *this;
+}
+
+FairnessMetrics::~FairnessMetrics() {
+    for (auto& b : blocks_) delete[] b.load(std::memory_order_relaxed);
+}
+
+void FairnessMetrics::assign(const FairnessMetrics& other) {
+    MetricsSnapshot snap = other.snapshot();
+    UpdateScope scope(*this);
+    reset();
+    for (const auto& t : snap.traders) {
+        Counters* c = counters_for(t.trader_id);
+        c->orders_submitted.store(t.orders_submitted, std::memory_order_relaxed);
+        c->orders_executed.store(t.orders_executed, std::memory_order_relaxed);
+        c->trades_won.store(t.trades_won, std::memory_order_relaxed);
+        c->trades_lost.store(t.trades_lost, std::memory_order_relaxed);
+        win_rates_.update(static_cast<size_t>(t.trader_id), t.trades_won, t.trades_lost);
+    }
+    indices_dirty_ = true;
+    trade_count_.store(snap.trade_count, std::memory_order_relaxed);
+    trade_history_ = other.trade_history_;
+    keep_history_ = other.keep_history_;
+}
+
+void FairnessMetrics::begin_update() {
+    if (update_depth_++ > 0) return;
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void FairnessMetrics::end_update() {
+    if (--update_depth_ > 0) return;
+    if (indices_dirty_) publish_indices();
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void FairnessMetrics::publish_indices() {
+    FairnessIndices idx = win_rates_.indices();
+    published_.competitors.store(idx.competitors, std::memory_order_relaxed);
+    published_.jain.store(idx.jain, std::memory_order_relaxed);
+    published_.gini.store(idx.gini, std::memory_order_relaxed);
+    published_.min_win_rate.store(idx.min_win_rate, std::memory_order_relaxed);
+    published_.max_win_rate.store(idx.max_win_rate, std::memory_order_relaxed);
+    published_.spread_index.store(idx.spread_index, std::memory_order_relaxed);
+    indices_dirty_ = false;
+}
+
+// Caller validates against seq_
+FairnessIndices FairnessMetrics::read_indices() const {
+    FairnessIndices idx;
+    idx.competitors = published_.competitors.load(std::memory_order_relaxed);
+    idx.jain = published_.jain.load(std::memory_order_relaxed);
+    idx.gini = published_.gini.load(std::memory_order_relaxed);
+    idx.min_win_rate = published_.min_win_rate.load(std::memory_order_relaxed);
+    idx.max_win_rate = published_.max_win_rate.load(std::memory_order_relaxed);
+    idx.spread_index = published_.spread_index.load(std::memory_order_relaxed);
+    return idx;
+}
+
+FairnessIndices FairnessMetrics::indices() const {
+    while (true) {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        FairnessIndices idx = read_indices();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == before) return idx;
+    }
+}
+
+FairnessMetrics::Counters* FairnessMetrics::counters_for(int trader_id) {
+    if (trader_id < 0 || static_cast<size_t>(trader_id) >= kMaxTraders) return nullptr;
+    size_t b = static_cast<size_t>(trader_id) / kBlockTraders;
+    Counters* block = blocks_[b].load(std::memory_order_relaxed);
+    if (!block) {
+        block = new Counters[kBlockTraders];
+        blocks_[b].store(block, std::memory_order_release);
+        if (b >= block_count_.load(std::memory_order_relaxed)) {
+            block_count_.store(b + 1, std::memory_order_release);
+        }
+    }
+    return &block[static_cast<size_t>(trader_id) % kBlockTraders];
+}
+
+// One pass over the counters; false if an update overlapped it
+bool FairnessMetrics::try_copy(MetricsSnapshot& snap) const {
+    uint64_t before = seq_.load(std::memory_order_acquire);
+    if (before & 1) return false;
+    snap.traders.clear();
+    snap.trade_count = trade_count_.load(std::memory_order_relaxed);
+    snap.indices = read_indices();
+    size_t blocks = block_count_.load(std::memory_order_acquire);
+    for (size_t b = 0; b < blocks; ++b) {
+        const Counters* block = blocks_[b].load(std::memory_order_acquire);
+        if (!block) continue;
+        for (size_t i = 0; i < kBlockTraders; ++i) {
+            TraderTally t{static_cast<int>(b * kBlockTraders + i),
+                          block[i].orders_submitted.load(std::memory_order_relaxed),
+                          block[i].orders_executed.load(std::memory_order_relaxed),
+                          block[i].trades_won.load(std::memory_order_relaxed),
+                          block[i].trades_lost.load(std::memory_order_relaxed)};
+            if (t.orders_submitted | t.orders_executed | t.trades_won | t.trades_lost) {
+                snap.traders.push_back(t);
+            }
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_.load(std::memory_order_relaxed) != before) return false;
+    snap.sequence = before / 2;
+    return true;
+}
+
+MetricsSnapshot FairnessMetrics::snapshot() const {
+    MetricsSnapshot snap;
+    for (int attempt = 0; ; ++attempt) {
+        if (try_copy(snap)) break;
+        // Updates keep landing mid-copy (many traders, a busy writer): settle
+        // for the last consistent copy rather than make the writer wait
+        if (attempt + 1 >= kSnapshotRetries) {
+            std::lock_guard<std::mutex> lock(last_mutex_);
+            if (last_.sequence > 0) {
+                MetricsSnapshot stale = last_;
+                stale.stale = true;
+                return stale;
+            }
+        }
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(last_mutex_);
+    if (snap.sequence >= last_.sequence) last_ = snap;
+    return snap;
+}
 
 void FairnessMetrics::record_trade(const Trade& trade, bool was_collision) {
-    trade_history_.push_back({
-        trade.buy_trader_id,
-        trade.sell_trader_id,
-        trade.price,
-        trade.qty,
-        trade.execution_time,
-        was_collision
-    });
+    UpdateScope scope(*this);
+    bump(trade_count_);
+    if (keep_history_) {
+        trade_history_.push_back({
+            trade.buy_trader_id,
+            trade.sell_trader_id,
+            trade.price,
+            trade.qty,
+            trade.execution_time,
+            was_collision
+        });
+    }
     
     record_order_execution(trade.buy_trader_id);
     record_order_execution(trade.sell_trader_id);
 }
 
 void FairnessMetrics::record_order_submission(int trader_id) {
-    trader_orders_submitted_[trader_id]++;
+    UpdateScope scope(*this);
+    if (Counters* c = counters_for(trader_id)) bump(c->orders_submitted);
 }
 
 void FairnessMetrics::record_order_execution(int trader_id) {
-    trader_orders_executed_[trader_id]++;
+    UpdateScope scope(*this);
+    if (Counters* c = counters_for(trader_id)) bump(c->orders_executed);
 }
 
 void FairnessMetrics::record_trade_win(int trader_id) {
-    trader_trades_won_[trader_id]++;
+    UpdateScope scope(*this);
+    if (Counters* c = counters_for(trader_id)) {
+        bump(c->trades_won);
+        win_rates_.update(static_cast<size_t>(trader_id), c->trades_won.load(std::memory_order_relaxed),
+                          c->trades_lost.load(std::memory_order_relaxed));
+        indices_dirty_ = true;
+    }
 }
 
 void FairnessMetrics::record_trade_loss(int trader_id) {
-    trader_trades_lost_[trader_id]++;
+    UpdateScope scope(*this);
+    if (Counters* c = counters_for(trader_id)) {
+        bump(c->trades_lost);
+        win_rates_.update(static_cast<size_t>(trader_id), c->trades_won.load(std::memory_order_relaxed),
+                          c->trades_lost.load(std::memory_order_relaxed));
+        indices_dirty_ = true;
+    }
 }
 
 void FairnessMetrics::reset() {
-    trader_orders_submitted_.clear();
-    trader_orders_executed_.clear();
-    trader_trades_won_.clear();
-    trader_trades_lost_.clear();
+    // Blocks stay allocated: a concurrent reader may be walking them
+    UpdateScope scope(*this);
+    size_t blocks = block_count_.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < blocks; ++b) {
+        Counters* block = blocks_[b].load(std::memory_order_relaxed);
+        if (!block) continue;
+        for (size_t i = 0; i < kBlockTraders; ++i) {
+            block[i].orders_submitted.store(0, std::memory_order_relaxed);
+            block[i].orders_executed.store(0, std::memory_order_relaxed);
+            block[i].trades_won.store(0, std::memory_order_relaxed);
+            block[i].trades_lost.store(0, std::memory_order_relaxed);
+        }
+    }
     trade_history_.clear();
+    trade_count_.store(0, std::memory_order_relaxed);
+    win_rates_.clear();
+    indices_dirty_ = true;
 }
 
 double FairnessMetrics::compute_fairness_index() const {
-    if (trader_trades_won_.empty()) return 0.0;
-    
-    // Find min and max win rates
-    double min_win_rate = 1.0;
-    double max_win_rate = 0.0;
-    
-    for (const auto& [trader_id, wins] : trader_trades_won_) {
-        int lost = trader_trades_lost_.count(trader_id) > 0 ? trader_trades_lost_.at(trader_id) : 0;
-        int total = wins + lost;
-        if (total > 0) {
-            double win_rate = static_cast<double>(wins) / total;
-            min_win_rate = std::min(min_win_rate, win_rate);
-            max_win_rate = std::max(max_win_rate, win_rate);
-        }
-    }
-    
-    // Fairness index: 1 - |max_win_rate - min_win_rate|
-    return 1.0 - (max_win_rate - min_win_rate);
+    return snapshot().fairness_index();
 }
 
 double FairnessMetrics::compute_latency_advantage_reduction(const std::vector<Trader>& traders) const {
-    if (traders.size() < 2) return 0.0;
+    return snapshot().latency_advantage_reduction(traders);
+}
+
+std::vector<TraderStats> FairnessMetrics::get_trader_stats(const std::vector<Trader>& traders) const {
+    return snapshot().trader_stats(traders);
+}
+
+const TraderTally* MetricsSnapshot::find(int trader_id) const {
+    auto it = std::lower_bound(traders.begin(), traders.end(), trader_id,
+        [](const TraderTally& t, int id) { return t.trader_id < id; });
+    return it != traders.end() && it->trader_id == trader_id ? &*it : nullptr;
+}
+
+double MetricsSnapshot::latency_advantage_reduction(const std::vector<Trader>& trader_list) const {
+    if (trader_list.size() < 2) return 0.0;
     
     // Find fastest and slowest traders
-    auto fastest = std::min_element(traders.begin(), traders.end(),
+    auto fastest = std::min_element(trader_list.begin(), trader_list.end(),
         [](const Trader& a, const Trader& b) {
             return a.artificial_latency_ns < b.artificial_latency_ns;
         });
-    auto slowest = std::max_element(traders.begin(), traders.end(),
+    auto slowest = std::max_element(trader_list.begin(), trader_list.end(),
         [](const Trader& a, const Trader& b) {
             return a.artificial_latency_ns < b.artificial_latency_ns;
         });
     
-    int fast_wins = trader_trades_won_.count(fastest->id) > 0 ? trader_trades_won_.at(fastest->id) : 0;
-    int slow_wins = trader_trades_won_.count(slowest->id) > 0 ? trader_trades_won_.at(slowest->id) : 0;
-    int fast_lost = trader_trades_lost_.count(fastest->id) > 0 ? trader_trades_lost_.at(fastest->id) : 0;
-    int slow_lost = trader_trades_lost_.count(slowest->id) > 0 ? trader_trades_lost_.at(slowest->id) : 0;
-    int fast_total = fast_wins + fast_lost;
-    int slow_total = slow_wins + slow_lost;
+    const TraderTally* fast = find(fastest->id);
+    const TraderTally* slow = find(slowest->id);
+    uint64_t fast_total = fast ? fast->trades_won + fast->trades_lost : 0;
+    uint64_t slow_total = slow ? slow->trades_won + slow->trades_lost : 0;
     
     if (fast_total == 0 || slow_total == 0) return 0.0;
     
-    double fast_win_rate = static_cast<double>(fast_wins) / fast_total;
-    double slow_win_rate = static_cast<double>(slow_wins) / slow_total;
+    double fast_win_rate = static_cast<double>(fast->trades_won) / fast_total;
+    double slow_win_rate = static_cast<double>(slow->trades_won) / slow_total;
     
     // In a perfectly fair system, both should have ~50% win rate
     // Reduction = how close we are to 50/50
@@ -100,17 +280,18 @@ double FairnessMetrics::compute_latency_advantage_reduction(const std::vector<Tr
     return 1.0 - ((fast_deviation + slow_deviation) / 2.0);
 }
 
-std::vector<TraderStats> FairnessMetrics::get_trader_stats(const std::vector<Trader>& traders) const {
+std::vector<TraderStats> MetricsSnapshot::trader_stats(const std::vector<Trader>& trader_list) const {
     std::vector<TraderStats> stats;
     
-    for (const auto& trader : traders) {
+    for (const auto& trader : trader_list) {
         TraderStats s;
+        const TraderTally* t = find(trader.id);
         s.trader_id = trader.id;
         s.name = trader.name;
-        s.orders_submitted = trader_orders_submitted_.count(trader.id) > 0 ? trader_orders_submitted_.at(trader.id) : 0;
-        s.orders_executed = trader_orders_executed_.count(trader.id) > 0 ? trader_orders_executed_.at(trader.id) : 0;
-        s.trades_won = trader_trades_won_.count(trader.id) > 0 ? trader_trades_won_.at(trader.id) : 0;
-        s.trades_lost = trader_trades_lost_.count(trader.id) > 0 ? trader_trades_lost_.at(trader.id) : 0;
+        s.orders_submitted = t ? static_cast<int>(t->orders_submitted) : 0;
+        s.orders_executed = t ? static_cast<int>(t->orders_executed) : 0;
+        s.trades_won = t ? static_cast<int>(t->trades_won) : 0;
+        s.trades_lost = t ? static_cast<int>(t->trades_lost) : 0;
         
         int total_trades = s.trades_won + s.trades_lost;
         s.win_rate = (total_trades > 0) ? static_cast<double>(s.trades_won) / total_trades : 0.0;
@@ -124,49 +305,43 @@ std::vector<TraderStats> FairnessMetrics::get_trader_stats(const std::vector<Tra
     return stats;
 }
 
-double FairnessMetrics::compute_win_rate_imbalance() const {
-    if (trader_trades_won_.empty()) return 1.0;
-    
-    std::vector<double> win_rates;
-    for (const auto& [trader_id, wins] : trader_trades_won_) {
-        int lost = trader_trades_lost_.count(trader_id) > 0 ? trader_trades_lost_.at(trader_id) : 0;
-        int total = wins + lost;
-        if (total > 0) {
-            win_rates.push_back(static_cast<double>(wins) / total);
-        }
-    }
-    
-    if (win_rates.empty()) return 1.0;
-    
-    double min_rate = *std::min_element(win_rates.begin(), win_rates.end());
-    double max_rate = *std::max_element(win_rates.begin(), win_rates.end());
-    
-    return max_rate - min_rate;
+std::string FairnessMetrics::get_summary(const std::vector<Trader>& traders) const {
+    return format_summary(snapshot(), traders);
 }
 
-std::string FairnessMetrics::get_summary(const std::vector<Trader>& traders) const {
+std::string FairnessMetrics::format_summary(const MetricsSnapshot& snap, const std::vector<Trader>& traders) {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
     
-    double fairness = compute_fairness_index();
-    double reduction = compute_latency_advantage_reduction(traders);
+    double fairness = snap.fairness_index();
+    double reduction = snap.latency_advantage_reduction(traders);
+    const FairnessIndices& idx = snap.indices;
     
     oss << "\n========================================\n";
     oss << "      FAIRNESS METRICS SUMMARY         \n";
     oss << "----------------------------------------\n";
+    if (snap.stale) oss << " (as of an earlier update: the engine is busy)\n";
     oss << " Fairness Index:      " << std::setw(6) << fairness << "        \n";
     oss << " Latency Advantage    " << std::setw(6) << (reduction * 100) << "%        \n";
     oss << " Reduction:                              \n";
+    oss << " Jain's Index:        " << std::setw(6) << idx.jain << "        \n";
+    oss << " Gini Coefficient:    " << std::setw(6) << idx.gini << "        \n";
+    oss << " Min / Max Win Rate:  " << std::setw(6) << (idx.min_win_rate * 100) << "% / "
+        << (idx.max_win_rate * 100) << "%\n";
     oss << "========================================\n";
     
     return oss.str();
 }
 
 std::string FairnessMetrics::get_detailed_report(const std::vector<Trader>& traders) const {
+    return format_detailed_report(snapshot(), traders);
+}
+
+std::string FairnessMetrics::format_detailed_report(const MetricsSnapshot& snap, const std::vector<Trader>& traders) {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
     
-    auto stats = get_trader_stats(traders);
+    auto stats = snap.trader_stats(traders);
     
     oss << "\n====================================================================\n";
     oss << "                    DETAILED TRADER STATISTICS                   \n";
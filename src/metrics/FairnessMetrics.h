@@ -1,10 +1,14 @@
 #pragma once
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <string>
 #include "simulation/Trader.h"
 #include "book/OrderBook.h"
+#include "metrics/WinRateIndex.h"
 
 struct TradeRecord {
     int buy_trader_id;
@@ -27,9 +31,66 @@ struct TraderStats {
     TimeNs total_latency_ns;
 };
 
+// Per-trader counters as read from a snapshot
+struct TraderTally {
+    int trader_id;
+    uint64_t orders_submitted;
+    uint64_t orders_executed;
+    uint64_t trades_won;
+    uint64_t trades_lost;
+};
+
+// Consistent copy of the live counters; all derived figures come from here
+struct MetricsSnapshot {
+    uint64_t sequence = 0;              // completed writer updates
+    bool stale = false;                 // an earlier copy: updates kept overlapping the read
+    uint64_t trade_count = 0;
+    std::vector<TraderTally> traders;   // ascending id, active traders only
+    FairnessIndices indices;
+    
+    const TraderTally* find(int trader_id) const;
+    double fairness_index() const { return indices.spread_index; }
+    double latency_advantage_reduction(const std::vector<Trader>& traders) const;
+    std::vector<TraderStats> trader_stats(const std::vector<Trader>& traders) const;
+};
+
+// Counters are written by the engine's thread only and published through a
+// seqlock: snapshot() may be called from any thread while matching runs and
+// retries until it has copied a state that no update overlapped. After a
+// few failed tries it returns the last consistent copy any reader made,
+// marked stale, so the writer never waits on a reader. Trader
+// counters live in fixed blocks that never move, so a reader never follows
+// a stale pointer. Trader ids outside [0, kMaxTraders) are not tallied.
+//
+// The fairness indices are kept up to date by a WinRateIndex on every win or
+// loss and published with the outermost update, so indices() is a constant
+// time read that can be polled per batch.
 class FairnessMetrics {
 public:
+    static constexpr size_t kBlockTraders = 1024;
+    static constexpr size_t kMaxBlocks = 4096;
+    static constexpr size_t kMaxTraders = kBlockTraders * kMaxBlocks;
+    
     FairnessMetrics();
+    FairnessMetrics(const FairnessMetrics& other);
+    FairnessMetrics& operator=(const FairnessMetrics& other);
+    ~FairnessMetrics();
+    
+    // Makes every update in its lifetime visible to readers at once. Nests;
+    // without one each record_* call is published on its own.
+    class UpdateScope {
+    public:
+        explicit UpdateScope(FairnessMetrics& metrics) : metrics_(metrics) { metrics_.begin_update(); }
+        ~UpdateScope() { metrics_.end_update(); }
+        UpdateScope(const UpdateScope&) = delete;
+        UpdateScope& operator=(const UpdateScope&) = delete;
+    private:
+        FairnessMetrics& metrics_;
+    };
+    
+    // Safe from any thread
+    MetricsSnapshot snapshot() const;
+    FairnessIndices indices() const;
     
     void record_trade(const Trade& trade, bool was_collision = false);
     void record_order_submission(int trader_id);
@@ -44,6 +105,11 @@ public:
     // Generate statistics
     std::vector<TraderStats> get_trader_stats(const std::vector<Trader>& traders) const;
     
+    size_t get_trade_count() const { return trade_count_.load(std::memory_order_relaxed); }
+    
+    // Keep per-trade records in memory (off when trades go to an archive)
+    void set_keep_history(bool keep) { keep_history_ = keep; }
+    
     // Reset all metrics
     void reset();
     
@@ -52,14 +118,48 @@ public:
     
     // Get detailed report
     std::string get_detailed_report(const std::vector<Trader>& traders) const;
+    
+    // The same two reports from one snapshot, so they agree with each other
+    static std::string format_summary(const MetricsSnapshot& snap, const std::vector<Trader>& traders);
+    static std::string format_detailed_report(const MetricsSnapshot& snap, const std::vector<Trader>& traders);
 
 private:
-    std::map<int, int> trader_orders_submitted_;
-    std::map<int, int> trader_orders_executed_;
-    std::map<int, int> trader_trades_won_;
-    std::map<int, int> trader_trades_lost_;
-    std::vector<TradeRecord> trade_history_;
+    struct Counters {
+        std::atomic<uint64_t> orders_submitted{0};
+        std::atomic<uint64_t> orders_executed{0};
+        std::atomic<uint64_t> trades_won{0};
+        std::atomic<uint64_t> trades_lost{0};
+    };
+    
+    std::array<std::atomic<Counters*>, kMaxBlocks> blocks_;
+    std::atomic<size_t> block_count_;     // blocks [0, block_count_) may be set
+    std::atomic<uint64_t> trade_count_;
+    std::atomic<uint64_t> seq_;           // odd while an update is in progress
+    int update_depth_;
+    static constexpr int kSnapshotRetries = 4;
+    mutable MetricsSnapshot last_;        // newest consistent copy, readers only
+    mutable std::mutex last_mutex_;
+    
+    struct PublishedIndices {
+        std::atomic<uint64_t> competitors{0};
+        std::atomic<double> jain{0.0};
+        std::atomic<double> gini{0.0};
+        std::atomic<double> min_win_rate{0.0};
+        std::atomic<double> max_win_rate{0.0};
+        std::atomic<double> spread_index{0.0};
+    };
+    WinRateIndex win_rates_;              // writer thread only
+    bool indices_dirty_;
+    PublishedIndices published_;
+    std::vector<TradeRecord> trade_history_;   // writer thread only
+    bool keep_history_;
     
-    double compute_win_rate_imbalance() const;
+    void begin_update();
+    void end_update();
+    void publish_indices();
+    FairnessIndices read_indices() const;
+    bool try_copy(MetricsSnapshot& snap) const;
+    Counters* counters_for(int trader_id);
+    void assign(const FairnessMetrics& other);
 };
 
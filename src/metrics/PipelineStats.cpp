@@ -0,0 +1,242 @@
+#include "metrics/PipelineStats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#ifndef FAIRORDER_MINIMAL
+
+namespace {
+
+// Bump a counter that only the owning thread writes
+inline void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void raise_to(std::atomic<uint64_t>& counter, uint64_t value) {
+    if (value > counter.load(std::memory_order_relaxed)) {
+        counter.store(value, std::memory_order_relaxed);
+    }
+}
+
+struct alignas(64) StageCounter {
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> calls{0};
+};
+
+struct ThreadStats {
+    StageCounter stages[kStageCount];
+    alignas(64) std::atomic<uint64_t> batch_sizes[kBatchSizeBuckets] = {};
+    alignas(64) std::atomic<uint64_t> max_buy_depth{0};
+    std::atomic<uint64_t> max_sell_depth{0};
+    std::atomic<uint64_t> discarded_orders{0};
+    std::atomic<uint64_t> discarded_qty{0};
+    std::atomic<uint64_t> fok_kills{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+// Blocks outlive their threads so totals survive thread exit
+std::mutex& registry_mutex() {
+    static std::mutex m;
+    return m;
+}
+
+std::vector<std::unique_ptr<ThreadStats>>& registry() {
+    static std::vector<std::unique_ptr<ThreadStats>> blocks;
+    return blocks;
+}
+
+// Plain pointer (no TLS init guard) so operator new can test it cheaply
+thread_local ThreadStats* tls_stats = nullptr;
+
+ThreadStats& local() {
+    if (!tls_stats) {
+        auto block = std::make_unique<ThreadStats>();
+        ThreadStats* raw = block.get();
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            registry().push_back(std::move(block));
+        }
+        tls_stats = raw;
+    }
+    return *tls_stats;
+}
+
+size_t batch_bucket(size_t size) {
+    size_t bucket = 0;
+    while (size > 1 && bucket + 1 < kBatchSizeBuckets) {
+        size >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+// Count heap allocations made by instrumented threads
+void* operator new(std::size_t size) {
+    if (tls_stats) bump(tls_stats->allocations, 1);
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void PipelineStats::add_stage(Stage stage, uint64_t ticks, uint64_t events) {
+    auto& c = local().stages[static_cast<size_t>(stage)];
+    bump(c.ticks, ticks);
+    bump(c.events, events);
+    bump(c.calls, 1);
+}
+
+void PipelineStats::record_batch_size(size_t size) {
+    bump(local().batch_sizes[batch_bucket(size)], 1);
+}
+
+void PipelineStats::record_book_depth(size_t buy_depth, size_t sell_depth) {
+    auto& s = local();
+    raise_to(s.max_buy_depth, buy_depth);
+    raise_to(s.max_sell_depth, sell_depth);
+}
+
+void PipelineStats::record_discard(Qty qty, bool fok_kill) {
+    auto& s = local();
+    bump(s.discarded_orders, 1);
+    bump(s.discarded_qty, static_cast<uint64_t>(qty));
+    if (fok_kill) bump(s.fok_kills, 1);
+}
+
+PipelineStatsSnapshot PipelineStats::snapshot() {
+    PipelineStatsSnapshot snap;
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (const auto& block : registry()) {
+        for (size_t i = 0; i < kStageCount; ++i) {
+            snap.stages[i].ticks += block->stages[i].ticks.load(std::memory_order_relaxed);
+            snap.stages[i].events += block->stages[i].events.load(std::memory_order_relaxed);
+            snap.stages[i].calls += block->stages[i].calls.load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < kBatchSizeBuckets; ++i) {
+            snap.batch_sizes[i] += block->batch_sizes[i].load(std::memory_order_relaxed);
+        }
+        snap.max_buy_depth = std::max<uint64_t>(snap.max_buy_depth, block->max_buy_depth.load(std::memory_order_relaxed));
+        snap.max_sell_depth = std::max<uint64_t>(snap.max_sell_depth, block->max_sell_depth.load(std::memory_order_relaxed));
+        snap.discarded_orders += block->discarded_orders.load(std::memory_order_relaxed);
+        snap.discarded_qty += block->discarded_qty.load(std::memory_order_relaxed);
+        snap.fok_kills += block->fok_kills.load(std::memory_order_relaxed);
+        snap.allocations += block->allocations.load(std::memory_order_relaxed);
+    }
+    snap.threads = registry().size();
+    return snap;
+}
+
+void PipelineStats::reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (auto& block : registry()) {
+        for (auto& c : block->stages) {
+            c.ticks.store(0, std::memory_order_relaxed);
+            c.events.store(0, std::memory_order_relaxed);
+            c.calls.store(0, std::memory_order_relaxed);
+        }
+        for (auto& b : block->batch_sizes) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        block->max_buy_depth.store(0, std::memory_order_relaxed);
+        block->max_sell_depth.store(0, std::memory_order_relaxed);
+        block->discarded_orders.store(0, std::memory_order_relaxed);
+        block->discarded_qty.store(0, std::memory_order_relaxed);
+        block->fok_kills.store(0, std::memory_order_relaxed);
+        block->allocations.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool PipelineStats::enabled() {
+    return true;
+}
+
+#else
+
+PipelineStatsSnapshot PipelineStats::snapshot() {
+    return {};
+}
+
+void PipelineStats::reset() {}
+
+bool PipelineStats::enabled() {
+    return false;
+}
+
+#endif
+
+const char* PipelineStats::stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::SUBMIT:     return "submit";
+        case Stage::POP_BATCH:  return "pop_batch";
+        case Stage::SCREEN:     return "screen";
+        case Stage::BATCH_SORT: return "batch sort";
+        case Stage::MATCH:      return "match";
+        case Stage::METRICS:    return "metrics";
+        default:                return "?";
+    }
+}
+
+std::string PipelineStats::format(const PipelineStatsSnapshot& snap) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+
+    oss << "\n====================================================================\n";
+    oss << "                    PIPELINE STATISTICS                            \n";
+    oss << "--------------------------------------------------------------------\n";
+    if (!enabled()) {
+        oss << " Instrumentation compiled out (FAIRORDER_MINIMAL build)\n";
+        oss << "====================================================================\n";
+        return oss.str();
+    }
+
+    double ns_per_tick = TscClock::ns_per_tick();
+    oss << " Stage          |     Calls |     Events |   ns/event |   Total ms\n";
+    oss << "--------------------------------------------------------------------\n";
+    for (size_t i = 0; i < kStageCount; ++i) {
+        const auto& s = snap.stages[i];
+        double total_ns = static_cast<double>(s.ticks) * ns_per_tick;
+        double per_event = s.events > 0 ? total_ns / static_cast<double>(s.events) : 0.0;
+        oss << " " << std::setw(14) << std::left << stage_name(static_cast<Stage>(i)) << std::right
+            << " | " << std::setw(9) << s.calls
+            << " | " << std::setw(10) << s.events
+            << " | " << std::setw(10) << per_event
+            << " | " << std::setw(10) << (total_ns / 1e6) << "\n";
+    }
+
+    oss << "--------------------------------------------------------------------\n";
+    oss << " Batch size distribution:\n";
+    for (size_t i = 0; i < kBatchSizeBuckets; ++i) {
+        if (snap.batch_sizes[i] == 0) continue;
+        size_t lo = size_t(1) << i;
+        std::string range = (i + 1 == kBatchSizeBuckets)
+            ? std::to_string(lo) + "+"
+            : (lo == 1 ? std::string("1") : std::to_string(lo) + "-" + std::to_string((lo << 1) - 1));
+        oss << "   " << std::setw(14) << std::left << range << std::right
+            << " : " << snap.batch_sizes[i] << "\n";
+    }
+
+    oss << "--------------------------------------------------------------------\n";
+    oss << " Book depth high-water:  buy " << snap.max_buy_depth
+        << " / sell " << snap.max_sell_depth << "\n";
+    oss << " Discarded remainders:   " << snap.discarded_orders << " orders / "
+        << snap.discarded_qty << " qty (" << snap.fok_kills << " FOK kills)\n";
+    oss << " Heap allocations:       " << snap.allocations << "\n";
+    oss << " Instrumented threads:   " << snap.threads << "\n";
+    oss << "====================================================================\n";
+    return oss.str();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include "core/Types.h"
+#include "core/Clock.h"
+
+// Hot-path instrumentation: per-stage cycle and event counters, batch-size
+// histogram, book depth high-water marks, discarded IOC/FOK/market
+// remainders and heap allocation counts.
+//
+// Each thread writes to its own cache-line-aligned block (single writer,
+// relaxed atomics, no lock prefix), and snapshot() sums the blocks of all
+// threads. Defining FAIRORDER_MINIMAL compiles all of it down to no-ops.
+
+enum class Stage : uint8_t {
+    SUBMIT,      // MicroBatcher::submit
+    POP_BATCH,   // MicroBatcher::pop_batch
+    SCREEN,      // column copy and marketability screen in OrderBook::process_batch
+    BATCH_SORT,  // priority sort of the marketable orders
+    MATCH,       // matching and resting in OrderBook
+    METRICS,     // FairnessMetrics updates in MatchingEngine
+    COUNT
+};
+
+constexpr size_t kStageCount = static_cast<size_t>(Stage::COUNT);
+constexpr size_t kBatchSizeBuckets = 21;  // power-of-two buckets: 1, 2-3, 4-7, ..., 2^20+
+
+struct StageTotals {
+    uint64_t ticks = 0;
+    uint64_t events = 0;
+    uint64_t calls = 0;
+};
+
+struct PipelineStatsSnapshot {
+    std::array<StageTotals, kStageCount> stages{};
+    std::array<uint64_t, kBatchSizeBuckets> batch_sizes{};
+    uint64_t max_buy_depth = 0;
+    uint64_t max_sell_depth = 0;
+    uint64_t discarded_orders = 0;   // non-resting orders with an unfilled remainder
+    uint64_t discarded_qty = 0;
+    uint64_t fok_kills = 0;          // FOK orders not executed at all
+    uint64_t allocations = 0;
+    size_t threads = 0;
+};
+
+class PipelineStats {
+public:
+    static void add_stage(Stage stage, uint64_t ticks, uint64_t events);
+    static void record_batch_size(size_t size);
+    static void record_book_depth(size_t buy_depth, size_t sell_depth);
+    static void record_discard(Qty qty, bool fok_kill);
+
+    static PipelineStatsSnapshot snapshot();
+    static void reset();
+    static bool enabled();
+
+    static const char* stage_name(Stage stage);
+    static std::string format(const PipelineStatsSnapshot& snap);
+};
+
+// Scoped timer for one pass through a stage
+class StageTimer {
+public:
+#ifndef FAIRORDER_MINIMAL
+    StageTimer(Stage stage, uint64_t events)
+        : stage_(stage), events_(events), start_(TscClock::ticks()) {}
+    ~StageTimer() { PipelineStats::add_stage(stage_, TscClock::ticks() - start_, events_); }
+    void set_events(uint64_t events) { events_ = events; }
+
+private:
+    Stage stage_;
+    uint64_t events_;
+    uint64_t start_;
+#else
+    StageTimer(Stage, uint64_t) {}
+    void set_events(uint64_t) {}
+#endif
+};
+
+#ifdef FAIRORDER_MINIMAL
+inline void PipelineStats::add_stage(Stage, uint64_t, uint64_t) {}
+inline void PipelineStats::record_batch_size(size_t) {}
+inline void PipelineStats::record_book_depth(size_t, size_t) {}
+inline void PipelineStats::record_discard(Qty, bool) {}
+#endif
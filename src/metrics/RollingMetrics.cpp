@@ -0,0 +1,260 @@
+#include "metrics/RollingMetrics.h"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+double WindowBucket::spread_index() const {
+    double min_rate = 1.0, max_rate = 0.0;
+    bool any = false;
+    for (const auto& t : traders) {
+        if (t.wins == 0) continue;
+        any = true;
+        double rate = static_cast<double>(t.wins) / static_cast<double>(t.wins + t.losses);
+        min_rate = std::min(min_rate, rate);
+        max_rate = std::max(max_rate, rate);
+    }
+    return any ? 1.0 - (max_rate - min_rate) : 0.0;
+}
+
+double WindowBucket::jain() const {
+    double n = 0, sum = 0, sum_sq = 0;
+    for (const auto& t : traders) {
+        if (t.wins + t.losses == 0) continue;
+        double rate = static_cast<double>(t.wins) / static_cast<double>(t.wins + t.losses);
+        n += 1;
+        sum += rate;
+        sum_sq += rate * rate;
+    }
+    return sum_sq > 0 ? sum * sum / (n * sum_sq) : 0.0;
+}
+
+namespace {
+
+// Single writer: a plain load/store pair, no read-modify-write needed
+template <typename T>
+inline void add_to(std::atomic<T>& c, T v) {
+    c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void begin_write(std::atomic<uint64_t>& seq) {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void end_write(std::atomic<uint64_t>& seq) {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+} // namespace
+
+RollingMetrics::RollingMetrics(const RollingConfig& config) : enabled_(true) {
+    configure(config);
+}
+
+void RollingMetrics::configure(const RollingConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.interval_ns = std::max<TimeNs>(1, config_.interval_ns);
+    config_.batches_per_bucket = std::max<uint64_t>(1, config_.batches_per_bucket);
+    size_t slots = 4;
+    while (slots < config_.trader_slots) slots <<= 1;
+    config_.trader_slots = slots;
+    init_ring(by_time_, std::max<size_t>(1, config_.time_buckets));
+    init_ring(by_batch_, std::max<size_t>(1, config_.batch_buckets));
+}
+
+void RollingMetrics::clear() {
+    configure(RollingConfig(config_));
+}
+
+void RollingMetrics::init_ring(Ring& ring, size_t buckets) {
+    ring.slots.reset(new Slot[buckets]);
+    ring.size = buckets;
+    for (size_t i = 0; i < buckets; ++i) {
+        ring.slots[i].tallies.reset(new Tally[config_.trader_slots + 1]);
+    }
+    ring.seq.store(0, std::memory_order_relaxed);
+    ring.head.store(0, std::memory_order_relaxed);
+    ring.used.store(0, std::memory_order_relaxed);
+    ring.position = 0;
+}
+
+void RollingMetrics::clear_slot(Slot& s) {
+    auto reset = [](Tally& t) {
+        t.trader_id.store(kNoTrader, std::memory_order_relaxed);
+        t.wins.store(0, std::memory_order_relaxed);
+        t.losses.store(0, std::memory_order_relaxed);
+        t.fills.store(0, std::memory_order_relaxed);
+        t.volume.store(0, std::memory_order_relaxed);
+    };
+    for (uint32_t i : s.touched) reset(s.tallies[i]);
+    s.touched.clear();
+    reset(s.tallies[config_.trader_slots]);
+    s.batches.store(0, std::memory_order_relaxed);
+    s.orders.store(0, std::memory_order_relaxed);
+    s.trades.store(0, std::memory_order_relaxed);
+    s.volume.store(0, std::memory_order_relaxed);
+    s.latency_sum_ns.store(0, std::memory_order_relaxed);
+    s.latency_max_ns.store(0, std::memory_order_relaxed);
+}
+
+// Advance `steps` buckets, clearing each one entered; the last gets `start`
+void RollingMetrics::roll(Ring& ring, uint64_t steps, uint64_t start, uint64_t stride) {
+    size_t n = ring.size;
+    uint64_t cleared = std::min<uint64_t>(steps, n);
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    begin_write(ring.seq);
+    for (uint64_t i = 0; i < cleared; ++i) {
+        head = (head + 1) % n;
+        Slot& s = ring.slots[head];
+        clear_slot(s);
+        s.start.store(start - (cleared - 1 - i) * stride, std::memory_order_relaxed);
+    }
+    ring.head.store(head, std::memory_order_relaxed);
+    ring.used.store(std::min<size_t>(n, ring.used.load(std::memory_order_relaxed) + cleared),
+                    std::memory_order_relaxed);
+    end_write(ring.seq);
+}
+
+// Linear probing from the id's hash; traders past three quarters of the
+// table share the tally after it
+RollingMetrics::Tally& RollingMetrics::tally_for(Slot& s, int trader_id) {
+    size_t mask = config_.trader_slots - 1;
+    size_t i = (static_cast<uint32_t>(trader_id) * 2654435761u) & mask;
+    for (size_t probe = 0; probe <= mask; ++probe, i = (i + 1) & mask) {
+        Tally& t = s.tallies[i];
+        int id = t.trader_id.load(std::memory_order_relaxed);
+        if (id == trader_id) return t;
+        if (id != kNoTrader) continue;
+        if (s.touched.size() * 4 >= config_.trader_slots * 3) break;
+        t.trader_id.store(trader_id, std::memory_order_relaxed);
+        s.touched.push_back(static_cast<uint32_t>(i));
+        return t;
+    }
+    return s.tallies[config_.trader_slots];
+}
+
+void RollingMetrics::add(Slot& s, TimeNs latency_ns, size_t orders, const std::vector<Trade>& trades,
+                         const std::vector<int>& winners, const std::vector<int>& losers) {
+    begin_write(s.seq);
+    add_to<uint64_t>(s.batches, 1);
+    add_to<uint64_t>(s.orders, orders);
+    add_to<uint64_t>(s.trades, trades.size());
+    add_to<uint64_t>(s.latency_sum_ns, latency_ns);
+    if (latency_ns > s.latency_max_ns.load(std::memory_order_relaxed)) {
+        s.latency_max_ns.store(latency_ns, std::memory_order_relaxed);
+    }
+    for (const auto& t : trades) {
+        add_to<Qty>(s.volume, t.qty);
+        Tally& buyer = tally_for(s, t.buy_trader_id);
+        add_to<uint64_t>(buyer.fills, 1);
+        add_to<Qty>(buyer.volume, t.qty);
+        Tally& seller = tally_for(s, t.sell_trader_id);
+        add_to<uint64_t>(seller.fills, 1);
+        add_to<Qty>(seller.volume, t.qty);
+    }
+    for (int id : winners) add_to<uint64_t>(tally_for(s, id).wins, 1);
+    for (int id : losers) add_to<uint64_t>(tally_for(s, id).losses, 1);
+    end_write(s.seq);
+}
+
+void RollingMetrics::record_batch(TimeNs now, TimeNs latency_ns, size_t orders, const std::vector<Trade>& trades,
+                                  const std::vector<int>& winners, const std::vector<int>& losers) {
+    if (!enabled_) return;
+
+    // Time axis: a clock that steps back (another thread's stamp) stays in
+    // the current bucket
+    uint64_t interval = now / config_.interval_ns;
+    if (by_time_.used.load(std::memory_order_relaxed) == 0) {
+        roll(by_time_, 1, interval * config_.interval_ns, config_.interval_ns);
+        by_time_.position = interval;
+    } else if (interval > by_time_.position) {
+        roll(by_time_, interval - by_time_.position, interval * config_.interval_ns, config_.interval_ns);
+        by_time_.position = interval;
+    }
+    add(by_time_.slots[by_time_.head.load(std::memory_order_relaxed)], latency_ns, orders, trades, winners, losers);
+
+    // Batch axis
+    if (by_batch_.used.load(std::memory_order_relaxed) == 0 ||
+        by_batch_.position % config_.batches_per_bucket == 0) {
+        roll(by_batch_, 1, by_batch_.position, config_.batches_per_bucket);
+    }
+    by_batch_.position++;
+    add(by_batch_.slots[by_batch_.head.load(std::memory_order_relaxed)], latency_ns, orders, trades, winners,
+        losers);
+}
+
+// One bucket; false if the writer added to it meanwhile
+bool RollingMetrics::copy_slot(const Slot& s, WindowBucket& out) const {
+    uint64_t before = s.seq.load(std::memory_order_acquire);
+    if (before & 1) return false;
+    out.start = s.start.load(std::memory_order_relaxed);
+    out.batches = s.batches.load(std::memory_order_relaxed);
+    out.orders = s.orders.load(std::memory_order_relaxed);
+    out.trades = s.trades.load(std::memory_order_relaxed);
+    out.volume = s.volume.load(std::memory_order_relaxed);
+    out.latency_sum_ns = s.latency_sum_ns.load(std::memory_order_relaxed);
+    out.latency_max_ns = s.latency_max_ns.load(std::memory_order_relaxed);
+    auto read = [](const Tally& t, int id) {
+        return TraderWindow{id, t.wins.load(std::memory_order_relaxed), t.losses.load(std::memory_order_relaxed),
+                            t.fills.load(std::memory_order_relaxed), t.volume.load(std::memory_order_relaxed)};
+    };
+    out.traders.clear();
+    for (size_t i = 0; i < config_.trader_slots; ++i) {
+        int id = s.tallies[i].trader_id.load(std::memory_order_relaxed);
+        if (id != kNoTrader) out.traders.push_back(read(s.tallies[i], id));
+    }
+    out.others = read(s.tallies[config_.trader_slots], -1);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != before) return false;
+    std::sort(out.traders.begin(), out.traders.end(),
+              [](const TraderWindow& a, const TraderWindow& b) { return a.trader_id < b.trader_id; });
+    return true;
+}
+
+std::vector<WindowBucket> RollingMetrics::series(WindowAxis axis) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Ring& ring = axis == WindowAxis::TIME ? by_time_ : by_batch_;
+    size_t n = ring.size;
+    std::vector<WindowBucket> out;
+    // Only the bucket being filled changes under a copy, unless a rollover
+    // recycles buckets, which starts the copy over
+    while (true) {
+        uint64_t before = ring.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        size_t head = ring.head.load(std::memory_order_relaxed);
+        size_t used = ring.used.load(std::memory_order_relaxed);
+        out.resize(used);
+        for (size_t i = used; i > 0; --i) {
+            while (!copy_slot(ring.slots[(head + n + 1 - i) % n], out[used - i])) std::this_thread::yield();
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (ring.seq.load(std::memory_order_relaxed) == before) return out;
+    }
+}
+
+std::string RollingMetrics::format_csv(const std::vector<WindowBucket>& buckets, WindowAxis axis) {
+    std::ostringstream oss;
+    oss << (axis == WindowAxis::TIME ? "start_ns" : "first_batch")
+        << ",batches,orders,trades,volume,latency_mean_ns,latency_max_ns,spread_index,jain,"
+           "trader_id,wins,losses,fills,trader_volume\n";
+    for (const auto& b : buckets) {
+        std::ostringstream prefix;
+        prefix << b.start << ',' << b.batches << ',' << b.orders << ',' << b.trades << ',' << b.volume << ','
+               << b.mean_latency_ns() << ',' << b.latency_max_ns << ',' << b.spread_index() << ',' << b.jain();
+        bool any = false;
+        auto row = [&](const TraderWindow& t, const std::string& id) {
+            if (t.wins + t.losses + t.fills == 0) return;
+            any = true;
+            oss << prefix.str() << ',' << id << ',' << t.wins << ',' << t.losses << ',' << t.fills << ','
+                << t.volume << '\n';
+        };
+        for (const auto& t : b.traders) row(t, std::to_string(t.trader_id));
+        row(b.others, "others");
+        if (!any) oss << prefix.str() << ",,,,,\n";
+    }
+    return oss.str();
+}
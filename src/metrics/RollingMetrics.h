@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "core/Types.h"
+#include "book/Order.h"
+
+// Shape of the rolling windows. Memory is fixed at
+// (time_buckets + batch_buckets) * trader_slots per-trader tallies.
+struct RollingConfig {
+    TimeNs   interval_ns = 10'000'000;   // time axis: 10ms buckets
+    size_t   time_buckets = 100;
+    uint64_t batches_per_bucket = 100;   // batch axis
+    size_t   batch_buckets = 100;
+    size_t   trader_slots = 1024;        // per bucket, rounded up to a power of two
+};
+
+struct TraderWindow {
+    int      trader_id = 0;
+    uint64_t wins = 0;
+    uint64_t losses = 0;
+    uint64_t fills = 0;
+    Qty      volume = 0;
+};
+
+struct WindowBucket {
+    uint64_t start = 0;          // ns (time axis) or first batch number (batch axis)
+    uint64_t batches = 0;
+    uint64_t orders = 0;
+    uint64_t trades = 0;
+    Qty      volume = 0;
+    uint64_t latency_sum_ns = 0;
+    uint64_t latency_max_ns = 0;
+    std::vector<TraderWindow> traders;   // ascending id
+    TraderWindow others;                 // traders the bucket had no slot left for, combined
+
+    double mean_latency_ns() const { return batches ? static_cast<double>(latency_sum_ns) / batches : 0.0; }
+    // The cumulative figures, over this bucket's competitions only (others
+    // are a sum of traders, so they are left out)
+    double spread_index() const;
+    double jain() const;
+};
+
+enum class WindowAxis { TIME, BATCHES };
+
+// Recent history as two rings of fixed-size buckets: one per interval of
+// wall time and one per batches_per_bucket batches. The engine records one
+// call per matched batch (per order in naive mode); moving to the next
+// bucket clears only the slots it used, so the cost per event is O(1) and
+// memory never grows with run length.
+//
+// Each bucket keys its trader tallies by id in an open-addressed table of
+// trader_slots entries, so any population size can be tracked; once a
+// bucket has filled three quarters of its slots, further traders are
+// summed into `others`.
+//
+// Written by one thread without locks: every bucket is published through
+// its own sequence number and each ring's rollover through another, so
+// series() may be called from any thread and retries only what changed
+// under it. configure() and clear() must not run while a batch is being
+// recorded.
+class RollingMetrics {
+public:
+    explicit RollingMetrics(const RollingConfig& config = RollingConfig());
+
+    // Drops all history
+    void configure(const RollingConfig& config);
+    const RollingConfig& config() const { return config_; }
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+    void clear();
+
+    // One matched batch: its competition winners and losers by trader id
+    void record_batch(TimeNs now, TimeNs latency_ns, size_t orders, const std::vector<Trade>& trades,
+                      const std::vector<int>& winners, const std::vector<int>& losers);
+
+    // Buckets oldest first, the one still filling last
+    std::vector<WindowBucket> series(WindowAxis axis) const;
+
+    // One row per (bucket, active trader), bucket columns repeated
+    static std::string format_csv(const std::vector<WindowBucket>& buckets, WindowAxis axis);
+
+private:
+    static constexpr int kNoTrader = INT_MIN;
+
+    struct Tally {
+        std::atomic<int> trader_id{kNoTrader};
+        std::atomic<uint64_t> wins{0};
+        std::atomic<uint64_t> losses{0};
+        std::atomic<uint64_t> fills{0};
+        std::atomic<Qty> volume{0};
+    };
+
+    // A bucket as the writer keeps it
+    struct Slot {
+        std::atomic<uint64_t> seq{0};    // odd while the writer is adding to it
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> orders{0};
+        std::atomic<uint64_t> trades{0};
+        std::atomic<Qty> volume{0};
+        std::atomic<uint64_t> latency_sum_ns{0};
+        std::atomic<uint64_t> latency_max_ns{0};
+        std::unique_ptr<Tally[]> tallies;   // trader_slots, then the one for others
+        std::vector<uint32_t> touched;      // tallies in use, writer only
+    };
+
+    struct Ring {
+        std::unique_ptr<Slot[]> slots;
+        size_t size = 0;
+        std::atomic<uint64_t> seq{0};      // odd while buckets are being rolled over
+        std::atomic<size_t> head{0};       // bucket being filled
+        std::atomic<size_t> used{0};       // buckets holding data, at most size
+        uint64_t position = 0;             // current interval index (time) or batch count (batches), writer only
+    };
+
+    RollingConfig config_;
+    bool enabled_;
+    Ring by_time_;
+    Ring by_batch_;
+    mutable std::mutex mutex_;   // series() against configure(), never taken by the writer
+
+    void init_ring(Ring& ring, size_t buckets);
+    void roll(Ring& ring, uint64_t steps, uint64_t start, uint64_t stride);
+    void clear_slot(Slot& s);
+    Tally& tally_for(Slot& s, int trader_id);
+    void add(Slot& s, TimeNs latency_ns, size_t orders, const std::vector<Trade>& trades,
+             const std::vector<int>& winners, const std::vector<int>& losers);
+    bool copy_slot(const Slot& s, WindowBucket& out) const;
+};
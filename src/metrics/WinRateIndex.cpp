@@ -0,0 +1,139 @@
+#include "metrics/WinRateIndex.h"
+
+WinRateIndex::WinRateIndex() : root_(-1), rng_(0x9e3779b9u) {}
+
+void WinRateIndex::clear() {
+    nodes_.clear();
+    node_of_.clear();
+    root_ = -1;
+}
+
+void WinRateIndex::update(size_t key, uint64_t won, uint64_t lost) {
+    uint64_t total = won + lost;
+    if (total == 0) return;
+    if (key >= node_of_.size()) node_of_.resize(key + 1, -1);
+
+    int32_t t = node_of_[key];
+    if (t < 0) {
+        // xorshift32 priorities keep the treap balanced in expectation
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        t = static_cast<int32_t>(nodes_.size());
+        nodes_.push_back(Node{0.0, static_cast<uint32_t>(key), rng_, -1, -1, 1, 0.0, 0.0, 0.0});
+        node_of_[key] = t;
+    } else {
+        root_ = erase(root_, t);
+    }
+
+    Node& n = nodes_[t];
+    n.rate = static_cast<double>(won) / static_cast<double>(total);
+    n.left = n.right = -1;
+    pull(t);
+
+    int32_t lo, hi;
+    split(root_, nodes_[t], lo, hi);
+    root_ = merge(merge(lo, t), hi);
+}
+
+void WinRateIndex::pull(int32_t t) {
+    Node& n = nodes_[t];
+    uint32_t left_count = 0;
+    n.count = 1;
+    n.sum = n.rate;
+    n.sum_sq = n.rate * n.rate;
+    n.rank_sum = 0.0;
+    if (n.left >= 0) {
+        const Node& l = nodes_[n.left];
+        left_count = l.count;
+        n.count += l.count;
+        n.sum += l.sum;
+        n.sum_sq += l.sum_sq;
+        n.rank_sum += l.rank_sum;
+    }
+    n.rank_sum += (left_count + 1) * n.rate;
+    if (n.right >= 0) {
+        const Node& r = nodes_[n.right];
+        n.count += r.count;
+        n.sum += r.sum;
+        n.sum_sq += r.sum_sq;
+        // Every rank in the right subtree shifts by the nodes before it
+        n.rank_sum += r.rank_sum + (left_count + 1) * r.sum;
+    }
+}
+
+void WinRateIndex::split(int32_t t, const Node& pivot, int32_t& lo, int32_t& hi) {
+    if (t < 0) {
+        lo = hi = -1;
+        return;
+    }
+    if (less(nodes_[t], pivot)) {
+        split(nodes_[t].right, pivot, nodes_[t].right, hi);
+        lo = t;
+    } else {
+        split(nodes_[t].left, pivot, lo, nodes_[t].left);
+        hi = t;
+    }
+    pull(t);
+}
+
+int32_t WinRateIndex::merge(int32_t a, int32_t b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (nodes_[a].priority > nodes_[b].priority) {
+        nodes_[a].right = merge(nodes_[a].right, b);
+        pull(a);
+        return a;
+    }
+    nodes_[b].left = merge(a, nodes_[b].left);
+    pull(b);
+    return b;
+}
+
+int32_t WinRateIndex::erase(int32_t t, int32_t target) {
+    if (t == target) return merge(nodes_[t].left, nodes_[t].right);
+    if (less(nodes_[target], nodes_[t])) {
+        nodes_[t].left = erase(nodes_[t].left, target);
+    } else {
+        nodes_[t].right = erase(nodes_[t].right, target);
+    }
+    pull(t);
+    return t;
+}
+
+double WinRateIndex::min_positive_rate() const {
+    double best = 0.0;
+    for (int32_t t = root_; t >= 0;) {
+        const Node& n = nodes_[t];
+        if (n.rate > 0.0) {
+            best = n.rate;
+            t = n.left;
+        } else {
+            t = n.right;
+        }
+    }
+    return best;
+}
+
+FairnessIndices WinRateIndex::indices() const {
+    FairnessIndices out;
+    if (root_ < 0) return out;
+
+    const Node& root = nodes_[root_];
+    double n = static_cast<double>(root.count);
+    out.competitors = root.count;
+    out.jain = root.sum_sq > 0.0 ? root.sum * root.sum / (n * root.sum_sq) : 0.0;
+    // G = sum_i (2i - n - 1) r_(i) / (n * sum r), ranks ascending from 1
+    out.gini = root.sum > 0.0 ? (2.0 * root.rank_sum - (n + 1.0) * root.sum) / (n * root.sum) : 0.0;
+
+    int32_t t = root_;
+    while (nodes_[t].left >= 0) t = nodes_[t].left;
+    out.min_win_rate = nodes_[t].rate;
+    t = root_;
+    while (nodes_[t].right >= 0) t = nodes_[t].right;
+    out.max_win_rate = nodes_[t].rate;
+
+    double min_positive = min_positive_rate();
+    out.spread_index = out.max_win_rate > 0.0 ? 1.0 - (out.max_win_rate - min_positive) : 0.0;
+    return out;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fairness of the win-rate distribution across traders that have been in at
+// least one competition (won + lost > 0)
+struct FairnessIndices {
+    uint64_t competitors = 0;
+    double jain = 0.0;           // (sum r)^2 / (n * sum r^2); 1 = all equal, 1/n = one trader wins all
+    double gini = 0.0;           // 0 = all equal, towards 1 = concentrated
+    double min_win_rate = 0.0;   // max-min fairness: the worst-off trader
+    double max_win_rate = 0.0;
+    double spread_index = 0.0;   // 1 - (max - min) over traders with a win (the original fairness index)
+};
+
+// Win rates of all competing traders in an order-statistics tree (a treap
+// keyed by (rate, trader), one node per trader, reused across updates).
+// Every node keeps its subtree's count, sum, sum of squares and rank-weighted
+// sum, so Jain's index, the Gini coefficient (from the sorted-rank formula)
+// and the extremes are read off the root: O(log traders) per update and
+// O(log traders) per query, with no rescan and no drift from running
+// additions and subtractions.
+class WinRateIndex {
+public:
+    WinRateIndex();
+
+    // Trader `key` (a small dense id) now has this many wins and losses
+    void update(size_t key, uint64_t won, uint64_t lost);
+    void clear();
+
+    FairnessIndices indices() const;
+    size_t size() const { return root_ < 0 ? 0 : nodes_[root_].count; }
+
+private:
+    struct Node {
+        double rate;
+        uint32_t key;
+        uint32_t priority;
+        int32_t left;
+        int32_t right;
+        uint32_t count;
+        double sum;
+        double sum_sq;
+        double rank_sum;   // sum of rank * rate, ranks 1..count within the subtree
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<int32_t> node_of_;   // key -> node, -1 if not competing
+    int32_t root_;
+    uint32_t rng_;
+
+    static bool less(const Node& a, const Node& b) {
+        return a.rate != b.rate ? a.rate < b.rate : a.key < b.key;
+    }
+    void pull(int32_t t);
+    void split(int32_t t, const Node& pivot, int32_t& lo, int32_t& hi);   // lo < pivot <= hi
+    int32_t merge(int32_t a, int32_t b);
+    int32_t erase(int32_t t, int32_t target);
+    double min_positive_rate() const;
+};
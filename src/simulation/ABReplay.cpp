@@ -0,0 +1,211 @@
+#include "simulation/ABReplay.h"
+#include "core/Clock.h"
+#include "batching/SpeedBump.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
+
+ABReplay::ABReplay(std::vector<ReplayVariant> variants) : wall_ms_(0) {
+    for (auto& v : variants) {
+        ReplayLane lane;
+        lane.variant = std::move(v);
+        lane.variant.policy.log_batches = false;  // lanes run off the CLI thread
+        lanes_.push_back(std::move(lane));
+    }
+}
+
+void ABReplay::run(const std::vector<OrderEvent>& stream) {
+    OrderID first_id = stream.empty() ? 1 : stream.front().order_id;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(lanes_.size());
+    for (auto& lane : lanes_) {
+        threads.emplace_back(run_lane, std::ref(lane), std::cref(stream), first_id);
+    }
+    for (auto& t : threads) t.join();
+    wall_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ABReplay::run_lane(ReplayLane& lane, const std::vector<OrderEvent>& stream, OrderID first_id) {
+    lane.engine = std::make_unique<MatchingEngine>(lane.variant.mode);
+    lane.engine->set_price_band(lane.variant.band_low, lane.variant.band_high);
+    lane.engine->set_parallel_sort(lane.variant.sort_pool, lane.variant.sort_threshold);
+    lane.filled.assign(stream.size(), 0);
+    lane.batch_of.assign(stream.size(), 0);
+    MicroBatcher batcher(lane.variant.policy);
+
+    auto dispatch = [&](std::vector<OrderEvent>&& batch) {
+        for (const auto& ev : batch) {
+            size_t pos = static_cast<size_t>(ev.order_id - first_id);
+            if (pos < stream.size()) lane.batch_of[pos] = ev.batch_id;
+        }
+
+        uint64_t t0 = TscClock::ticks();
+        auto trades = lane.engine->process_batch(batch);
+        lane.batch_latencies_ns.push_back(TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(t0));
+
+        for (const auto& t : trades) {
+            size_t buy = static_cast<size_t>(t.buy_order_id - first_id);
+            size_t sell = static_cast<size_t>(t.sell_order_id - first_id);
+            if (buy < stream.size()) lane.filled[buy] += t.qty;
+            if (sell < stream.size()) lane.filled[sell] += t.qty;
+        }
+        lane.trades += trades.size();
+        lane.batches++;
+        batcher.recycle(std::move(batch));
+    };
+
+    // Naive lanes stream: every order is matched on its own, in recv_time
+    // order, with the batch window as the contention horizon
+    if (lane.variant.mode == MatchingMode::NAIVE_PRICE_TIME) {
+        lane.engine->set_contention_horizon(lane.variant.policy.window_ns);
+        std::vector<size_t> arrival(stream.size());
+        std::iota(arrival.begin(), arrival.end(), size_t{0});
+        std::stable_sort(arrival.begin(), arrival.end(), [&](size_t a, size_t b) {
+            return stream[a].recv_time < stream[b].recv_time;
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t pos : arrival) {
+            const OrderEvent& ev = stream[pos];
+            lane.batch_of[pos] = static_cast<BatchID>(pos + 1);
+
+            uint64_t t0 = TscClock::ticks();
+            auto trades = lane.engine->process_order(ev, ev.trader_id);
+            lane.batch_latencies_ns.push_back(TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(t0));
+
+            for (const auto& t : trades) {
+                size_t buy = static_cast<size_t>(t.buy_order_id - first_id);
+                size_t sell = static_cast<size_t>(t.sell_order_id - first_id);
+                if (buy < stream.size()) lane.filled[buy] += t.qty;
+                if (sell < stream.size()) lane.filled[sell] += t.qty;
+            }
+            lane.trades += trades.size();
+            lane.batches++;
+        }
+        lane.engine->settle_contention();
+        lane.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return;
+    }
+
+    // SPEED_BUMP lanes release through the delay line instead of batching
+    bool speed_bump = lane.variant.mode == MatchingMode::SPEED_BUMP;
+    SpeedBump bump(lane.variant.bump_tick_ns);
+    if (speed_bump && lane.variant.traders) {
+        const TraderPopulation& traders = *lane.variant.traders;
+        for (size_t i = 0; i < traders.size(); ++i) {
+            bump.set_trader_latency(TraderPopulation::id_of(i), traders.latency(i));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& ev : stream) {
+        if (speed_bump) {
+            bump.submit(OrderEvent(ev));
+            for (auto released = bump.pop_due(); !released.empty(); released = bump.pop_due()) {
+                dispatch(std::move(released));
+            }
+            continue;
+        }
+        while (batcher.submit(OrderEvent(ev)) == Admission::WOULD_BLOCK) {
+            dispatch(batcher.pop_batch());
+        }
+        while (batcher.has_ready_batch()) {
+            dispatch(batcher.pop_batch());
+        }
+    }
+    while (bump.pending() > 0) {
+        dispatch(bump.pop_next());
+    }
+    while (batcher.pending() > 0) {
+        dispatch(batcher.pop_batch());
+    }
+    lane.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t ABReplay::reference_lane() const {
+    for (size_t l = 0; l < lanes_.size(); ++l) {
+        if (lanes_[l].variant.mode != MatchingMode::NAIVE_PRICE_TIME) return l;
+    }
+    return 0;
+}
+
+std::vector<BatchDiff> ABReplay::batch_diffs() const {
+    std::vector<BatchDiff> diffs;
+    if (lanes_.size() < 2) return diffs;
+    const ReplayLane& ref = lanes_[reference_lane()];
+    size_t n = ref.batch_of.size();
+
+    // Group stream positions by the reference batch that matched them; a
+    // deferred order sits in a later batch than its neighbours, so batches
+    // are not runs of consecutive positions. Batch 0 = never matched.
+    std::vector<size_t> by_batch(n);
+    std::iota(by_batch.begin(), by_batch.end(), size_t{0});
+    std::stable_sort(by_batch.begin(), by_batch.end(), [&](size_t a, size_t b) {
+        return ref.batch_of[a] < ref.batch_of[b];
+    });
+
+    size_t first = 0;
+    while (first < n) {
+        BatchID id = ref.batch_of[by_batch[first]];
+        size_t last = first;
+        while (last < n && ref.batch_of[by_batch[last]] == id) ++last;
+        if (id == 0) {
+            first = last;
+            continue;
+        }
+
+        BatchDiff d{id, by_batch[first], last - first,
+                    std::vector<Qty>(lanes_.size(), 0), std::vector<size_t>(lanes_.size(), 0)};
+        bool differs = false;
+        for (size_t l = 0; l < lanes_.size(); ++l) {
+            for (size_t k = first; k < last; ++k) {
+                size_t i = by_batch[k];
+                d.filled_qty[l] += lanes_[l].filled[i];
+                if (lanes_[l].filled[i] != ref.filled[i]) d.orders_changed[l]++;
+            }
+            differs = differs || d.orders_changed[l] > 0;
+        }
+        if (differs) diffs.push_back(std::move(d));
+        first = last;
+    }
+    return diffs;
+}
+
+std::vector<OrderEvent> ABReplay::generate_stream(const TraderPopulation& traders, size_t num_orders,
+                                                  uint32_t seed, TimeNs gap_ns, const OrderMix& mix) {
+    std::vector<OrderEvent> stream;
+    if (traders.size() == 0) return stream;
+    stream.reserve(num_orders);
+
+    TraderSimulator simulator(seed);
+    simulator.set_order_mix(mix);
+    std::mt19937 rng(seed ^ 0x9e3779b9u);
+
+    TimeNs base_time = 1'000'000;
+    for (size_t i = 0; i < num_orders; ++i) {
+        size_t trader = traders.pick(rng);
+        auto params = simulator.generate_order(traders.aggressiveness(trader), 100, 10);
+
+        OrderEvent ev;
+        ev.type = EventType::NEW;
+        ev.order_id = static_cast<OrderID>(i + 1);
+        ev.instrument = "STOCK";
+        ev.side = params.side;
+        ev.price = params.price;
+        ev.qty = params.qty;
+        ev.tif = params.tif;
+        ev.order_type = params.order_type;
+        ev.recv_time = base_time + traders.sample_latency(trader, rng);
+        ev.batch_id = 0;
+        ev.trader_id = TraderPopulation::id_of(trader);
+        stream.push_back(std::move(ev));
+
+        base_time += gap_ns;
+    }
+    return stream;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/OrderEvent.h"
+#include "core/MatchingMode.h"
+#include "batching/MicroBatcher.h"
+#include "engine/MatchingEngine.h"
+#include "simulation/Trader.h"
+#include "simulation/TraderPopulation.h"
+
+class WorkStealingPool;
+
+// One engine configuration in a side-by-side replay
+struct ReplayVariant {
+    std::string label;       // e.g. "naive", "fair:50us"
+    MatchingMode mode;
+    BatchPolicy policy;
+    Price band_low = 0;      // price-band book over [band_low, band_high];
+    Price band_high = -1;    // high < low keeps the heap book
+    WorkStealingPool* sort_pool = nullptr;   // may be shared by all lanes
+    size_t sort_threshold = 65536;
+    const TraderPopulation* traders = nullptr;      // SPEED_BUMP: latencies to equalize
+    TimeNs bump_tick_ns = 10'000;                   // SPEED_BUMP: timing wheel resolution
+};
+
+// Outcome of one variant over the shared stream
+struct ReplayLane {
+    ReplayVariant variant;
+    std::unique_ptr<MatchingEngine> engine;
+    std::vector<Qty> filled;                  // filled qty per stream position
+    std::vector<BatchID> batch_of;            // batch id per stream position (naive: one per order; 0 = unmatched)
+    std::vector<uint64_t> batch_latencies_ns;
+    uint64_t batches = 0;                     // naive lanes: orders matched
+    uint64_t trades = 0;
+    double elapsed_ms = 0;
+};
+
+// A reference-lane batch whose orders were filled differently elsewhere
+struct BatchDiff {
+    BatchID batch_id;                         // batch id in the reference lane
+    size_t first_order;                       // lowest stream position in the batch
+    size_t orders;                            // not necessarily consecutive (deferred orders)
+    std::vector<Qty> filled_qty;              // per lane
+    std::vector<size_t> orders_changed;       // per lane, orders whose fill differs from the reference
+};
+
+// Replays one pre-decoded order stream through several engine
+// configurations at once, one thread per variant. Every lane sees exactly
+// the same orders and recv_times, so differences in fills and fairness come
+// from the configuration alone.
+class ABReplay {
+public:
+    explicit ABReplay(std::vector<ReplayVariant> variants);
+
+    // Blocks until every lane has processed the whole stream
+    void run(const std::vector<OrderEvent>& stream);
+
+    const std::vector<ReplayLane>& lanes() const { return lanes_; }
+    double wall_ms() const { return wall_ms_; }
+
+    // Batches are compared as formed by the first lane that batches
+    // (naive lanes stream order by order), or lane 0 if none does
+    size_t reference_lane() const;
+
+    // Reference-lane batches where some other lane filled a different quantity
+    std::vector<BatchDiff> batch_diffs() const;
+
+    // Deterministic synthetic stream: a trader picked by order rate submits
+    // every gap_ns and recv_time is offset by its latency and jitter. Order ids are
+    // 1..num_orders in submission order, which run() relies on. mix sets
+    // the share of IOC, FOK and market orders.
+    static std::vector<OrderEvent> generate_stream(const TraderPopulation& traders, size_t num_orders,
+                                                   uint32_t seed, TimeNs gap_ns = 1'000,
+                                                   const OrderMix& mix = OrderMix());
+
+private:
+    std::vector<ReplayLane> lanes_;
+    double wall_ms_;
+
+    static void run_lane(ReplayLane& lane, const std::vector<OrderEvent>& stream, OrderID first_id);
+};
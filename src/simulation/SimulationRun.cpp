@@ -0,0 +1,138 @@
+#include "simulation/SimulationRun.h"
+#include "core/Clock.h"
+#include "core/JobExecutor.h"
+#include "batching/SpeedBump.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <thread>
+
+namespace {
+
+// Match a batch in place and hand its storage back to the batcher
+void dispatch(MatchingEngine& engine, MicroBatcher& batcher, std::vector<OrderEvent>&& batch,
+              std::vector<uint64_t>& batch_latencies_ns) {
+    if (batch.empty()) return;
+    uint64_t start = TscClock::ticks();
+    engine.process_batch(batch);
+    uint64_t end = TscClock::ticks();
+    batch_latencies_ns.push_back(TscClock::to_ns(end) - TscClock::to_ns(start));
+    batcher.recycle(std::move(batch));
+}
+
+// Orders in flight, earliest arrival on top
+struct LaterArrival {
+    bool operator()(const OrderEvent& a, const OrderEvent& b) const {
+        if (a.recv_time != b.recv_time) return a.recv_time > b.recv_time;
+        return a.order_id > b.order_id;
+    }
+};
+using ArrivalQueue = std::priority_queue<OrderEvent, std::vector<OrderEvent>, LaterArrival>;
+
+// Match, one at a time, every order that has arrived by `now`
+void stream_arrivals(MatchingEngine& engine, ArrivalQueue& arrivals, TimeNs now,
+                     std::vector<uint64_t>& latencies_ns) {
+    while (!arrivals.empty() && arrivals.top().recv_time <= now) {
+        const OrderEvent& ev = arrivals.top();
+        uint64_t start = TscClock::ticks();
+        engine.process_order(ev, ev.trader_id);
+        uint64_t end = TscClock::ticks();
+        latencies_ns.push_back(TscClock::to_ns(end) - TscClock::to_ns(start));
+        arrivals.pop();
+    }
+}
+
+} // namespace
+
+uint64_t run_simulated_flow(MatchingEngine& engine, MicroBatcher& batcher, TraderSimulator& simulator,
+                            const TraderPopulation& traders, uint64_t num_orders,
+                            std::vector<uint64_t>& batch_latencies_ns,
+                            JobProgress* progress, bool print_progress) {
+    Price center_price = 100;
+    Qty base_qty = 10;
+    OrderID next_order_id = 1;
+    
+    std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
+    
+    // SPEED_BUMP takes orders through the delay line instead of the
+    // batcher, and naive mode matches each order as it arrives
+    bool speed_bump = engine.get_mode() == MatchingMode::SPEED_BUMP;
+    bool streaming = engine.get_mode() == MatchingMode::NAIVE_PRICE_TIME;
+    ArrivalQueue arrivals;
+    SpeedBump bump;
+    if (speed_bump) {
+        for (size_t i = 0; i < traders.size(); ++i) {
+            bump.set_trader_latency(TraderPopulation::id_of(i), traders.latency(i));
+        }
+    }
+    
+    uint64_t generated = 0;
+    for (; generated < num_orders; ++generated) {
+        if (progress && progress->cancel.load(std::memory_order_relaxed)) break;
+        
+        // Pick a trader, weighted by order rate
+        size_t trader = traders.pick(rng);
+        
+        // Generate order
+        auto params = simulator.generate_order(traders.aggressiveness(trader), center_price, base_qty);
+        
+        OrderEvent ev;
+        ev.type = EventType::NEW;
+        ev.order_id = next_order_id++;
+        ev.instrument = "STOCK";
+        ev.side = params.side;
+        ev.price = params.price;
+        ev.qty = params.qty;
+        ev.tif = params.tif;
+        ev.order_type = params.order_type;
+        ev.recv_time = TscClock::now_ns() + traders.sample_latency(trader, rng);
+        ev.trader_id = TraderPopulation::id_of(trader);
+        
+        if (streaming) {
+            arrivals.push(std::move(ev));
+            stream_arrivals(engine, arrivals, TscClock::now_ns(), batch_latencies_ns);
+        } else if (speed_bump) {
+            bump.submit(std::move(ev));
+            for (auto released = bump.pop_due(); !released.empty(); released = bump.pop_due()) {
+                dispatch(engine, batcher, std::move(released), batch_latencies_ns);
+            }
+        } else {
+            // A blocking batcher hands the order back until the open batch is matched
+            while (batcher.submit(std::move(ev)) == Admission::WOULD_BLOCK) {
+                dispatch(engine, batcher, batcher.pop_batch(), batch_latencies_ns);
+            }
+            while (batcher.has_ready_batch()) {
+                dispatch(engine, batcher, batcher.pop_batch(), batch_latencies_ns);
+            }
+        }
+        
+        // Small delay to simulate real-time arrival
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+        
+        if (progress) {
+            progress->done.fetch_add(1, std::memory_order_relaxed);
+            progress->batches.store(batch_latencies_ns.size(), std::memory_order_relaxed);
+        }
+        if (print_progress && (generated + 1) % 100 == 0) {
+            std::cout << "Processed " << (generated + 1) << " orders...\r" << std::flush;
+        }
+    }
+    
+    // Flush any remaining batch (more than one if a batch cap is set)
+    stream_arrivals(engine, arrivals, std::numeric_limits<TimeNs>::max(), batch_latencies_ns);
+    if (streaming) engine.settle_contention();
+    while (bump.pending() > 0) {
+        dispatch(engine, batcher, bump.pop_next(), batch_latencies_ns);
+    }
+    while (batcher.pending() > 0) {
+        dispatch(engine, batcher, batcher.pop_batch(), batch_latencies_ns);
+    }
+    if (progress) {
+        progress->batches.store(batch_latencies_ns.size(), std::memory_order_relaxed);
+    }
+    return generated;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "batching/MicroBatcher.h"
+#include "engine/MatchingEngine.h"
+#include "simulation/Trader.h"
+#include "simulation/TraderPopulation.h"
+
+struct JobProgress;
+
+// Generate num_orders orders from traders picked by order rate, stamped with
+// the real clock plus each trader's latency and jitter, and push them through engine the
+// way `simulate` does: fair mode matches every batch as it comes out of the
+// batcher, naive mode streams (each order goes to process_order once the
+// clock reaches its recv_time, in arrival order), and SPEED_BUMP bypasses the
+// batcher for a SpeedBump set up with the traders' latencies, matching
+// whatever it releases. Per-batch match latencies (per order when
+// streaming) are appended to batch_latencies_ns.
+//
+// With progress, orders and batches are counted there as they go and the run
+// stops early once progress->cancel is set. Returns the orders generated.
+uint64_t run_simulated_flow(MatchingEngine& engine, MicroBatcher& batcher, TraderSimulator& simulator,
+                            const TraderPopulation& traders, uint64_t num_orders,
+                            std::vector<uint64_t>& batch_latencies_ns,
+                            JobProgress* progress = nullptr, bool print_progress = false);
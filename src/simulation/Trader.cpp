@@ -1,6 +1,7 @@
 #include "simulation/Trader.h"
 #include <chrono>
 #include <algorithm>
+#include <cmath>
 
 TraderSimulator::TraderSimulator() 
     : rng_(std::chrono::steady_clock::now().time_since_epoch().count()),
@@ -8,6 +9,12 @@ TraderSimulator::TraderSimulator()
       qty_variation_(5, 15),
       side_choice_(0, 1) {}
 
+TraderSimulator::TraderSimulator(uint32_t seed)
+    : rng_(seed),
+      price_spread_(-5, 5),
+      qty_variation_(5, 15),
+      side_choice_(0, 1) {}
+
 std::vector<Trader> TraderSimulator::create_standard_traders() {
     std::vector<Trader> traders;
     
@@ -27,7 +34,7 @@ std::vector<Trader> TraderSimulator::create_standard_traders() {
 }
 
 TraderSimulator::OrderParams TraderSimulator::generate_order(
-    const Trader& trader, Price center_price, Qty base_qty) {
+    float aggressiveness, Price center_price, Qty base_qty) {
     
     int price_offset = price_spread_(rng_);
     Price order_price = center_price + price_offset;
@@ -37,6 +44,25 @@ TraderSimulator::OrderParams TraderSimulator::generate_order(
     
     Side order_side = (side_choice_(rng_) == 0) ? Side::BUY : Side::SELL;
     
-    return {order_price, order_qty, order_side};
+    if (aggressiveness > 0.0f) {
+        Price shift = static_cast<Price>(std::lround(aggressiveness * price_spread_.b()));
+        order_price += order_side == Side::BUY ? shift : -shift;
+    }
+    
+    TimeInForce tif = TimeInForce::GTC;
+    OrderType order_type = OrderType::LIMIT;
+    if (!mix_.empty()) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+        if (u < mix_.market) {
+            order_type = OrderType::MARKET;
+            tif = TimeInForce::IOC;
+        } else if (u < mix_.market + mix_.fok) {
+            tif = TimeInForce::FOK;
+        } else if (u < mix_.market + mix_.fok + mix_.ioc) {
+            tif = TimeInForce::IOC;
+        }
+    }
+    
+    return {order_price, order_qty, order_side, tif, order_type};
 }
 
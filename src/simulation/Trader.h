@@ -29,24 +29,45 @@ struct Trader {
     }
 };
 
+// Share of generated orders of each non-default type; the rest are GTC
+// limit orders. Market orders are IOC.
+struct OrderMix {
+    double ioc = 0.0;
+    double fok = 0.0;
+    double market = 0.0;
+    
+    bool empty() const { return ioc <= 0.0 && fok <= 0.0 && market <= 0.0; }
+};
+
 class TraderSimulator {
 public:
     TraderSimulator();
+    explicit TraderSimulator(uint32_t seed);  // reproducible order flow
     
     // Create predefined trader configurations
     std::vector<Trader> create_standard_traders();
     
+    // An empty mix (the default) draws no extra random numbers, so streams
+    // for a given seed are unchanged
+    void set_order_mix(const OrderMix& mix) { mix_ = mix; }
+    const OrderMix& get_order_mix() const { return mix_; }
+    
     // Generate random order from a trader
     struct OrderParams {
         Price price;
         Qty qty;
         Side side;
+        TimeInForce tif;
+        OrderType order_type;
     };
     
-    OrderParams generate_order(const Trader& trader, Price center_price, Qty base_qty);
+    // aggressiveness in [0, 1] moves the price towards the other side by up
+    // to the full spread; 0 leaves the stream unchanged
+    OrderParams generate_order(float aggressiveness, Price center_price, Qty base_qty);
     
 private:
     std::mt19937 rng_;
+    OrderMix mix_;
     std::uniform_int_distribution<int> price_spread_;
     std::uniform_int_distribution<int> qty_variation_;
     std::uniform_int_distribution<int> side_choice_;
@@ -0,0 +1,262 @@
+#include "simulation/TraderPopulation.h"
+#include "metrics/FairnessMetrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+std::string format_us(TimeNs ns) {
+    std::ostringstream oss;
+    if (ns % 1000 == 0 || ns >= 100'000) {
+        oss << (ns + 500) / 1000;
+    } else {
+        oss.setf(std::ios::fixed);
+        oss.precision(1);
+        oss << ns / 1000.0;
+    }
+    oss << "µs";
+    return oss.str();
+}
+
+TimeNs draw_latency(const LatencyModel& m, std::mt19937_64& rng, std::discrete_distribution<size_t>& tier) {
+    double ns = 0.0;
+    switch (m.dist) {
+        case LatencyDist::FIXED:
+            return m.scale_ns;
+        case LatencyDist::UNIFORM:
+            ns = std::uniform_real_distribution<double>(static_cast<double>(m.scale_ns),
+                                                        static_cast<double>(std::max(m.scale_ns, m.spread_ns)))(rng);
+            break;
+        case LatencyDist::NORMAL:
+            ns = std::normal_distribution<double>(static_cast<double>(m.scale_ns),
+                                                  static_cast<double>(m.spread_ns))(rng);
+            break;
+        case LatencyDist::LOGNORMAL:
+            ns = m.scale_ns * std::exp(m.shape * std::normal_distribution<double>(0.0, 1.0)(rng));
+            break;
+        case LatencyDist::EXPONENTIAL:
+            ns = std::exponential_distribution<double>(1.0 / std::max<double>(1.0, m.scale_ns))(rng);
+            break;
+        case LatencyDist::TIERS:
+            ns = static_cast<double>(m.tiers[tier(rng)].latency_ns);
+            if (m.shape > 0.0) ns *= std::exp(m.shape * std::normal_distribution<double>(0.0, 1.0)(rng));
+            break;
+    }
+    return ns <= 0.0 ? 0 : static_cast<TimeNs>(std::llround(ns));
+}
+
+} // namespace
+
+TraderPopulation::TraderPopulation() : uniform_rates_(true) {}
+
+TraderPopulation TraderPopulation::from_traders(const std::vector<Trader>& traders) {
+    TraderPopulation pop;
+    std::vector<std::string> names;
+    for (const auto& t : traders) {
+        pop.latency_ns_.push_back(t.artificial_latency_ns);
+        names.push_back(t.name);
+    }
+    pop.jitter_ns_.assign(traders.size(), 0);
+    pop.aggressiveness_.assign(traders.size(), 0.0f);
+    pop.finish(std::vector<double>(traders.size(), 1.0), std::move(names));
+    return pop;
+}
+
+TraderPopulation TraderPopulation::generate(const PopulationConfig& config) {
+    TraderPopulation pop;
+    size_t n = config.traders;
+    std::mt19937_64 rng(config.seed);
+    std::vector<double> shares;
+    for (const auto& t : config.latency.tiers) shares.push_back(t.share);
+    std::discrete_distribution<size_t> tier(shares.begin(), shares.end());
+
+    pop.latency_ns_.resize(n);
+    for (size_t i = 0; i < n; ++i) pop.latency_ns_[i] = draw_latency(config.latency, rng, tier);
+
+    uint32_t jitter = static_cast<uint32_t>(std::min<TimeNs>(config.jitter_ns, UINT32_MAX));
+    pop.jitter_ns_.assign(n, jitter);
+
+    std::vector<double> rates(n, 1.0);
+    if (config.rate_sigma > 0.0) {
+        std::normal_distribution<double> z(0.0, 1.0);
+        for (auto& r : rates) r = std::exp(config.rate_sigma * z(rng));
+    }
+
+    pop.aggressiveness_.assign(n, 0.0f);
+    if (config.aggressiveness > 0.0) {
+        std::uniform_real_distribution<float> u(0.0f, static_cast<float>(std::min(1.0, 2.0 * config.aggressiveness)));
+        for (auto& a : pop.aggressiveness_) a = u(rng);
+    }
+
+    std::vector<std::string> names;
+    if (n <= kListedTraders) {
+        for (size_t i = 0; i < n; ++i) {
+            names.push_back("Trader " + std::to_string(id_of(i)) + " (" + format_us(pop.latency_ns_[i]) + ")");
+        }
+    }
+    pop.finish(rates, std::move(names));
+    return pop;
+}
+
+bool TraderPopulation::load_csv(const std::string& path, TraderPopulation& out, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    TraderPopulation pop;
+    std::vector<double> rates;
+    std::vector<std::string> names;
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (line_no == 1 && !std::isdigit(static_cast<unsigned char>(line[0]))) continue;
+
+        std::vector<std::string> fields;
+        std::istringstream row(line);
+        for (std::string f; std::getline(row, f, ',');) fields.push_back(f);
+
+        auto number = [](const std::string& f, double& v) {
+            char* end = nullptr;
+            v = std::strtod(f.c_str(), &end);
+            return !f.empty() && *end == '\0' && v >= 0.0;
+        };
+        double latency = 0, jitter = 0, rate = 1.0, aggr = 0.0;
+        bool ok = number(fields[0], latency);
+        ok = ok && (fields.size() < 2 || number(fields[1], jitter)) && jitter <= UINT32_MAX;
+        ok = ok && (fields.size() < 3 || number(fields[2], rate));
+        ok = ok && (fields.size() < 4 || number(fields[3], aggr)) && aggr <= 1.0;
+        if (!ok) {
+            error = path + ":" + std::to_string(line_no) + ": expected latency_ns[,jitter_ns[,rate[,aggressiveness[,name]]]]";
+            return false;
+        }
+
+        pop.latency_ns_.push_back(static_cast<TimeNs>(latency));
+        pop.jitter_ns_.push_back(static_cast<uint32_t>(jitter));
+        pop.aggressiveness_.push_back(static_cast<float>(aggr));
+        rates.push_back(rate);
+        if (names.size() <= kListedTraders) {
+            names.push_back(fields.size() > 4 ? fields[4]
+                            : "Trader " + std::to_string(id_of(names.size())) + " (" + format_us(pop.latency_ns_.back()) + ")");
+        }
+    }
+    if (pop.size() == 0) {
+        error = path + " lists no traders";
+        return false;
+    }
+    if (std::accumulate(rates.begin(), rates.end(), 0.0) <= 0.0) {
+        error = path + ": every order rate is zero";
+        return false;
+    }
+    if (!pop.listed()) names.clear();
+    pop.finish(rates, std::move(names));
+    out = std::move(pop);
+    return true;
+}
+
+void TraderPopulation::finish(const std::vector<double>& rates, std::vector<std::string> names) {
+    size_t n = size();
+    uniform_rates_ = std::all_of(rates.begin(), rates.end(), [&](double r) { return r == rates.front(); });
+
+    // Vose's alias method: each column keeps its own trader with prob_ and
+    // hands the rest of its mass to alias_
+    prob_.assign(n, 1.0f);
+    alias_.resize(n);
+    std::iota(alias_.begin(), alias_.end(), 0u);
+    if (!uniform_rates_) {
+        double total = std::accumulate(rates.begin(), rates.end(), 0.0);
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = rates[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            prob_[s] = static_cast<float>(scaled[s]);
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+    }
+
+    report_.clear();
+    cohort_.clear();
+    if (listed()) {
+        for (size_t i = 0; i < n; ++i) report_.emplace_back(id_of(i), names[i], latency_ns_[i]);
+        return;
+    }
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return latency_ns_[a] < latency_ns_[b]; });
+    cohort_.resize(n);
+    for (size_t c = 0; c < kCohorts; ++c) {
+        size_t first = c * n / kCohorts, last = (c + 1) * n / kCohorts;
+        for (size_t r = first; r < last; ++r) cohort_[order[r]] = static_cast<uint8_t>(c);
+        TimeNs lo = latency_ns_[order[first]], hi = latency_ns_[order[last - 1]];
+        report_.emplace_back(static_cast<int>(c) + 1,
+                             "D" + std::to_string(c + 1) + " " + format_us(lo) + "-" + format_us(hi),
+                             latency_ns_[order[(first + last) / 2]]);
+    }
+}
+
+MetricsSnapshot TraderPopulation::report(const MetricsSnapshot& snap) const {
+    if (listed()) return snap;
+
+    MetricsSnapshot out;
+    out.sequence = snap.sequence;
+    out.trade_count = snap.trade_count;
+    out.indices = snap.indices;
+    std::vector<TraderTally> cohorts(kCohorts, TraderTally{0, 0, 0, 0, 0});
+    for (size_t c = 0; c < kCohorts; ++c) cohorts[c].trader_id = static_cast<int>(c) + 1;
+    for (const auto& t : snap.traders) {
+        if (t.trader_id < 1 || static_cast<size_t>(t.trader_id) > size()) continue;
+        TraderTally& c = cohorts[cohort_[t.trader_id - 1]];
+        c.orders_submitted += t.orders_submitted;
+        c.orders_executed += t.orders_executed;
+        c.trades_won += t.trades_won;
+        c.trades_lost += t.trades_lost;
+    }
+    for (const auto& c : cohorts) {
+        if (c.orders_submitted + c.orders_executed + c.trades_won + c.trades_lost > 0) out.traders.push_back(c);
+    }
+    return out;
+}
+
+std::string TraderPopulation::describe() const {
+    if (size() == 0) return "empty population";
+    std::vector<TimeNs> sorted(latency_ns_);
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+    uint32_t max_jitter = *std::max_element(jitter_ns_.begin(), jitter_ns_.end());
+    double mean_aggr = std::accumulate(aggressiveness_.begin(), aggressiveness_.end(), 0.0) / size();
+
+    std::ostringstream oss;
+    oss << size() << " traders, latency min " << format_us(sorted.front()) << " / p50 " << format_us(pct(0.5))
+        << " / p99 " << format_us(pct(0.99)) << " / max " << format_us(sorted.back());
+    if (max_jitter > 0) oss << ", jitter up to " << format_us(max_jitter);
+    oss << (uniform_rates_ ? ", equal order rates" : ", weighted order rates");
+    if (mean_aggr > 0.0) {
+        oss.setf(std::ios::fixed);
+        oss.precision(2);
+        oss << ", mean aggressiveness " << mean_aggr;
+    }
+    oss << (listed() ? "" : "; reported by latency decile");
+    return oss.str();
+}
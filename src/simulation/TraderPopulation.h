@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "core/Types.h"
+#include "simulation/Trader.h"
+
+struct MetricsSnapshot;
+
+// How a generated population's base latencies are drawn
+enum class LatencyDist { FIXED, UNIFORM, NORMAL, LOGNORMAL, EXPONENTIAL, TIERS };
+
+// A latency profile (e.g. colocated, metro, remote) and its share of traders
+struct LatencyTier {
+    TimeNs latency_ns;
+    double share;
+};
+
+struct LatencyModel {
+    LatencyDist dist = LatencyDist::LOGNORMAL;
+    TimeNs scale_ns = 25'000;          // fixed value, uniform low, normal mean, lognormal median, exponential mean
+    TimeNs spread_ns = 0;              // uniform high, normal stddev
+    double shape = 0.8;                // lognormal sigma; TIERS: lognormal spread around each tier
+    std::vector<LatencyTier> tiers;
+};
+
+struct PopulationConfig {
+    size_t traders = 10'000;
+    LatencyModel latency;
+    TimeNs jitter_ns = 0;              // per order, uniform in [0, jitter_ns] on top of the base latency
+    double rate_sigma = 0.0;           // order rates lognormal(0, sigma); 0 = all traders equally active
+    double aggressiveness = 0.0;       // mean; each trader's is uniform in [0, 2 * mean], capped at 1
+    uint32_t seed = 1;
+};
+
+// Simulated traders as parallel arrays indexed by trader (id = index + 1):
+// base latency, per-order jitter, price aggressiveness and an alias table
+// over order rates, so picking the next submitter and stamping its order
+// touch a few contiguous words however many traders there are (10k-1M
+// fits in tens of megabytes).
+//
+// Up to kListedTraders traders are reported one by one under their names;
+// larger populations are reported as kCohorts latency deciles, with each
+// decile's tallies summed from the per-trader metrics.
+class TraderPopulation {
+public:
+    static constexpr size_t kListedTraders = 16;
+    static constexpr size_t kCohorts = 10;
+
+    TraderPopulation();
+
+    // Ids must be 1..n in order, as create_standard_traders() makes them
+    static TraderPopulation from_traders(const std::vector<Trader>& traders);
+    static TraderPopulation generate(const PopulationConfig& config);
+    // One trader per row: latency_ns[,jitter_ns[,rate[,aggressiveness[,name]]]].
+    // A first line that does not start with a digit is taken as a header.
+    static bool load_csv(const std::string& path, TraderPopulation& out, std::string& error);
+
+    size_t size() const { return latency_ns_.size(); }
+    bool listed() const { return size() <= kListedTraders; }
+    static int id_of(size_t index) { return static_cast<int>(index) + 1; }
+    TimeNs latency(size_t index) const { return latency_ns_[index]; }
+    float aggressiveness(size_t index) const { return aggressiveness_[index]; }
+
+    // Next submitter, weighted by order rate: O(1). With equal rates this
+    // is a single uniform draw, so seeded streams over a listed population
+    // match the ones drawn from a plain trader vector.
+    template <class Rng>
+    size_t pick(Rng& rng) const {
+        size_t column = std::uniform_int_distribution<size_t>(0, size() - 1)(rng);
+        if (uniform_rates_) return column;
+        return std::uniform_real_distribution<float>(0.0f, 1.0f)(rng) < prob_[column] ? column : alias_[column];
+    }
+
+    // Base latency plus this order's jitter (no draw when it has none)
+    template <class Rng>
+    TimeNs sample_latency(size_t index, Rng& rng) const {
+        if (jitter_ns_[index] == 0) return latency_ns_[index];
+        return latency_ns_[index] + std::uniform_int_distribution<uint32_t>(0, jitter_ns_[index])(rng);
+    }
+
+    // Traders as reported: every trader when listed, else one per decile
+    // (ids 1..kCohorts, latency the decile's median)
+    const std::vector<Trader>& report_traders() const { return report_; }
+    // Tallies regrouped to report_traders() ids; listed populations pass through
+    MetricsSnapshot report(const MetricsSnapshot& snap) const;
+    // Position in report_traders() that trader_id is reported under, -1 if none
+    int report_index(int trader_id) const {
+        if (trader_id < 1 || static_cast<size_t>(trader_id) > size()) return -1;
+        return listed() ? trader_id - 1 : cohort_[trader_id - 1];
+    }
+
+    std::string describe() const;
+
+private:
+    std::vector<TimeNs> latency_ns_;
+    std::vector<uint32_t> jitter_ns_;
+    std::vector<float> aggressiveness_;
+    std::vector<float> prob_;            // alias table over order rates
+    std::vector<uint32_t> alias_;
+    std::vector<uint8_t> cohort_;        // decile per trader, unlisted only
+    std::vector<Trader> report_;
+    bool uniform_rates_;
+
+    // Builds the alias table, deciles and report list once the arrays are set
+    void finish(const std::vector<double>& rates, std::vector<std::string> names);
+};
@@ -4,25 +4,130 @@
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <algorithm>
 #include <random>
+#include <fstream>
 #include "core/OrderEvent.h"
+#include "core/Clock.h"
+#include "metrics/PipelineStats.h"
+#include "archive/ColumnArchive.h"
+#include "engine/MarketData.h"
+#include "simulation/ABReplay.h"
+#include "batching/BatchColumns.h"
+#include "core/WorkStealingPool.h"
+#include "core/HugePages.h"
+#include "core/JobExecutor.h"
+#include "simulation/SimulationRun.h"
+#ifdef FAIRORDER_HAS_GATEWAY
+#include "gateway/OrderGateway.h"
+#endif
+#ifdef FAIRORDER_HAS_SHM
+#include "ipc/ShmIngress.h"
+#endif
 
-static TimeNs now_ns() {
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()
-    ).count();
-}
+// While a run is in progress, prints one line per interval from a separate
+// thread. It only reads metrics snapshots, so matching is never paused.
+class LiveMonitor {
+public:
+    LiveMonitor(const FairnessMetrics& metrics, const TraderPopulation& traders, TimeNs interval)
+        : metrics_(metrics), traders_(traders), interval_(interval), stopping_(false) {
+        if (interval_ > 0) thread_ = std::thread(&LiveMonitor::loop, this);
+    }
+    ~LiveMonitor() { stop(); }
+    
+    void stop() {
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+private:
+    const FairnessMetrics& metrics_;
+    const TraderPopulation& traders_;
+    TimeNs interval_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    
+    void loop() {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, std::chrono::nanoseconds(interval_), [&] { return stopping_; })) {
+            MetricsSnapshot snap = traders_.report(metrics_.snapshot());
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "\n[live " << secs << "s] trades " << snap.trade_count
+                 << ", fairness " << std::setprecision(3) << snap.fairness_index()
+                 << ", Jain " << snap.indices.jain << ", Gini " << snap.indices.gini
+                 << ", latency advantage reduction " << std::setprecision(1)
+                 << (snap.latency_advantage_reduction(traders_.report_traders()) * 100) << "%\n";
+            std::cout << line.str() << std::flush;
+        }
+    }
+};
+
+// A simulate or experiment submitted with `bg`, with its own engines
+struct BackgroundRun {
+    struct Lane {
+        MatchingMode mode;
+        std::unique_ptr<MatchingEngine> engine;
+        std::vector<uint64_t> batch_latencies_ns;
+        double elapsed_ms = 0;
+    };
+    
+    std::string command;          // "simulate" or "experiment"
+    uint64_t num_orders = 0;
+    BatchPolicy policy;
+    TraderPopulation traders;
+    OrderMix order_mix;
+    std::vector<Lane> lanes;      // fixed before the job is submitted
+    std::atomic<size_t> active_lane{0};
+    std::shared_ptr<Job> job;
+    bool collected = false;       // results moved into results_
+};
 
 CLI::CLI() 
     : current_mode_(MatchingMode::LATENCY_FAIR_BATCHED),
-      batch_window_ns_(100'000),  // 100 microseconds
+      batch_policy_(),  // 100 microseconds, unbounded batches
+      batch_timestamps_(false),
+      band_low_(0),
+      band_high_(-1),
       engine_(nullptr),
       batcher_(nullptr),
-      simulator_() {
-    traders_ = simulator_.create_standard_traders();
-    engine_ = new MatchingEngine(current_mode_);
-    batcher_ = new MicroBatcher(batch_window_ns_);
+      archive_(nullptr),
+      fanout_(nullptr),
+      market_data_(new MarketDataBuilder()),
+      fanout_capacity_(0),
+      record_outcomes_(false),
+      sort_pool_(nullptr),
+      parallel_sort_threshold_(65536),
+      book_reserve_(0),
+      rolling_config_(),
+      rolling_enabled_(true),
+      monitor_interval_(0),
+      jobs_(nullptr),
+      simulator_(),
+      command_failed_(false) {
+    population_ = TraderPopulation::from_traders(simulator_.create_standard_traders());
+    rebuild_engine();
+    batcher_ = new MicroBatcher(batch_policy_);
+}
+
+CLI::~CLI() {
+    delete jobs_;   // stops running jobs before their engines go away
+    delete fanout_;
+    delete market_data_;
+    delete engine_;
+    delete batcher_;
+    delete archive_;
+    delete sort_pool_;
 }
 
 void CLI::print_banner() {
@@ -42,12 +147,89 @@ void CLI::print_help() {
 Available Commands:
   help              - Show this help message
   menu              - Show main menu
-  mode <naive|fair> - Set matching mode (naive = price-time, fair = batched)
-  window <time>     - Set batch window (e.g., 100us, 1ms)
+  mode <naive|fair|bump>
+                    - Set matching mode (naive = price-time, matched on
+                      arrival; fair = batched,
+                      bump = per-trader delay to the slowest latency, then
+                      continuous matching in 10us release ticks)
+  window <time>     - Set batch window (e.g., 100us, 1ms); in naive mode,
+                      same-level arrivals this close compete
+  batchcap <N>      - Seal batches early at N events (0 = unbounded)
+  admission [pending <N>] [bytes <N>] [trader <N>] [overflow <reject|defer|block>] | off
+                    - Bound the orders the batcher holds, the bytes per
+                      batch and each trader's orders per batch (0 = no
+                      limit); overflow rejects, defers to a later batch or
+                      blocks the producer until the batch is matched. No
+                      argument shows the limits and counts of the last run
+  adaptive <on|off> [min] [max]
+                    - Adapt batch window to arrival rate within bounds
+  timestamps <order|batch>
+                    - Stamp trades per matched order or once per batch
+  band <low> <high> | band off
+                    - Store book levels directly indexed over a price band
+                      (out-of-band prices fall back to heaps)
+  parsort <threads|off> [threshold]
+                    - Sort batches of at least threshold (default 65536)
+                      marketable orders on a work-stealing pool
+  rolling [on|off | time <interval> [buckets] | batches <N> [buckets] | traders <slots>]
+                    - Shape the fixed-size rolling windows (default 100 x
+                      10ms and 100 x 100 batches, 1024 trader slots per
+                      bucket)
+  series <time|batches> [file.csv]
+                    - Per-bucket throughput, latency and fairness of the
+                      rolling window, or per-trader rows as CSV
+  population [standard | load <file.csv> | <N> [latency=<model>] [jitter=<t>]
+             [rates=<sigma>] [aggr=<F>] [seed=S]]
+                    - Simulated traders: the standard four, a CSV of
+                      latency_ns[,jitter_ns,rate,aggressiveness,name], or N
+                      generated (model fixed:<t> | uniform:<lo>:<hi> |
+                      normal:<mean>:<sd> | lognormal:<median>[:sigma] |
+                      exp:<mean> | tiers:<t>@<share>,...[:sigma]); more than
+                      16 traders are reported by latency decile
+  ordertypes [ioc=F] [fok=F] [market=F] | off
+                    - Share of generated orders that are IOC, FOK or
+                      market (IOC); the rest are GTC limit orders
+  memory [huge <on|off> | node <N|local|off> | prefault <on|off> | reserve <N>]
+                    - Back large book and ring memory with 2MB pages, bind
+                      it to a NUMA node, prefault it, and pre-size the book
+                      for N resting orders per side; no argument shows status
   simulate <N>      - Run simulation with N orders
-  experiment        - Run comparative experiment (naive vs fair)
-  metrics           - Show current fairness metrics
+  experiment [N] [boot=R]
+                    - Run comparative experiment (naive vs fair) with 95%
+                      intervals from R bootstrap replicates over the runs'
+                      contested batches (default 1000, 0 = point estimates)
+  compare <N|file> [variant ...] [seed=S]
+                    - Replay one order stream (N generated orders or an
+                      archive) through several engines in parallel and
+                      diff their fills; variant = naive|fair[:window]|
+                      bump[:tick], default 'naive fair'
+  metrics [job]     - Show current fairness metrics (of a background job)
+  monitor <interval|off>
+                    - Print live fairness metrics every interval during
+                      simulate, gateway and shm runs
   book              - Show order book state
+  stats [reset]     - Show per-stage pipeline timings and counters
+  archive <file|off>
+                    - Write orders and trades of later runs to a compressed
+                      columnar archive instead of keeping trades in memory
+  archive scan <file> [column]
+                    - Summarize an archive, decoding one column or all
+  fanout [on [capacity] | off]
+                    - Publish fills, book updates and batch marks to a
+                      ring read by metrics, journal and market-data
+                      threads instead of recording them on the matching
+                      thread; no argument shows consumer lag
+  gateway <port> [duration]
+                    - Accept binary orders over TCP (default 30s)
+  shm <name> [duration] [latency]
+                    - Accept orders from trader processes over shared
+                      memory; 'latency' delays each trader's slot by its
+                      simulated latency
+  bg <simulate|experiment> [N]
+                    - Run in the background on a separate engine
+  jobs              - List background jobs with progress and ETA
+  cancel <job>      - Stop a queued or running background job
+  wait [job]        - Block until one or all background jobs finish
   reset             - Reset engine and metrics
   quit/exit         - Exit the program
 
@@ -64,7 +246,7 @@ void CLI::print_menu() {
     std::cout << "                         MAIN MENU                                \n";
     std::cout << "--------------------------------------------------------------------\n";
     std::cout << " Current Mode: " << std::setw(20) << std::left << mode_to_string(current_mode_) << "                    \n";
-    std::cout << " Batch Window: " << std::setw(20) << std::left << (std::to_string(batch_window_ns_ / 1000) + "us") << "                    \n";
+    std::cout << " Batch Window: " << std::setw(20) << std::left << (std::to_string(batch_policy_.window_ns / 1000) + "us") << "                    \n";
     std::cout << "--------------------------------------------------------------------\n";
     std::cout << " 1. Run Simulation (1000 orders)                                \n";
     std::cout << " 2. Run Comparative Experiment (Naive vs Fair)                   \n";
@@ -86,70 +268,238 @@ void CLI::run() {
     std::string input;
     while (true) {
         std::cout << "\n> ";
-        std::getline(std::cin, input);
+        if (!std::getline(std::cin, input)) break;
         
         if (input.empty()) continue;
+        if (!execute_command(input)) break;
+    }
+}
+
+int CLI::run_batch(const std::vector<std::string>& commands, const BatchOptions& options) {
+    // Human-readable output is discarded in quiet mode; results still go to
+    // the real stdout when no output file is given
+    std::ostream results_out(std::cout.rdbuf());
+    std::ostringstream discard;
+    std::streambuf* saved = std::cout.rdbuf();
+    if (options.quiet) {
+        std::cout.rdbuf(discard.rdbuf());
+        batch_policy_.log_batches = false;
+        delete batcher_;
+        batcher_ = new MicroBatcher(batch_policy_);
+    }
+    
+    int status = 0;
+    for (const auto& line : commands) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
         
-        std::istringstream iss(input);
-        std::string cmd;
-        iss >> cmd;
-        
-        if (cmd == "quit" || cmd == "exit" || cmd == "9") {
-            std::cout << "Exiting...\n";
+        command_failed_ = false;
+        bool keep_going = execute_command(line.substr(first));
+        if (command_failed_) {
+            std::cerr << "error: command failed: " << line << "\n";
+            status = 1;
             break;
-        } else if (cmd == "help" || cmd == "8") {
-            print_help();
-        } else if (cmd == "menu") {
-            print_menu();
-        } else if (cmd == "mode" || cmd == "3") {
-            std::string mode_str;
-            if (cmd == "3") {
-                std::cout << "Enter mode (naive/fair): ";
-                std::getline(std::cin, mode_str);
-            } else {
-                iss >> mode_str;
-            }
-            set_mode(mode_str);
-        } else if (cmd == "window" || cmd == "4") {
-            std::string window_str;
-            if (cmd == "4") {
-                std::cout << "Enter batch window (e.g., 100us): ";
-                std::getline(std::cin, window_str);
-            } else {
-                iss >> window_str;
+        }
+        if (!keep_going) break;
+        discard.str("");
+    }
+    
+    // Results of background jobs belong to the batch too
+    if (status == 0 && jobs_) {
+        jobs_->wait(-1);
+        collect_jobs();
+    }
+    
+    std::cout.rdbuf(saved);
+    
+    if (options.output_path.empty()) {
+        ResultWriter::write(results_out, options.format, results_);
+    } else {
+        std::ofstream file(options.output_path);
+        if (!file) {
+            std::cerr << "error: cannot open " << options.output_path << " for writing\n";
+            return 1;
+        }
+        ResultWriter::write(file, options.format, results_);
+    }
+    return status;
+}
+
+bool CLI::execute_command(const std::string& input) {
+    std::istringstream iss(input);
+    std::string cmd;
+    iss >> cmd;
+    
+    // Report background jobs that finished since the last command
+    collect_jobs();
+    
+    if (cmd == "quit" || cmd == "exit" || cmd == "9") {
+        std::cout << "Exiting...\n";
+        return false;
+    } else if (cmd == "help" || cmd == "8") {
+        print_help();
+    } else if (cmd == "menu") {
+        print_menu();
+    } else if (cmd == "mode" || cmd == "3") {
+        std::string mode_str;
+        if (cmd == "3") {
+            std::cout << "Enter mode (naive/fair/bump): ";
+            std::getline(std::cin, mode_str);
+        } else {
+            iss >> mode_str;
+        }
+        set_mode(mode_str);
+    } else if (cmd == "window" || cmd == "4") {
+        std::string window_str;
+        if (cmd == "4") {
+            std::cout << "Enter batch window (e.g., 100us): ";
+            std::getline(std::cin, window_str);
+        } else {
+            iss >> window_str;
+        }
+        set_batch_window(window_str);
+    } else if (cmd == "batchcap") {
+        std::string cap_str;
+        iss >> cap_str;
+        set_batch_cap(cap_str);
+    } else if (cmd == "admission") {
+        std::string args;
+        std::getline(iss, args);
+        set_admission(args);
+    } else if (cmd == "adaptive") {
+        std::string args;
+        std::getline(iss, args);
+        set_adaptive_window(args);
+    } else if (cmd == "timestamps") {
+        std::string stamp_str;
+        iss >> stamp_str;
+        set_timestamps(stamp_str);
+    } else if (cmd == "band") {
+        std::string args;
+        std::getline(iss, args);
+        set_price_band(args);
+    } else if (cmd == "parsort") {
+        std::string args;
+        std::getline(iss, args);
+        set_parallel_sort(args);
+    } else if (cmd == "monitor") {
+        std::string interval_str;
+        iss >> interval_str;
+        set_monitor(interval_str);
+    } else if (cmd == "memory") {
+        std::string args;
+        std::getline(iss, args);
+        set_memory(args);
+    } else if (cmd == "rolling") {
+        std::string args;
+        std::getline(iss, args);
+        set_rolling(args);
+    } else if (cmd == "series") {
+        std::string args;
+        std::getline(iss, args);
+        show_series(args);
+    } else if (cmd == "population") {
+        std::string args;
+        std::getline(iss, args);
+        set_population(args);
+    } else if (cmd == "ordertypes") {
+        std::string args;
+        std::getline(iss, args);
+        set_order_mix(args);
+    } else if (cmd == "simulate" || cmd == "1") {
+        std::string num_str;
+        if (cmd == "1") {
+            std::cout << "Enter number of orders (default 1000): ";
+            std::getline(std::cin, num_str);
+        } else {
+            iss >> num_str;
+        }
+        uint64_t num_orders = 1000;
+        if (!num_str.empty()) {
+            if (num_str.size() >= 10 || num_str.find_first_not_of("0123456789") != std::string::npos) {
+                std::cout << "Usage: simulate <N>  (N orders, up to 999999999)\n";
+                command_failed_ = true;
+                return true;
             }
-            set_batch_window(window_str);
-        } else if (cmd == "simulate" || cmd == "1") {
-            int num_orders = 1000;
-            if (cmd == "1") {
-                std::cout << "Enter number of orders (default 1000): ";
-                std::string num_str;
-                std::getline(std::cin, num_str);
-                if (!num_str.empty()) {
-                    num_orders = std::stoi(num_str);
-                }
+            num_orders = std::stoull(num_str);
+        }
+        run_simulation(num_orders);
+    } else if (cmd == "experiment" || cmd == "2") {
+        int num_orders = 1000;
+        size_t replicates = 1000;
+        std::string token;
+        while (iss >> token) {
+            if (token.rfind("boot=", 0) == 0 && token.size() > 5 && token.size() < 12 &&
+                token.find_first_not_of("0123456789", 5) == std::string::npos) {
+                replicates = std::stoul(token.substr(5));
+            } else if (!token.empty() && token.size() < 10 && token.find_first_not_of("0123456789") == std::string::npos) {
+                num_orders = std::stoi(token);
             } else {
-                iss >> num_orders;
+                std::cout << "Usage: experiment [N] [boot=R]  (R bootstrap replicates, 0 = none)\n";
+                command_failed_ = true;
+                return true;
             }
-            run_simulation(num_orders);
-        } else if (cmd == "experiment" || cmd == "2") {
-            run_experiment();
-        } else if (cmd == "metrics" || cmd == "5") {
-            show_metrics();
-        } else if (cmd == "book" || cmd == "6") {
-            show_order_book();
-        } else if (cmd == "reset" || cmd == "7") {
-            reset();
+        }
+        run_experiment(num_orders, replicates);
+    } else if (cmd == "compare") {
+        std::string args;
+        std::getline(iss, args);
+        run_compare(args);
+    } else if (cmd == "metrics" || cmd == "5") {
+        std::string job_str;
+        iss >> job_str;
+        show_metrics(job_str);
+    } else if (cmd == "book" || cmd == "6") {
+        show_order_book();
+    } else if (cmd == "stats") {
+        std::string arg;
+        iss >> arg;
+        if (arg == "reset") {
+            PipelineStats::reset();
+            std::cout << "Pipeline statistics reset.\n";
         } else {
-            std::cout << "Unknown command. Type 'help' for available commands.\n";
+            show_stats();
         }
+    } else if (cmd == "archive") {
+        std::string args;
+        std::getline(iss, args);
+        set_archive(args);
+    } else if (cmd == "fanout") {
+        std::string args;
+        std::getline(iss, args);
+        set_fanout(args);
+    } else if (cmd == "gateway") {
+        std::string port_str, duration_str;
+        iss >> port_str >> duration_str;
+        run_gateway(port_str, duration_str);
+    } else if (cmd == "shm") {
+        std::string name, duration_str, latency_str;
+        iss >> name >> duration_str >> latency_str;
+        run_shm_ingress(name, duration_str, latency_str == "latency");
+    } else if (cmd == "bg") {
+        std::string args;
+        std::getline(iss, args);
+        start_job(args);
+    } else if (cmd == "jobs") {
+        show_jobs();
+    } else if (cmd == "cancel") {
+        std::string id_str;
+        iss >> id_str;
+        cancel_job(id_str);
+    } else if (cmd == "wait") {
+        std::string id_str;
+        iss >> id_str;
+        wait_jobs(id_str);
+    } else if (cmd == "reset" || cmd == "7") {
+        reset();
+    } else {
+        std::cout << "Unknown command. Type 'help' for available commands.\n";
+        command_failed_ = true;
     }
-    
-    delete engine_;
-    delete batcher_;
+    return true;
 }
 
-void CLI::run_simulation(int num_orders) {
+void CLI::run_simulation(uint64_t num_orders, const std::string& label) {
     std::cout << "\n====================================================================\n";
     std::cout << " Running Simulation: " << std::setw(40) << std::left << (std::to_string(num_orders) + " orders") << " \n";
     std::cout << " Mode: " << std::setw(52) << std::left << mode_to_string(current_mode_) << " \n";
@@ -157,176 +507,235 @@ void CLI::run_simulation(int num_orders) {
     
     reset();
     
-    Price center_price = 100;
-    Qty base_qty = 10;
-    OrderID next_order_id = 1;
+    std::cout << "\nGenerating and processing orders...\n";
     
-    std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<size_t> trader_dist(0, traders_.size() - 1);
+    LiveMonitor monitor(engine_->get_metrics(), population_, monitor_interval_);
+    auto run_start = std::chrono::steady_clock::now();
+    run_simulated_flow(*engine_, *batcher_, simulator_, population_, num_orders, batch_latencies_ns_, nullptr, true);
+    monitor.stop();
     
-    std::cout << "\nGenerating and processing orders...\n";
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - run_start).count();
+    record_result(label, num_orders, elapsed_ms);
     
-    for (int i = 0; i < num_orders; ++i) {
-        // Pick random trader
-        size_t trader_idx = trader_dist(rng);
-        const auto& trader = traders_[trader_idx];
-        
-        // Generate order
-        auto params = simulator_.generate_order(trader, center_price, base_qty);
-        
-        // Create order event
-        TimeNs base_time = now_ns();
-        TimeNs recv_time = trader.apply_latency(base_time);
-        
-        OrderEvent ev;
-        ev.type = EventType::NEW;
-        ev.order_id = next_order_id++;
-        ev.instrument = "STOCK";
-        ev.side = params.side;
-        ev.price = params.price;
-        ev.qty = params.qty;
-        ev.recv_time = recv_time;
-        ev.trader_id = trader.id;
-        
-        // Process based on mode
-        if (current_mode_ == MatchingMode::LATENCY_FAIR_BATCHED) {
-            batcher_->submit(std::move(ev));
-            
-            // Check for ready batches
-            while (batcher_->has_ready_batch()) {
-                auto batch = batcher_->pop_batch();
-                std::vector<int> trader_ids;
-                trader_ids.reserve(batch.size());
-                for (const auto& order : batch) {
-                    trader_ids.push_back(order.trader_id);
-                }
-                engine_->process_batch(batch, trader_ids);
-            }
-        } else {
-            // Naive mode: also batch orders to detect competitions, but process in recv_time order
-            batcher_->submit(std::move(ev));
-            
-            // Check for ready batches
-            while (batcher_->has_ready_batch()) {
-                auto batch = batcher_->pop_batch();
-                // Sort by recv_time for naive mode (price-time priority)
-                std::vector<std::pair<OrderEvent, int>> orders_with_traders;
-                for (const auto& order : batch) {
-                    orders_with_traders.push_back({order, order.trader_id});
-                }
-                
-                // Sort by price (best first), then recv_time
-                std::sort(orders_with_traders.begin(), orders_with_traders.end(),
-                    [](const auto& a, const auto& b) {
-                        const auto& ev_a = a.first;
-                        const auto& ev_b = b.first;
-                        
-                        if (ev_a.side != ev_b.side) return ev_a.side == Side::BUY;
-                        
-                        if (ev_a.side == Side::BUY) {
-                            if (ev_a.price != ev_b.price) return ev_a.price > ev_b.price;
-                            return ev_a.recv_time < ev_b.recv_time;
-                        } else {
-                            if (ev_a.price != ev_b.price) return ev_a.price < ev_b.price;
-                            return ev_a.recv_time < ev_b.recv_time;
-                        }
-                    });
-                
-                // Extract sorted batch and trader IDs
-                std::vector<OrderEvent> sorted_batch;
-                std::vector<int> trader_ids;
-                sorted_batch.reserve(orders_with_traders.size());
-                trader_ids.reserve(orders_with_traders.size());
-                
-                for (const auto& [order, trader_id] : orders_with_traders) {
-                    sorted_batch.push_back(order);
-                    trader_ids.push_back(trader_id);
-                }
-                
-                engine_->process_batch(sorted_batch, trader_ids);
-            }
-        }
-        
-        // Small delay to simulate real-time arrival
-        std::this_thread::sleep_for(std::chrono::microseconds(1));
-        
-        if ((i + 1) % 100 == 0) {
-            std::cout << "Processed " << (i + 1) << " orders...\r" << std::flush;
-        }
+    std::cout << "\n\nSimulation complete!\n";
+    show_metrics();
+}
+
+void CLI::run_gateway(const std::string& port_str, const std::string& duration_str) {
+#ifdef FAIRORDER_HAS_GATEWAY
+    if (current_mode_ == MatchingMode::SPEED_BUMP) {
+        // Live ingress feeds the batcher and has no per-trader latency estimate
+        std::cout << "Speed-bump mode is not supported by the gateway; use naive or fair\n";
+        command_failed_ = true;
+        return;
+    }
+    if (port_str.empty() || port_str.find_first_not_of("0123456789") != std::string::npos) {
+        std::cout << "Usage: gateway <port> [duration]  (e.g., gateway 9000 30s)\n";
+        command_failed_ = true;
+        return;
+    }
+    TimeNs duration = duration_str.empty() ? 30'000'000'000ULL : parse_time_string(duration_str);
+    if (duration == 0) {
+        std::cout << "Invalid time format. Use format like '30s' or '500ms'\n";
+        command_failed_ = true;
+        return;
     }
     
-    // Flush any remaining batch
-    if (!batcher_->has_ready_batch()) {
-        // Force flush
-        auto batch = batcher_->pop_batch();
-        if (!batch.empty()) {
-            if (current_mode_ == MatchingMode::LATENCY_FAIR_BATCHED) {
-                std::vector<int> trader_ids;
-                trader_ids.reserve(batch.size());
-                for (const auto& order : batch) {
-                    trader_ids.push_back(order.trader_id);
-                }
-                engine_->process_batch(batch, trader_ids);
-            } else {
-                // Naive mode: sort by recv_time
-                std::vector<std::pair<OrderEvent, int>> orders_with_traders;
-                for (const auto& order : batch) {
-                    orders_with_traders.push_back({order, order.trader_id});
-                }
-                
-                std::sort(orders_with_traders.begin(), orders_with_traders.end(),
-                    [](const auto& a, const auto& b) {
-                        const auto& ev_a = a.first;
-                        const auto& ev_b = b.first;
-                        
-                        if (ev_a.side != ev_b.side) return ev_a.side == Side::BUY;
-                        
-                        if (ev_a.side == Side::BUY) {
-                            if (ev_a.price != ev_b.price) return ev_a.price > ev_b.price;
-                            return ev_a.recv_time < ev_b.recv_time;
-                        } else {
-                            if (ev_a.price != ev_b.price) return ev_a.price < ev_b.price;
-                            return ev_a.recv_time < ev_b.recv_time;
-                        }
-                    });
-                
-                std::vector<OrderEvent> sorted_batch;
-                std::vector<int> trader_ids;
-                sorted_batch.reserve(orders_with_traders.size());
-                trader_ids.reserve(orders_with_traders.size());
-                
-                for (const auto& [order, trader_id] : orders_with_traders) {
-                    sorted_batch.push_back(order);
-                    trader_ids.push_back(trader_id);
-                }
-                
-                engine_->process_batch(sorted_batch, trader_ids);
-            }
+    reset();
+    
+    OrderGateway gateway(*engine_, *batcher_);
+    if (!gateway.listen(static_cast<uint16_t>(std::stoi(port_str)))) {
+        std::cout << "Gateway failed to start: " << gateway.last_error() << "\n";
+        command_failed_ = true;
+        return;
+    }
+    
+    std::cout << "Gateway listening on port " << port_str << " for "
+              << (duration / 1'000'000) << "ms (mode: " << mode_to_string(current_mode_) << ")\n";
+    LiveMonitor monitor(engine_->get_metrics(), population_, monitor_interval_);
+    auto run_start = std::chrono::steady_clock::now();
+    gateway.run(duration);
+    monitor.stop();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - run_start).count();
+    
+    const auto& gs = gateway.stats();
+    std::cout << "\n========================================\n";
+    std::cout << "          GATEWAY SUMMARY             \n";
+    std::cout << "----------------------------------------\n";
+    std::cout << " Connections:      " << std::setw(19) << gs.connections_accepted << " \n";
+    std::cout << " Messages in:      " << std::setw(19) << gs.messages_in << " \n";
+    std::cout << " Messages out:     " << std::setw(19) << gs.messages_out << " \n";
+    std::cout << " Orders accepted:  " << std::setw(19) << gs.orders_accepted << " \n";
+    std::cout << " Orders rejected:  " << std::setw(19) << gs.orders_rejected << " \n";
+    std::cout << " Fills sent:       " << std::setw(19) << gs.fills_sent << " \n";
+    std::cout << " Orders expired:   " << std::setw(19) << gs.orders_expired << " \n";
+    std::cout << " Batches:          " << std::setw(19) << gs.batches << " \n";
+    std::cout << " read() / send():  " << std::setw(19)
+              << (std::to_string(gs.read_calls) + " / " + std::to_string(gs.write_calls)) << " \n";
+    std::cout << "========================================\n";
+    
+    record_result("gateway", gs.orders_accepted, elapsed_ms);
+    results_.back().batches = gs.batches;
+    show_metrics();
+#else
+    (void)port_str;
+    (void)duration_str;
+    std::cout << "The TCP gateway is only available on Linux builds.\n";
+    command_failed_ = true;
+#endif
+}
+
+void CLI::run_shm_ingress(const std::string& name, const std::string& duration_str, bool apply_latency) {
+#ifdef FAIRORDER_HAS_SHM
+    if (current_mode_ == MatchingMode::SPEED_BUMP) {
+        // Live ingress feeds the batcher and has no per-trader latency estimate
+        std::cout << "Speed-bump mode is not supported by the shared-memory ingress; use naive or fair\n";
+        command_failed_ = true;
+        return;
+    }
+    if (name.empty()) {
+        std::cout << "Usage: shm <name> [duration] [latency]  (e.g., shm fairorder 30s latency)\n";
+        command_failed_ = true;
+        return;
+    }
+    TimeNs duration = duration_str.empty() ? 30'000'000'000ULL : parse_time_string(duration_str);
+    if (duration == 0) {
+        std::cout << "Invalid time format. Use format like '30s' or '500ms'\n";
+        command_failed_ = true;
+        return;
+    }
+    
+    reset();
+    
+    // One slot per simulated trader; slot i serves trader id i + 1
+    if (!population_.listed()) {
+        std::cout << "Shared-memory ingress needs one slot per trader; use a population of at most "
+                  << TraderPopulation::kListedTraders << " traders\n";
+        command_failed_ = true;
+        return;
+    }
+    ShmSegment segment;
+    if (!segment.create(name, static_cast<uint32_t>(population_.size()), 1 << 16)) {
+        std::cout << "Shared-memory ingress failed to start: " << segment.last_error() << "\n";
+        command_failed_ = true;
+        return;
+    }
+    
+    if (!segment.placement().empty()) {
+        std::cout << "Segment memory: " << segment.placement() << "\n";
+    }
+    
+    ShmIngress ingress(*engine_, *batcher_, segment);
+    if (apply_latency) {
+        for (size_t i = 0; i < population_.size(); ++i) {
+            ingress.set_slot_delay(static_cast<uint32_t>(i), population_.latency(i));
         }
     }
     
-    std::cout << "\n\nSimulation complete!\n";
+    std::cout << "Shared-memory ingress '" << name << "' ready: " << population_.size() << " trader slots, "
+              << (duration / 1'000'000) << "ms, latency model " << (apply_latency ? "on" : "off") << "\n";
+    LiveMonitor monitor(engine_->get_metrics(), population_, monitor_interval_);
+    auto run_start = std::chrono::steady_clock::now();
+    ingress.run(duration);
+    monitor.stop();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - run_start).count();
+    
+    const auto& st = ingress.stats();
+    std::cout << "\n========================================\n";
+    std::cout << "       SHARED-MEMORY INGRESS SUMMARY    \n";
+    std::cout << "----------------------------------------\n";
+    std::cout << " Messages in:      " << std::setw(19) << st.messages_in << " \n";
+    std::cout << " Messages out:     " << std::setw(19) << st.messages_out << " \n";
+    std::cout << " Orders accepted:  " << std::setw(19) << st.orders_accepted << " \n";
+    std::cout << " Orders rejected:  " << std::setw(19) << st.orders_rejected << " \n";
+    std::cout << " Orders delayed:   " << std::setw(19) << st.delayed << " \n";
+    std::cout << " Fills sent:       " << std::setw(19) << st.fills_sent << " \n";
+    std::cout << " Orders expired:   " << std::setw(19) << st.orders_expired << " \n";
+    std::cout << " Batches:          " << std::setw(19) << st.batches << " \n";
+    std::cout << " Outbound stalls:  " << std::setw(19) << st.outbound_stalls << " \n";
+    std::cout << "========================================\n";
+    
+    record_result("shm", st.orders_accepted, elapsed_ms);
+    results_.back().batches = st.batches;
     show_metrics();
+#else
+    (void)name;
+    (void)duration_str;
+    (void)apply_latency;
+    std::cout << "Shared-memory ingress is only available on Linux builds.\n";
+    command_failed_ = true;
+#endif
 }
 
-void CLI::run_experiment() {
+void CLI::record_result(const std::string& label, uint64_t num_orders, double elapsed_ms) {
+    if (fanout_) fanout_->flush();
+    results_.push_back(build_result(label, current_mode_, batch_policy_, engine_->get_metrics(), population_,
+                                    num_orders, elapsed_ms, batch_latencies_ns_));
+}
+
+RunResult CLI::build_result(const std::string& label, MatchingMode mode, const BatchPolicy& policy,
+                            const FairnessMetrics& metrics, const TraderPopulation& population,
+                            uint64_t num_orders, double elapsed_ms,
+                            const std::vector<uint64_t>& batch_latencies_ns) const {
+    MetricsSnapshot snap = population.report(metrics.snapshot());
+    RunResult r;
+    r.run_id = static_cast<int>(results_.size()) + 1;
+    r.command = label;
+    r.mode = mode == MatchingMode::NAIVE_PRICE_TIME ? "naive"
+           : mode == MatchingMode::SPEED_BUMP ? "bump" : "fair";
+    r.window_ns = policy.window_ns;
+    r.max_batch_size = policy.max_batch_size;
+    r.adaptive_window = policy.adaptive;
+    r.orders = num_orders;
+    r.batches = batch_latencies_ns.size();
+    r.trades = snap.trade_count;
+    r.elapsed_ms = elapsed_ms;
+    r.throughput_ops = elapsed_ms > 0 ? num_orders / (elapsed_ms / 1000.0) : 0.0;
+    r.fairness_index = snap.fairness_index();
+    r.latency_advantage_reduction = snap.latency_advantage_reduction(population.report_traders());
+    r.jain_index = snap.indices.jain;
+    r.gini = snap.indices.gini;
+    r.min_win_rate = snap.indices.min_win_rate;
+    r.batch_latency = LatencySummary::from_samples(batch_latencies_ns);
+    r.pipeline = PipelineStats::snapshot();
+    r.traders = snap.trader_stats(population.report_traders());
+    return r;
+}
+
+void CLI::run_experiment(int num_orders, size_t replicates) {
     std::cout << "\n====================================================================\n";
     std::cout << "              COMPARATIVE EXPERIMENT: Naive vs Fair                \n";
     std::cout << "====================================================================\n";
     
-    int num_orders = 1000;
     std::cout << "\nRunning experiment with " << num_orders << " orders per mode...\n\n";
     
+    // Intervals come from resampling each run's contested batches; the
+    // replicates run on the sort pool, or a pool of our own without one
+    const double level = 0.95;
+    const uint64_t seed = 1;
+    WorkStealingPool* own_pool = nullptr;
+    WorkStealingPool* pool = sort_pool_;
+    if (!pool && replicates > 0 && std::thread::hardware_concurrency() > 1) {
+        own_pool = new WorkStealingPool(std::thread::hardware_concurrency() - 1);
+        pool = own_pool;
+    }
+    record_outcomes_ = replicates > 0;
+    
     // Test NAIVE mode
     std::cout << "--------------------------------------------------------------------\n";
     std::cout << "MODE: NAIVE (Price-Time Priority)\n";
     std::cout << "--------------------------------------------------------------------\n";
     current_mode_ = MatchingMode::NAIVE_PRICE_TIME;
-    delete engine_;
-    engine_ = new MatchingEngine(current_mode_);
-    run_simulation(num_orders);
-    auto naive_metrics = engine_->get_metrics();
-    auto naive_stats = naive_metrics.get_trader_stats(traders_);
+    rebuild_engine();
+    run_simulation(num_orders, "experiment");
+    const auto& traders = population_.report_traders();
+    MetricsSnapshot naive_metrics = population_.report(engine_->get_metrics().snapshot());
+    auto naive_stats = naive_metrics.trader_stats(traders);
+    BootstrapResult naive_ci = bootstrap_fairness(engine_->get_outcomes(), population_, replicates, level, seed, pool);
+    results_.back().confidence = naive_ci;
     
     std::cout << "\n\n";
     
@@ -335,60 +744,234 @@ void CLI::run_experiment() {
     std::cout << "MODE: FAIR (Latency-Fair Batched)\n";
     std::cout << "--------------------------------------------------------------------\n";
     current_mode_ = MatchingMode::LATENCY_FAIR_BATCHED;
-    delete engine_;
-    engine_ = new MatchingEngine(current_mode_);
+    rebuild_engine();
     delete batcher_;
-    batcher_ = new MicroBatcher(batch_window_ns_);
-    run_simulation(num_orders);
-    auto fair_metrics = engine_->get_metrics();
-    auto fair_stats = fair_metrics.get_trader_stats(traders_);
+    batcher_ = new MicroBatcher(batch_policy_);
+    run_simulation(num_orders, "experiment");
+    MetricsSnapshot fair_metrics = population_.report(engine_->get_metrics().snapshot());
+    auto fair_stats = fair_metrics.trader_stats(traders);
+    BootstrapResult fair_ci = bootstrap_fairness(engine_->get_outcomes(), population_, replicates, level, seed + 1, pool);
+    results_.back().confidence = fair_ci;
+    
+    record_outcomes_ = false;
+    engine_->set_record_outcomes(false);
+    delete own_pool;
+    
+    // Point estimates, with the bootstrap interval after each when there is one
+    bool intervals = naive_ci.replicates > 0 && fair_ci.replicates > 0;
+    auto cell = [&](double estimate, const ConfidenceInterval& ci, double scale, bool sign) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(scale > 1.0 ? 1 : 3) << (sign && estimate >= 0 ? "+" : "")
+            << estimate * scale;
+        if (intervals) oss << " [" << ci.low * scale << ", " << ci.high * scale << "]";
+        return oss.str();
+    };
+    int width = intervals ? 24 : 10;
+    auto row = [&](const std::string& name, const std::string& naive, const std::string& fair,
+                   const std::string& change) {
+        std::cout << " " << std::setw(24) << std::left << name << " | " << std::setw(width) << naive << " | "
+                  << std::setw(width) << fair << " | " << change << "\n" << std::right;
+    };
     
     // Comparison
     std::cout << "\n\n";
     std::cout << "====================================================================\n";
     std::cout << "                    EXPERIMENT RESULTS                            \n";
+    if (intervals) {
+        std::cout << " " << static_cast<int>(level * 100) << "% bootstrap intervals over " << naive_ci.batches
+                  << " / " << fair_ci.batches << " contested batches, " << replicates << " replicates\n";
+    }
     std::cout << "--------------------------------------------------------------------\n";
-    std::cout << " Metric                    | Naive Mode | Fair Mode | Improvement\n";
+    row("Metric", "Naive Mode", "Fair Mode", "Change (fair - naive)");
     std::cout << "--------------------------------------------------------------------\n";
     
-    double naive_fairness = naive_metrics.compute_fairness_index();
-    double fair_fairness = fair_metrics.compute_fairness_index();
-    double improvement = ((fair_fairness - naive_fairness) / (1.0 - naive_fairness)) * 100.0;
+    // Differences rather than "share of the gap closed", which is undefined
+    // once naive fairness reaches 1
+    double naive_fairness = naive_metrics.fairness_index();
+    double fair_fairness = fair_metrics.fairness_index();
+    ConfidenceInterval fairness_change = difference_interval(naive_ci.fairness_samples, naive_fairness,
+                                                             fair_ci.fairness_samples, fair_fairness, level);
+    row("Fairness Index", cell(naive_fairness, naive_ci.fairness_index, 1.0, false),
+        cell(fair_fairness, fair_ci.fairness_index, 1.0, false),
+        cell(fair_fairness - naive_fairness, fairness_change, 1.0, true));
     
-    std::cout << " Fairness Index            | " << std::setw(10) << std::fixed << std::setprecision(3) << naive_fairness
-              << " | " << std::setw(9) << fair_fairness << " | " << std::setw(10) << improvement << "%\n";
+    double naive_reduction = naive_metrics.latency_advantage_reduction(traders);
+    double fair_reduction = fair_metrics.latency_advantage_reduction(traders);
+    ConfidenceInterval reduction_change = difference_interval(naive_ci.reduction_samples, naive_reduction,
+                                                              fair_ci.reduction_samples, fair_reduction, level);
+    row("Latency Advantage (%)", cell(naive_reduction, naive_ci.latency_advantage_reduction, 100.0, false),
+        cell(fair_reduction, fair_ci.latency_advantage_reduction, 100.0, false),
+        cell(fair_reduction - naive_reduction, reduction_change, 100.0, true));
+    row("Reduction", "", "", "");
     
-    double naive_reduction = naive_metrics.compute_latency_advantage_reduction(traders_);
-    double fair_reduction = fair_metrics.compute_latency_advantage_reduction(traders_);
+    // Show trader win rates
+    std::cout << "--------------------------------------------------------------------\n";
+    std::cout << " Trader Win Rates (%):                                            \n";
     
-    std::cout << " Latency Advantage         | " << std::setw(10) << (naive_reduction * 100)
-              << " | " << std::setw(9) << (fair_reduction * 100) << " | " << std::setw(10) 
-              << ((fair_reduction - naive_reduction) * 100) << "%\n";
-    std::cout << " Reduction                 |            |           |            \n";
+    for (size_t i = 0; i < traders.size() && i < naive_stats.size() && i < fair_stats.size(); ++i) {
+        double naive_rate = naive_stats[i].win_rate;
+        double fair_rate = fair_stats[i].win_rate;
+        ConfidenceInterval naive_rate_ci = i < naive_ci.win_rates.size() ? naive_ci.win_rates[i] : ConfidenceInterval();
+        ConfidenceInterval fair_rate_ci = i < fair_ci.win_rates.size() ? fair_ci.win_rates[i] : ConfidenceInterval();
+        ConfidenceInterval change;
+        if (intervals) {
+            change = difference_interval(naive_ci.win_rate_samples[i], naive_rate, fair_ci.win_rate_samples[i],
+                                         fair_rate, level);
+        }
+        row(traders[i].name.substr(0, 24), cell(naive_rate, naive_rate_ci, 100.0, false),
+            cell(fair_rate, fair_rate_ci, 100.0, false), cell(fair_rate - naive_rate, change, 100.0, true));
+    }
     
-    // Show trader win rates
+    std::cout << "====================================================================\n";
+}
+
+void CLI::run_compare(const std::string& args) {
+    std::istringstream iss(args);
+    std::string source, token;
+    iss >> source;
+    
+    uint32_t seed = static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<ReplayVariant> variants;
+    while (iss >> token) {
+        if (token.rfind("seed=", 0) == 0) {
+            seed = static_cast<uint32_t>(std::stoul(token.substr(5)));
+            continue;
+        }
+        std::string mode_str = token.substr(0, token.find(':'));
+        if (mode_str != "naive" && mode_str != "fair" && mode_str != "bump") {
+            std::cout << "Unknown variant '" << token << "'. Use naive|fair[:window]|bump[:tick], e.g. fair:50us\n";
+            command_failed_ = true;
+            return;
+        }
+        MatchingMode mode;
+        parse_mode(mode_str, mode);
+        ReplayVariant v{token, mode, batch_policy_, band_low_, band_high_,
+                        sort_pool_, parallel_sort_threshold_};
+        v.traders = &population_;
+        if (token.find(':') != std::string::npos) {
+            // fair:<window> sets the batch window, bump:<tick> the wheel tick
+            TimeNs t = parse_time_string(token.substr(token.find(':') + 1));
+            if (t == 0) {
+                std::cout << "Invalid time in '" << token << "'. Use format like '100us' or '1ms'\n";
+                command_failed_ = true;
+                return;
+            }
+            (mode_str == "bump" ? v.bump_tick_ns : v.policy.window_ns) = t;
+        }
+        variants.push_back(std::move(v));
+    }
+    if (variants.empty()) {
+        variants.push_back({"naive", MatchingMode::NAIVE_PRICE_TIME, batch_policy_, band_low_, band_high_,
+                            sort_pool_, parallel_sort_threshold_});
+        variants.push_back({"fair", MatchingMode::LATENCY_FAIR_BATCHED, batch_policy_, band_low_, band_high_,
+                            sort_pool_, parallel_sort_threshold_});
+    }
+    
+    // Decode the stream once; every lane replays the same vector
+    std::vector<OrderEvent> stream;
+    if (source.empty()) {
+        std::cout << "Usage: compare <N|file> [variant ...] [seed=S]  (e.g., compare 10000 naive fair:50us)\n";
+        command_failed_ = true;
+        return;
+    } else if (source.find_first_not_of("0123456789") == std::string::npos) {
+        stream = ABReplay::generate_stream(population_, std::stoul(source), seed, 1'000, simulator_.get_order_mix());
+        std::cout << "\nGenerated " << stream.size() << " orders (seed " << seed << ")\n";
+    } else {
+        ArchiveReader reader;
+        if (!reader.open(source) || !reader.read_orders(stream)) {
+            std::cout << "Cannot replay " << source << ": " << reader.last_error() << "\n";
+            command_failed_ = true;
+            return;
+        }
+        // Ids restart with every archived run; renumber in stream order
+        for (size_t i = 0; i < stream.size(); ++i) {
+            stream[i].order_id = static_cast<OrderID>(i + 1);
+        }
+        std::cout << "\nLoaded " << stream.size() << " orders from " << source << "\n";
+    }
+    
+    ABReplay replay(std::move(variants));
+    replay.run(stream);
+    const auto& lanes = replay.lanes();
+    
+    std::cout << "\n====================================================================\n";
+    std::cout << "              SIDE-BY-SIDE REPLAY (" << lanes.size() << " engines, same input)\n";
+    std::cout << "--------------------------------------------------------------------\n";
+    std::cout << " Variant        | Batches |  Trades | Fairness |   LAR   | Engine ms\n";
+    std::cout << "--------------------------------------------------------------------\n";
+    const auto& traders = population_.report_traders();
+    for (const auto& lane : lanes) {
+        MetricsSnapshot m = population_.report(lane.engine->get_metrics().snapshot());
+        std::cout << " " << std::setw(14) << std::left << lane.variant.label << std::right
+                  << " | " << std::setw(7) << lane.batches
+                  << " | " << std::setw(7) << lane.trades
+                  << " | " << std::setw(8) << std::fixed << std::setprecision(3) << m.fairness_index()
+                  << " | " << std::setw(6) << std::setprecision(1)
+                  << (m.latency_advantage_reduction(traders) * 100) << "%"
+                  << " | " << std::setw(9) << std::setprecision(2) << lane.elapsed_ms << "\n";
+    }
     std::cout << "--------------------------------------------------------------------\n";
-    std::cout << " Trader Win Rates:                                                \n";
+    std::cout << " Wall time for all engines: " << std::setprecision(2) << replay.wall_ms() << " ms\n";
     
-    for (size_t i = 0; i < traders_.size() && i < naive_stats.size() && i < fair_stats.size(); ++i) {
-        std::cout << " " << std::setw(20) << std::left << traders_[i].name.substr(0, 20)
-                  << " | " << std::setw(10) << (naive_stats[i].win_rate * 100) << "%"
-                  << " | " << std::setw(9) << (fair_stats[i].win_rate * 100) << "%"
-                  << " | " << std::setw(10) << ((fair_stats[i].win_rate - naive_stats[i].win_rate) * 100) << "%\n";
+    // Paired per-trader comparison against the first variant
+    std::cout << "--------------------------------------------------------------------\n";
+    std::cout << " Win rate by trader (delta vs " << lanes[0].variant.label << "):\n";
+    std::vector<std::vector<TraderStats>> stats;
+    for (const auto& lane : lanes) {
+        stats.push_back(population_.report(lane.engine->get_metrics().snapshot()).trader_stats(traders));
+    }
+    for (size_t t = 0; t < traders.size(); ++t) {
+        std::cout << " " << std::setw(22) << std::left << traders[t].name.substr(0, 22) << std::right;
+        for (size_t l = 0; l < lanes.size(); ++l) {
+            std::cout << " | " << std::setw(6) << std::setprecision(1) << (stats[l][t].win_rate * 100) << "%";
+            if (l > 0) {
+                std::cout << " (" << std::showpos << ((stats[l][t].win_rate - stats[0][t].win_rate) * 100)
+                          << std::noshowpos << ")";
+            }
+        }
+        std::cout << "\n";
     }
     
+    // Per-batch fill diff, batches as formed by the first batching variant
+    auto diffs = replay.batch_diffs();
+    const auto& ref = lanes[replay.reference_lane()];
+    std::cout << "--------------------------------------------------------------------\n";
+    std::cout << " Batches with different fills: " << diffs.size() << " of " << ref.batches
+              << " (as formed by " << ref.variant.label << ")\n";
+    for (size_t i = 0; i < diffs.size() && i < 10; ++i) {
+        const auto& d = diffs[i];
+        std::cout << "  batch " << std::setw(6) << d.batch_id << " (" << d.orders << " orders): filled qty";
+        for (size_t l = 0; l < lanes.size(); ++l) {
+            std::cout << " " << lanes[l].variant.label << "=" << d.filled_qty[l];
+            if (l > 0) std::cout << " [" << d.orders_changed[l] << " orders differ]";
+        }
+        std::cout << "\n";
+    }
+    if (diffs.size() > 10) std::cout << "  ...\n";
     std::cout << "====================================================================\n";
+    std::cout << std::left;
+    
+    for (const auto& lane : lanes) {
+        RunResult r = build_result("compare:" + lane.variant.label, lane.variant.mode, lane.variant.policy,
+                                   lane.engine->get_metrics(), population_, stream.size(), lane.elapsed_ms,
+                                   lane.batch_latencies_ns);
+        results_.push_back(std::move(r));
+    }
 }
 
 void CLI::set_mode(const std::string& mode_str) {
-    MatchingMode new_mode = string_to_mode(mode_str);
+    MatchingMode new_mode;
+    if (!parse_mode(mode_str, new_mode)) {
+        std::cout << "Usage: mode <naive|fair|bump>\n";
+        command_failed_ = true;
+        return;
+    }
     if (new_mode != current_mode_) {
         current_mode_ = new_mode;
-        delete engine_;
-        engine_ = new MatchingEngine(current_mode_);
+        rebuild_engine();
         if (current_mode_ == MatchingMode::LATENCY_FAIR_BATCHED) {
             delete batcher_;
-            batcher_ = new MicroBatcher(batch_window_ns_);
+            batcher_ = new MicroBatcher(batch_policy_);
         }
         std::cout << "Mode set to: " << mode_to_string(current_mode_) << "\n";
     } else {
@@ -399,18 +982,642 @@ void CLI::set_mode(const std::string& mode_str) {
 void CLI::set_batch_window(const std::string& window_str) {
     TimeNs new_window = parse_time_string(window_str);
     if (new_window > 0) {
-        batch_window_ns_ = new_window;
-        delete batcher_;
-        batcher_ = new MicroBatcher(batch_window_ns_);
-        std::cout << "Batch window set to: " << (batch_window_ns_ / 1000) << "µs\n";
+        batch_policy_.window_ns = new_window;
+        // Live change: orders already buffered stay in the open batch
+        batcher_->set_window(new_window);
+        engine_->set_contention_horizon(new_window);
+        std::cout << "Batch window set to: " << (batch_policy_.window_ns / 1000) << "µs\n";
     } else {
         std::cout << "Invalid time format. Use format like '100us' or '1ms'\n";
+        command_failed_ = true;
     }
 }
 
-void CLI::show_metrics() {
-    std::cout << engine_->get_metrics().get_summary(traders_);
-    std::cout << engine_->get_metrics().get_detailed_report(traders_);
+void CLI::set_batch_cap(const std::string& cap_str) {
+    if (cap_str.empty() || cap_str.size() >= 10 || cap_str.find_first_not_of("0123456789") != std::string::npos) {
+        std::cout << "Usage: batchcap <N>  (0 = unbounded, up to 999999999)\n";
+        command_failed_ = true;
+        return;
+    }
+    batch_policy_.max_batch_size = std::stoul(cap_str);
+    batcher_->set_max_batch_size(batch_policy_.max_batch_size);
+    if (batch_policy_.max_batch_size == 0) {
+        std::cout << "Batch size cap disabled\n";
+    } else {
+        std::cout << "Batch size cap set to: " << batch_policy_.max_batch_size << " events\n";
+    }
+}
+
+void CLI::set_admission(const std::string& args) {
+    std::istringstream iss(args);
+    std::vector<std::string> words;
+    for (std::string w; iss >> w;) words.push_back(w);
+
+    BatchPolicy p = batch_policy_;
+    bool ok = true;
+    if (words.size() == 1 && words[0] == "off") {
+        p.max_pending = p.max_batch_bytes = p.max_in_flight = 0;
+        p.overflow = OverflowPolicy::REJECT;
+    } else {
+        auto is_number = [](const std::string& v) {
+            return !v.empty() && v.size() < 19 && v.find_first_not_of("0123456789") == std::string::npos;
+        };
+        for (size_t i = 0; ok && i < words.size(); i += 2) {
+            const std::string& key = words[i];
+            const std::string value = i + 1 < words.size() ? words[i + 1] : "";
+            if (key == "overflow" && (value == "reject" || value == "defer" || value == "block")) {
+                p.overflow = value == "reject" ? OverflowPolicy::REJECT
+                           : value == "defer" ? OverflowPolicy::DEFER : OverflowPolicy::BLOCK;
+            } else if (key == "pending" && is_number(value)) {
+                p.max_pending = std::stoull(value);
+            } else if (key == "bytes" && is_number(value)) {
+                p.max_batch_bytes = std::stoull(value);
+            } else if (key == "trader" && is_number(value)) {
+                p.max_in_flight = std::stoull(value);
+            } else {
+                ok = false;
+            }
+        }
+    }
+    if (!ok) {
+        std::cout << "Usage: admission [pending <N>] [bytes <N>] [trader <N>] [overflow <reject|defer|block>] | off\n";
+        command_failed_ = true;
+        return;
+    }
+
+    if (!words.empty()) {
+        batch_policy_ = p;
+        batcher_->set_admission(p.max_pending, p.max_batch_bytes, p.max_in_flight, p.overflow);
+    }
+    auto limit = [](size_t v) { return v == 0 ? std::string("none") : std::to_string(v); };
+    std::cout << "Admission: pending " << limit(batch_policy_.max_pending) << ", batch bytes "
+              << limit(batch_policy_.max_batch_bytes) << ", per trader " << limit(batch_policy_.max_in_flight)
+              << ", overflow "
+              << (batch_policy_.overflow == OverflowPolicy::REJECT ? "reject"
+                  : batch_policy_.overflow == OverflowPolicy::DEFER ? "defer" : "block") << "\n";
+    if (words.empty()) {
+        const AdmissionStats& st = batcher_->admission_stats();
+        std::cout << "  accepted " << st.accepted << ", deferred " << st.deferred << " (released " << st.released
+                  << "), rejected " << st.rejected_full << " full / " << st.rejected_trader << " trader cap, blocked "
+                  << st.blocked << "\n"
+                  << "  peak pending " << st.peak_pending << " events, largest batch " << st.peak_batch_bytes
+                  << " bytes, " << batcher_->pending() << " pending now\n";
+    }
+}
+
+void CLI::set_adaptive_window(const std::string& args) {
+    std::istringstream iss(args);
+    std::string state, min_str, max_str;
+    iss >> state >> min_str >> max_str;
+
+    if (state == "off") {
+        batch_policy_.adaptive = false;
+        batcher_->set_adaptive(false, batch_policy_.min_window_ns, batch_policy_.max_window_ns);
+        std::cout << "Adaptive batch window disabled (window " << (batch_policy_.window_ns / 1000) << "µs)\n";
+        return;
+    }
+    if (state != "on") {
+        std::cout << "Usage: adaptive <on|off> [min] [max]  (e.g., adaptive on 10us 500us)\n";
+        command_failed_ = true;
+        return;
+    }
+
+    TimeNs min_window = min_str.empty() ? batch_policy_.min_window_ns : parse_time_string(min_str);
+    TimeNs max_window = max_str.empty() ? batch_policy_.max_window_ns : parse_time_string(max_str);
+    if (min_window == 0 || max_window == 0) {
+        std::cout << "Invalid time format. Use format like '100us' or '1ms'\n";
+        command_failed_ = true;
+        return;
+    }
+
+    batch_policy_.adaptive = true;
+    batch_policy_.min_window_ns = std::min(min_window, max_window);
+    batch_policy_.max_window_ns = std::max(min_window, max_window);
+    batcher_->set_adaptive(true, batch_policy_.min_window_ns, batch_policy_.max_window_ns);
+    std::cout << "Adaptive batch window enabled: " << (batch_policy_.min_window_ns / 1000) << "µs - "
+              << (batch_policy_.max_window_ns / 1000) << "µs\n";
+}
+
+void CLI::set_timestamps(const std::string& stamp_str) {
+    if (stamp_str == "batch") {
+        batch_timestamps_ = true;
+    } else if (stamp_str == "order") {
+        batch_timestamps_ = false;
+    } else {
+        std::cout << "Usage: timestamps <order|batch>\n";
+        command_failed_ = true;
+        return;
+    }
+    engine_->set_batch_timestamps(batch_timestamps_);
+    std::cout << "Trade timestamps: " << (batch_timestamps_ ? "one per batch" : "one per matched order")
+              << " (clock: " << (TscClock::using_tsc() ? "invariant TSC" : "steady_clock") << ")\n";
+}
+
+void CLI::set_price_band(const std::string& args) {
+    std::istringstream iss(args);
+    std::string low_str, high_str;
+    iss >> low_str >> high_str;
+    
+    if (low_str == "off") {
+        band_low_ = 0;
+        band_high_ = -1;
+        engine_->set_price_band(band_low_, band_high_);
+        std::cout << "Order book storage: heaps\n";
+        return;
+    }
+    try {
+        Price low = std::stoll(low_str);
+        Price high = std::stoll(high_str);
+        if (high < low) throw std::invalid_argument("empty band");
+        band_low_ = low;
+        band_high_ = high;
+    } catch (const std::exception&) {
+        std::cout << "Usage: band <low> <high> | band off  (e.g., band 50 150)\n";
+        command_failed_ = true;
+        return;
+    }
+    engine_->set_price_band(band_low_, band_high_);
+    const auto& book = engine_->get_order_book();
+    std::cout << "Order book storage: price band [" << book.get_band_low() << ", " << book.get_band_high()
+              << "], " << (book.get_band_high() - book.get_band_low() + 1) << " levels per side\n";
+}
+
+void CLI::set_parallel_sort(const std::string& args) {
+    std::istringstream iss(args);
+    std::string threads_str, threshold_str;
+    iss >> threads_str >> threshold_str;
+    
+    size_t threads = 0;
+    if (threads_str == "off") {
+        threads = 1;
+    } else if (!threads_str.empty() && threads_str.find_first_not_of("0123456789") == std::string::npos) {
+        threads = std::stoul(threads_str);
+    }
+    if (threads == 0 || (!threshold_str.empty() && threshold_str.find_first_not_of("0123456789") != std::string::npos)) {
+        std::cout << "Usage: parsort <threads|off> [threshold]  (e.g., parsort 4 50000)\n";
+        command_failed_ = true;
+        return;
+    }
+    if (!threshold_str.empty()) {
+        parallel_sort_threshold_ = std::max<size_t>(2, std::stoul(threshold_str));
+    }
+    
+    // The calling thread takes part, so N threads means N - 1 workers
+    delete sort_pool_;
+    sort_pool_ = threads > 1 ? new WorkStealingPool(threads - 1) : nullptr;
+    engine_->set_parallel_sort(sort_pool_, parallel_sort_threshold_);
+    if (sort_pool_) {
+        std::cout << "Parallel batch sort: " << threads << " threads for batches of "
+                  << parallel_sort_threshold_ << "+ marketable orders\n";
+    } else {
+        std::cout << "Parallel batch sort disabled\n";
+    }
+}
+
+void CLI::set_memory(const std::string& args) {
+    std::istringstream iss(args);
+    std::string what, value;
+    iss >> what >> value;
+    
+    MemoryPolicy policy = HugePages::policy();
+    bool ok = true;
+    if (what == "huge" && (value == "on" || value == "off")) {
+        policy.huge_pages = value == "on";
+    } else if (what == "prefault" && (value == "on" || value == "off")) {
+        policy.prefault = value == "on";
+    } else if (what == "node" && value == "off") {
+        policy.numa_node = -1;
+    } else if (what == "node" && value == "local") {
+        policy.numa_node = -2;
+    } else if ((what == "node" || what == "reserve") && !value.empty() &&
+               value.find_first_not_of("0123456789") == std::string::npos) {
+        if (what == "node") {
+            policy.numa_node = std::stoi(value);
+        } else {
+            book_reserve_ = std::stoul(value);
+        }
+    } else if (!what.empty()) {
+        ok = false;
+    }
+    if (!ok) {
+        std::cout << "Usage: memory [huge <on|off> | node <N|local|off> | prefault <on|off> | reserve <N>]\n";
+        command_failed_ = true;
+        return;
+    }
+    HugePages::set_policy(policy);
+    // Reserve (or re-map under the new policy) now rather than mid-run
+    if (what == "reserve" || (!what.empty() && book_reserve_ > 0)) {
+        rebuild_engine();
+    }
+    
+    MemoryStats st = HugePages::stats();
+    auto mb = [](uint64_t bytes) { return std::to_string(bytes >> 20) + " MB"; };
+    std::string node = policy.numa_node == -1 ? "first touch"
+                     : policy.numa_node == -2 ? "local (node " + std::to_string(HugePages::current_node()) + ")"
+                     : "node " + std::to_string(policy.numa_node);
+    std::cout << "Large allocations: " << (policy.huge_pages ? "2MB pages" : "4KB pages") << ", placement "
+              << node << ", prefault " << (policy.prefault ? "on" : "off") << "\n";
+    std::cout << "Book reserve: " << book_reserve_ << " orders per side\n";
+    std::cout << "Mapped so far: " << st.regions << " regions; hugetlb " << mb(st.hugetlb_bytes)
+              << ", THP-advised " << mb(st.thp_bytes) << ", plain " << mb(st.plain_bytes)
+              << ", NUMA-bound " << mb(st.numa_bound_bytes) << ", prefaulted " << mb(st.prefaulted_bytes) << "\n";
+}
+
+void CLI::set_order_mix(const std::string& args) {
+    std::istringstream iss(args);
+    OrderMix mix = simulator_.get_order_mix();
+    std::string token;
+    bool ok = true;
+    while (ok && iss >> token) {
+        if (token == "off") {
+            mix = OrderMix();
+            continue;
+        }
+        size_t eq = token.find('=');
+        std::string key = token.substr(0, eq);
+        double* share = key == "ioc" ? &mix.ioc : key == "fok" ? &mix.fok : key == "market" ? &mix.market : nullptr;
+        try {
+            size_t used = 0;
+            std::string value = eq == std::string::npos ? "" : token.substr(eq + 1);
+            double v = std::stod(value, &used);
+            ok = share && used == value.size() && v >= 0.0 && v <= 1.0;
+            if (ok) *share = v;
+        } catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    if (!ok || mix.ioc + mix.fok + mix.market > 1.0) {
+        std::cout << "Usage: ordertypes [ioc=F] [fok=F] [market=F] | off  (shares of generated orders, "
+                     "e.g. ordertypes ioc=0.4 market=0.05)\n";
+        command_failed_ = true;
+        return;
+    }
+    simulator_.set_order_mix(mix);
+    std::cout << std::fixed << std::setprecision(1)
+              << "Generated orders: " << (100.0 * mix.ioc) << "% IOC, " << (100.0 * mix.fok) << "% FOK, "
+              << (100.0 * mix.market) << "% market, "
+              << (100.0 * (1.0 - mix.ioc - mix.fok - mix.market)) << "% GTC limit\n";
+}
+
+void CLI::set_population(const std::string& args) {
+    std::istringstream iss(args);
+    std::string first;
+    iss >> first;
+    
+    TraderPopulation pop;
+    if (first.empty()) {
+        std::cout << "Population: " << population_.describe() << "\n";
+        return;
+    } else if (first == "standard") {
+        pop = TraderPopulation::from_traders(simulator_.create_standard_traders());
+    } else if (first == "load") {
+        std::string path, error;
+        iss >> path;
+        if (path.empty() || !TraderPopulation::load_csv(path, pop, error)) {
+            std::cout << (path.empty() ? "Usage: population load <file.csv>" : "Cannot load population: " + error)
+                      << "\n";
+            command_failed_ = true;
+            return;
+        }
+    } else {
+        PopulationConfig cfg;
+        bool ok = first.find_first_not_of("0123456789") == std::string::npos;
+        if (ok) {
+            cfg.traders = std::stoull(first);
+            ok = cfg.traders >= 2 && cfg.traders < FairnessMetrics::kMaxTraders;
+        }
+        std::string token;
+        while (ok && iss >> token) {
+            size_t eq = token.find('=');
+            std::string key = token.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : token.substr(eq + 1);
+            try {
+                size_t used = 0;
+                if (key == "latency") {
+                    ok = parse_latency_model(value, cfg.latency);
+                } else if (key == "jitter") {
+                    cfg.jitter_ns = parse_time_string(value);
+                    ok = cfg.jitter_ns > 0 || value == "0";
+                } else if (key == "rates") {
+                    cfg.rate_sigma = std::stod(value, &used);
+                    ok = used == value.size() && cfg.rate_sigma >= 0.0;
+                } else if (key == "aggr") {
+                    cfg.aggressiveness = std::stod(value, &used);
+                    ok = used == value.size() && cfg.aggressiveness >= 0.0 && cfg.aggressiveness <= 1.0;
+                } else if (key == "seed") {
+                    cfg.seed = static_cast<uint32_t>(std::stoul(value, &used));
+                    ok = used == value.size();
+                } else {
+                    ok = false;
+                }
+            } catch (const std::exception&) {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            std::cout << "Usage: population [standard | load <file.csv> | <N> [latency=<model>] [jitter=<time>] "
+                         "[rates=<sigma>] [aggr=<F>] [seed=S]]\n"
+                         "  N from 2 to " << (FairnessMetrics::kMaxTraders - 1) << "; model fixed:<t> | "
+                         "uniform:<lo>:<hi> | normal:<mean>:<sd> | lognormal:<median>[:sigma] | exp:<mean> | "
+                         "tiers:<t>@<share>,...[:sigma]\n";
+            command_failed_ = true;
+            return;
+        }
+        pop = TraderPopulation::generate(cfg);
+    }
+    
+    population_ = std::move(pop);
+    // Trader ids now name different traders; earlier tallies no longer apply
+    reset();
+    std::cout << "Population: " << population_.describe() << "\n";
+}
+
+bool CLI::parse_latency_model(const std::string& spec, LatencyModel& model) {
+    std::vector<std::string> parts;
+    std::istringstream iss(spec);
+    for (std::string p; std::getline(iss, p, ':');) parts.push_back(p);
+    if (parts.size() < 2) return false;
+    
+    LatencyModel m;
+    const std::string& kind = parts[0];
+    try {
+        if (kind == "fixed" && parts.size() == 2) {
+            m.dist = LatencyDist::FIXED;
+            m.scale_ns = parse_time_string(parts[1]);
+        } else if ((kind == "uniform" || kind == "normal") && parts.size() == 3) {
+            m.dist = kind == "uniform" ? LatencyDist::UNIFORM : LatencyDist::NORMAL;
+            m.scale_ns = parse_time_string(parts[1]);
+            m.spread_ns = parse_time_string(parts[2]);
+            if (m.spread_ns == 0) return false;
+        } else if (kind == "lognormal" && parts.size() <= 3) {
+            m.dist = LatencyDist::LOGNORMAL;
+            m.scale_ns = parse_time_string(parts[1]);
+            if (parts.size() == 3) m.shape = std::stod(parts[2]);
+        } else if (kind == "exp" && parts.size() == 2) {
+            m.dist = LatencyDist::EXPONENTIAL;
+            m.scale_ns = parse_time_string(parts[1]);
+        } else if (kind == "tiers" && parts.size() <= 3) {
+            m.dist = LatencyDist::TIERS;
+            m.shape = parts.size() == 3 ? std::stod(parts[2]) : 0.0;
+            std::istringstream tiers(parts[1]);
+            for (std::string t; std::getline(tiers, t, ',');) {
+                size_t at = t.find('@');
+                if (at == std::string::npos) return false;
+                LatencyTier tier{parse_time_string(t.substr(0, at)), std::stod(t.substr(at + 1))};
+                if (tier.latency_ns == 0 || tier.share <= 0.0) return false;
+                m.tiers.push_back(tier);
+            }
+            m.scale_ns = m.tiers.empty() ? 0 : m.tiers.front().latency_ns;
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (m.scale_ns == 0 || m.shape < 0.0) return false;
+    model = m;
+    return true;
+}
+
+void CLI::set_rolling(const std::string& args) {
+    std::istringstream iss(args);
+    std::string what, value, count_str;
+    iss >> what >> value >> count_str;
+    
+    auto is_count = [](const std::string& v) {
+        return !v.empty() && v.find_first_not_of("0123456789") == std::string::npos && std::stoul(v) > 0;
+    };
+    RollingConfig cfg = rolling_config_;
+    bool ok = true;
+    if (what == "on" || what == "off") {
+        rolling_enabled_ = what == "on";
+    } else if (what == "time" && parse_time_string(value) > 0 && (count_str.empty() || is_count(count_str))) {
+        cfg.interval_ns = parse_time_string(value);
+        if (!count_str.empty()) cfg.time_buckets = std::stoul(count_str);
+    } else if (what == "batches" && is_count(value) && (count_str.empty() || is_count(count_str))) {
+        cfg.batches_per_bucket = std::stoul(value);
+        if (!count_str.empty()) cfg.batch_buckets = std::stoul(count_str);
+    } else if (what == "traders" && is_count(value)) {
+        cfg.trader_slots = std::stoul(value);
+    } else if (!what.empty()) {
+        ok = false;
+    }
+    if (!ok) {
+        std::cout << "Usage: rolling [on|off | time <interval> [buckets] | batches <N> [buckets] | traders <slots>]\n";
+        command_failed_ = true;
+        return;
+    }
+    
+    if (!what.empty()) {
+        // Reshaping drops the history collected so far
+        rolling_config_ = cfg;
+        engine_->get_rolling().configure(rolling_config_);
+        engine_->get_rolling().set_enabled(rolling_enabled_);
+    }
+    std::cout << "Rolling windows " << (rolling_enabled_ ? "on" : "off") << ": "
+              << rolling_config_.time_buckets << " x " << (rolling_config_.interval_ns / 1000) << "us, "
+              << rolling_config_.batch_buckets << " x " << rolling_config_.batches_per_bucket << " batches, "
+              << engine_->get_rolling().config().trader_slots << " trader slots per bucket\n";
+}
+
+void CLI::show_series(const std::string& args) {
+    std::istringstream iss(args);
+    std::string axis_str, path;
+    iss >> axis_str >> path;
+    if (axis_str != "time" && axis_str != "batches") {
+        std::cout << "Usage: series <time|batches> [file.csv]\n";
+        command_failed_ = true;
+        return;
+    }
+    WindowAxis axis = axis_str == "time" ? WindowAxis::TIME : WindowAxis::BATCHES;
+    std::vector<WindowBucket> buckets = engine_->get_rolling().series(axis);
+    
+    if (!path.empty()) {
+        std::ofstream file(path);
+        file << RollingMetrics::format_csv(buckets, axis);
+        if (!file) {
+            std::cout << "Cannot write " << path << "\n";
+            command_failed_ = true;
+            return;
+        }
+        std::cout << "Wrote " << buckets.size() << " buckets to " << path << "\n";
+        return;
+    }
+    
+    uint64_t origin = buckets.empty() ? 0 : buckets.front().start;
+    std::cout << "\n" << (axis == WindowAxis::TIME ? "  Start ms" : "   Batch #")
+              << " | Batches |  Orders |  Trades |  Volume | Lat mean us | Spread |  Jain\n";
+    std::cout << "--------------------------------------------------------------------------------\n";
+    for (const auto& b : buckets) {
+        std::cout << std::right << std::fixed << std::setprecision(1) << std::setw(10)
+                  << (axis == WindowAxis::TIME ? (b.start - origin) / 1e6 : static_cast<double>(b.start))
+                  << " | " << std::setw(7) << b.batches << " | " << std::setw(7) << b.orders
+                  << " | " << std::setw(7) << b.trades << " | " << std::setw(7) << b.volume
+                  << " | " << std::setw(11) << (b.mean_latency_ns() / 1000.0) << std::setprecision(3)
+                  << " | " << std::setw(6) << b.spread_index() << " | " << std::setw(5) << b.jain() << "\n";
+    }
+    if (buckets.empty()) std::cout << " (no batches recorded)\n";
+}
+
+void CLI::show_metrics(const std::string& job_str) {
+    if (job_str.empty()) {
+        MetricsSnapshot snap = population_.report(engine_->get_metrics().snapshot());
+        std::cout << FairnessMetrics::format_summary(snap, population_.report_traders());
+        std::cout << FairnessMetrics::format_detailed_report(snap, population_.report_traders());
+        return;
+    }
+    
+    auto it = job_str.find_first_not_of("0123456789") == std::string::npos
+        ? background_.find(std::stoi(job_str)) : background_.end();
+    if (it == background_.end()) {
+        std::cout << "No background job " << job_str << ". Type 'jobs' to list them.\n";
+        command_failed_ = true;
+        return;
+    }
+    // Read while the job keeps matching
+    const BackgroundRun& run = *it->second;
+    const auto& lane = run.lanes[run.active_lane.load()];
+    MetricsSnapshot snap = run.traders.report(lane.engine->get_metrics().snapshot());
+    std::cout << "\nJob " << it->first << " (" << run.job->label << "), " << mode_to_string(lane.mode) << ", "
+              << run.job->progress.done.load() << "/" << run.job->progress.total.load() << " orders\n";
+    std::cout << FairnessMetrics::format_summary(snap, run.traders.report_traders());
+    std::cout << FairnessMetrics::format_detailed_report(snap, run.traders.report_traders());
+}
+
+void CLI::set_monitor(const std::string& interval_str) {
+    if (interval_str == "off") {
+        monitor_interval_ = 0;
+        std::cout << "Live monitor disabled\n";
+        return;
+    }
+    TimeNs interval = parse_time_string(interval_str);
+    if (interval == 0) {
+        std::cout << "Usage: monitor <interval|off>  (e.g., monitor 500ms)\n";
+        command_failed_ = true;
+        return;
+    }
+    monitor_interval_ = interval;
+    std::cout << "Live monitor: one line every " << (interval / 1'000'000) << "ms during runs\n";
+}
+
+void CLI::show_stats() {
+    std::cout << PipelineStats::format(PipelineStats::snapshot());
+    std::cout << " Batch screening kernels: " << batch_kernel_isa() << "\n";
+}
+
+void CLI::set_archive(const std::string& args) {
+    std::istringstream iss(args);
+    std::string target, path, column_str;
+    iss >> target >> path >> column_str;
+
+    if (target == "scan") {
+        scan_archive(path, column_str);
+        return;
+    }
+    if (target.empty()) {
+        if (archive_) {
+            std::cout << "Archiving to " << archive_->path() << ": " << archive_->orders_written() << " orders, "
+                      << archive_->trades_written() << " trades\n";
+        } else {
+            std::cout << "Usage: archive <file|off>  |  archive scan <file> [column]\n";
+            command_failed_ = true;
+        }
+        return;
+    }
+
+    if (fanout_) fanout_->flush();   // the journal consumer may still be writing
+    if (archive_) {
+        bool ok = archive_->close();
+        std::cout << "Archive " << archive_->path() << " closed: " << archive_->orders_written() << " orders, "
+                  << archive_->trades_written() << " trades, " << archive_->bytes_written() << " bytes\n";
+        if (!ok) {
+            std::cout << "Archive write failed: " << archive_->last_error() << "\n";
+            command_failed_ = true;
+        }
+        delete archive_;
+        archive_ = nullptr;
+    }
+
+    if (target != "off") {
+        archive_ = new ArchiveWriter();
+        if (!archive_->open(target)) {
+            std::cout << "Cannot start archive: " << archive_->last_error() << "\n";
+            delete archive_;
+            archive_ = nullptr;
+            command_failed_ = true;
+        } else {
+            std::cout << "Archiving orders and trades to " << target << "\n";
+        }
+    }
+    engine_->set_archive(archive_);
+}
+
+void CLI::scan_archive(const std::string& path, const std::string& column_str) {
+    ArchiveReader reader;
+    if (path.empty() || !reader.open(path)) {
+        std::cout << (path.empty() ? "Usage: archive scan <file> [column]" : reader.last_error()) << "\n";
+        command_failed_ = true;
+        return;
+    }
+
+    std::vector<ArchiveColumn> columns;
+    if (column_str.empty()) {
+        for (size_t c = 0; c < static_cast<size_t>(ArchiveColumn::COUNT); ++c) {
+            columns.push_back(static_cast<ArchiveColumn>(c));
+        }
+    } else {
+        ArchiveColumn column;
+        if (!parse_column_name(column_str, column)) {
+            std::cout << "Unknown column '" << column_str << "'. Columns:";
+            for (size_t c = 0; c < static_cast<size_t>(ArchiveColumn::COUNT); ++c) {
+                std::cout << " " << column_name(static_cast<ArchiveColumn>(c));
+            }
+            std::cout << "\n";
+            command_failed_ = true;
+            return;
+        }
+        columns.push_back(column);
+    }
+
+    std::cout << "\n" << path << ": " << reader.row_count(ArchiveStream::ORDERS) << " orders, "
+              << reader.row_count(ArchiveStream::TRADES) << " trades, " << reader.file_bytes() << " bytes\n";
+    std::cout << "--------------------------------------------------------------------------------\n";
+    std::cout << " Column        |     Bytes | B/row |          Min |          Max |       Sum | Decode\n";
+    std::cout << "--------------------------------------------------------------------------------\n";
+    for (ArchiveColumn column : columns) {
+        uint64_t rows = reader.row_count(column_stream(column));
+        uint64_t bytes = reader.column_bytes(column);
+        int64_t lo = 0, hi = 0;
+        double sum = 0;
+        bool first = true;
+
+        uint64_t start = TscClock::ticks();
+        bool ok = reader.scan_column(column, [&](const int64_t* values, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                if (first || values[i] < lo) lo = values[i];
+                if (first || values[i] > hi) hi = values[i];
+                first = false;
+                sum += static_cast<double>(values[i]);
+            }
+        });
+        double decode_ms = (TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(start)) / 1e6;
+        if (!ok) {
+            std::cout << reader.last_error() << "\n";
+            command_failed_ = true;
+            return;
+        }
+
+        std::cout << " " << std::setw(13) << std::left << column_name(column) << std::right
+                  << " | " << std::setw(9) << bytes
+                  << " | " << std::setw(5) << std::fixed << std::setprecision(2)
+                  << (rows > 0 ? static_cast<double>(bytes) / rows : 0.0)
+                  << " | " << std::setw(12) << lo
+                  << " | " << std::setw(12) << hi
+                  << " | " << std::setw(9) << std::setprecision(0) << sum
+                  << " | " << std::setprecision(2) << decode_ms << "ms\n";
+        std::cout << std::left;
+    }
+    std::cout << "--------------------------------------------------------------------------------\n";
 }
 
 void CLI::show_order_book() {
@@ -425,31 +1632,267 @@ void CLI::show_order_book() {
     std::cout << "========================================\n";
 }
 
-void CLI::reset() {
+MatchingEngine* CLI::new_engine(MatchingMode mode) const {
+    auto* engine = new MatchingEngine(mode);
+    engine->set_batch_timestamps(batch_timestamps_);
+    engine->set_price_band(band_low_, band_high_);
+    engine->set_contention_horizon(batch_policy_.window_ns);
+    if (book_reserve_ > 0) {
+        engine->reserve_book(book_reserve_);
+    }
+    engine->get_rolling().configure(rolling_config_);
+    engine->get_rolling().set_enabled(rolling_enabled_);
+    return engine;
+}
+
+void CLI::rebuild_engine() {
+    delete fanout_;   // drains into the old engine before it goes
+    fanout_ = nullptr;
     delete engine_;
-    engine_ = new MatchingEngine(current_mode_);
+    engine_ = new_engine(current_mode_);
+    engine_->set_parallel_sort(sort_pool_, parallel_sort_threshold_);
+    engine_->set_archive(archive_);
+    engine_->set_record_outcomes(record_outcomes_);
+    attach_fanout();
+}
+
+void CLI::attach_fanout() {
+    if (fanout_capacity_ == 0) return;
+    market_data_->clear();
+    fanout_ = new ExecutionFanout(fanout_capacity_);
+    fanout_->add_consumer("metrics", engine_->metrics_consumer());
+    fanout_->add_consumer("journal", engine_->journal_consumer());
+    MarketDataBuilder* market_data = market_data_;
+    fanout_->add_consumer("market data", [market_data](const ExecutionEvent* events, size_t count) {
+        market_data->on_events(events, count);
+    });
+    fanout_->start();
+    engine_->set_output(fanout_);
+}
+
+void CLI::set_fanout(const std::string& args) {
+    std::istringstream iss(args);
+    std::string what, capacity_str;
+    iss >> what >> capacity_str;
+
+    if (what.empty()) {
+        if (!fanout_) {
+            std::cout << "Execution fan-out: off (metrics, rolling windows and archive written inline)\n";
+            return;
+        }
+        fanout_->flush();
+        std::cout << "Execution fan-out: " << fanout_->capacity() << "-event ring, " << fanout_->published()
+                  << " events published, writer waited " << fanout_->writer_waits() << " times\n";
+        for (const auto& c : fanout_->stats()) {
+            std::cout << "  " << std::setw(12) << std::left << c.name << std::right << std::setw(12) << c.processed
+                      << " events in " << c.runs << " runs, lag " << c.lag << "\n";
+        }
+        std::cout << market_data_->snapshot().format();
+        return;
+    }
+
+    bool valid_capacity = capacity_str.empty() ||
+                          (capacity_str.find_first_not_of("0123456789") == std::string::npos &&
+                           capacity_str.size() < 10 && std::stoull(capacity_str) > 0);
+    if ((what != "on" && what != "off") || (what == "off" && !capacity_str.empty()) || !valid_capacity) {
+        std::cout << "Usage: fanout [on [capacity] | off]\n";
+        command_failed_ = true;
+        return;
+    }
+
+    delete fanout_;   // drains what is in flight
+    fanout_ = nullptr;
+    engine_->set_output(nullptr);
+    if (what == "off") {
+        fanout_capacity_ = 0;
+        std::cout << "Execution fan-out off\n";
+        return;
+    }
+    fanout_capacity_ = capacity_str.empty() ? (1 << 16) : std::stoull(capacity_str);
+    attach_fanout();
+    std::cout << "Execution fan-out on: " << fanout_->capacity()
+              << "-event ring, metrics, journal and market data consumers\n";
+}
+
+void CLI::start_job(const std::string& args) {
+    std::istringstream iss(args);
+    std::string what, count_str;
+    iss >> what >> count_str;
+    
+    if ((what != "simulate" && what != "experiment") ||
+        (!count_str.empty() && count_str.find_first_not_of("0123456789") != std::string::npos)) {
+        std::cout << "Usage: bg <simulate|experiment> [N]  (e.g., bg simulate 100000)\n";
+        command_failed_ = true;
+        return;
+    }
+    if (!jobs_) {
+        jobs_ = new JobExecutor(std::max(2u, std::thread::hardware_concurrency()));
+    }
+    
+    // Jobs take the current settings but not the archive or the sort pool,
+    // which belong to the foreground engine and may be replaced under them
+    auto run = std::make_shared<BackgroundRun>();
+    run->command = what;
+    run->num_orders = count_str.empty() ? 1000 : std::stoull(count_str);
+    run->policy = batch_policy_;
+    run->policy.log_batches = false;   // runs off the CLI thread
+    run->traders = population_;
+    run->order_mix = simulator_.get_order_mix();
+    std::vector<MatchingMode> modes = {current_mode_};
+    if (what == "experiment") {
+        modes = {MatchingMode::NAIVE_PRICE_TIME, MatchingMode::LATENCY_FAIR_BATCHED};
+    }
+    for (MatchingMode mode : modes) {
+        BackgroundRun::Lane lane;
+        lane.mode = mode;
+        lane.engine.reset(new_engine(mode));
+        run->lanes.push_back(std::move(lane));
+    }
+    
+    std::string label = what + " " + std::to_string(run->num_orders);
+    if (what == "simulate") {
+        label += current_mode_ == MatchingMode::NAIVE_PRICE_TIME ? " (naive)"
+               : current_mode_ == MatchingMode::SPEED_BUMP ? " (bump)" : " (fair)";
+    }
+    run->job = jobs_->submit(label, [run](Job& job) {
+        TraderSimulator simulator;
+        simulator.set_order_mix(run->order_mix);
+        for (size_t i = 0; i < run->lanes.size() && !job.progress.cancel.load(); ++i) {
+            auto& lane = run->lanes[i];
+            run->active_lane.store(i);
+            MicroBatcher batcher(run->policy);
+            auto start = std::chrono::steady_clock::now();
+            run_simulated_flow(*lane.engine, batcher, simulator, run->traders, run->num_orders,
+                               lane.batch_latencies_ns, &job.progress);
+            lane.elapsed_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    run->job->progress.total.store(run->num_orders * run->lanes.size());
+    background_[run->job->id] = run;
+    std::cout << "Job " << run->job->id << " queued: " << label << "\n";
+}
+
+void CLI::collect_jobs() {
+    for (auto& [id, run] : background_) {
+        JobState state = run->job->state.load();
+        if (run->collected || (state != JobState::DONE && state != JobState::CANCELLED)) continue;
+        run->collected = true;
+        
+        if (state == JobState::CANCELLED) {
+            std::cout << "[job " << id << "] " << run->job->label << " cancelled after "
+                      << run->job->progress.done.load() << " orders\n";
+            continue;
+        }
+        std::cout << "[job " << id << "] " << run->job->label << " done:";
+        for (const auto& lane : run->lanes) {
+            results_.push_back(build_result(run->command, lane.mode, run->policy, lane.engine->get_metrics(),
+                                            run->traders, run->num_orders, lane.elapsed_ms, lane.batch_latencies_ns));
+            const RunResult& r = results_.back();
+            std::cout << " " << r.mode << " fairness " << std::fixed << std::setprecision(3) << r.fairness_index
+                      << " (" << r.trades << " trades, " << std::setprecision(0) << r.elapsed_ms << "ms)";
+        }
+        std::cout << "\n";
+    }
+}
+
+void CLI::show_jobs() {
+    if (background_.empty()) {
+        std::cout << "No background jobs. Start one with 'bg simulate <N>'.\n";
+        return;
+    }
+    
+    std::cout << "\n ID | State     | Job                       | Progress | Events/s | Batches | ETA\n";
+    std::cout << "----------------------------------------------------------------------------------\n";
+    TimeNs now = TscClock::now_ns();
+    for (const auto& job : jobs_->list()) {
+        JobState state = job->state.load();
+        uint64_t done = job->progress.done.load();
+        uint64_t total = job->progress.total.load();
+        TimeNs started = job->started_ns.load();
+        TimeNs finished = job->finished_ns.load();
+        double secs = started == 0 ? 0.0 : ((finished ? finished : now) - started) / 1e9;
+        double rate = secs > 0 ? done / secs : 0.0;
+        std::string eta = "-";
+        if (state == JobState::RUNNING && rate > 0) {
+            eta = std::to_string(static_cast<uint64_t>((total - done) / rate)) + "s";
+        }
+        
+        std::cout << " " << std::setw(2) << std::right << job->id
+                  << " | " << std::setw(9) << std::left << JobExecutor::state_name(state)
+                  << " | " << std::setw(25) << job->label.substr(0, 25)
+                  << " | " << std::setw(7) << std::right << std::fixed << std::setprecision(1)
+                  << (total > 0 ? 100.0 * done / total : 0.0) << "%"
+                  << " | " << std::setw(8) << std::setprecision(0) << rate
+                  << " | " << std::setw(7) << job->progress.batches.load()
+                  << " | " << eta << "\n";
+    }
+    std::cout << std::left;
+}
+
+void CLI::cancel_job(const std::string& id_str) {
+    if (id_str.empty() || id_str.find_first_not_of("0123456789") != std::string::npos) {
+        std::cout << "Usage: cancel <job>  (see 'jobs')\n";
+        command_failed_ = true;
+        return;
+    }
+    if (!jobs_ || !jobs_->cancel(std::stoi(id_str))) {
+        std::cout << "No queued or running job " << id_str << "\n";
+        command_failed_ = true;
+        return;
+    }
+    std::cout << "Cancelling job " << id_str << "\n";
+}
+
+void CLI::wait_jobs(const std::string& id_str) {
+    int id = -1;
+    if (!id_str.empty()) {
+        if (id_str.find_first_not_of("0123456789") != std::string::npos ||
+            background_.count(std::stoi(id_str)) == 0) {
+            std::cout << "Usage: wait [job]  (see 'jobs')\n";
+            command_failed_ = true;
+            return;
+        }
+        id = std::stoi(id_str);
+    }
+    if (jobs_) {
+        jobs_->wait(id);
+    }
+    collect_jobs();
+}
+
+void CLI::reset() {
+    rebuild_engine();
     delete batcher_;
-    batcher_ = new MicroBatcher(batch_window_ns_);
+    batcher_ = new MicroBatcher(batch_policy_);
     engine_->get_metrics().reset();
-    for (auto& trader : traders_) {
-        trader.reset_stats();
-    }
+    PipelineStats::reset();
+    batch_latencies_ns_.clear();
     std::cout << "Engine and metrics reset.\n";
 }
 
 std::string CLI::mode_to_string(MatchingMode mode) const {
-    return (mode == MatchingMode::NAIVE_PRICE_TIME) ? "Naive (Price-Time)" : "Fair (Batched)";
+    switch (mode) {
+        case MatchingMode::NAIVE_PRICE_TIME:     return "Naive (Price-Time)";
+        case MatchingMode::LATENCY_FAIR_BATCHED: return "Fair (Batched)";
+        case MatchingMode::SPEED_BUMP:           return "Fair (Speed Bump)";
+    }
+    return "Unknown";
 }
 
-MatchingMode CLI::string_to_mode(const std::string& str) const {
+bool CLI::parse_mode(const std::string& str, MatchingMode& mode) const {
     std::string lower = str;
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     if (lower == "naive" || lower == "price-time") {
-        return MatchingMode::NAIVE_PRICE_TIME;
+        mode = MatchingMode::NAIVE_PRICE_TIME;
     } else if (lower == "fair" || lower == "batched") {
-        return MatchingMode::LATENCY_FAIR_BATCHED;
+        mode = MatchingMode::LATENCY_FAIR_BATCHED;
+    } else if (lower == "bump" || lower == "speedbump") {
+        mode = MatchingMode::SPEED_BUMP;
+    } else {
+        return false;
     }
-    return MatchingMode::LATENCY_FAIR_BATCHED; // default
+    return true;
 }
 
 TimeNs CLI::parse_time_string(const std::string& str) {
@@ -457,9 +1900,14 @@ TimeNs CLI::parse_time_string(const std::string& str) {
     std::transform(s.begin(), s.end(), s.begin(), ::tolower);
     
     size_t unit_pos = s.find_first_not_of("0123456789.");
-    if (unit_pos == std::string::npos) return 0;
+    if (unit_pos == std::string::npos || unit_pos == 0) return 0;
     
-    double value = std::stod(s.substr(0, unit_pos));
+    double value = 0;
+    try {
+        value = std::stod(s.substr(0, unit_pos));
+    } catch (const std::exception&) {
+        return 0;
+    }
     std::string unit = s.substr(unit_pos);
     
     if (unit == "ns") return static_cast<TimeNs>(value);
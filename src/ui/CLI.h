@@ -1,43 +1,125 @@
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "core/MatchingMode.h"
 #include "simulation/Trader.h"
+#include "simulation/TraderPopulation.h"
 #include "engine/MatchingEngine.h"
 #include "batching/MicroBatcher.h"
+#include "ui/ResultWriter.h"
+
+class ArchiveWriter;
+class WorkStealingPool;
+class ExecutionFanout;
+class MarketDataBuilder;
+
+// Options for non-interactive (scripted) runs
+struct BatchOptions {
+    std::string format = "json";   // json | csv
+    std::string output_path;       // empty = stdout
+    bool quiet = false;            // suppress human-readable output
+};
+
+class JobExecutor;
+struct BackgroundRun;
 
 class CLI {
 public:
     CLI();
+    ~CLI();
     void run();
+    
+    // Execute commands non-interactively and write collected run results
+    // in options.format. Returns a process exit status.
+    int run_batch(const std::vector<std::string>& commands, const BatchOptions& options);
 
 private:
     MatchingMode current_mode_;
-    TimeNs batch_window_ns_;
+    BatchPolicy batch_policy_;
+    bool batch_timestamps_;
+    Price band_low_;
+    Price band_high_;      // high < low: heap book
     MatchingEngine* engine_;
     MicroBatcher* batcher_;
-    std::vector<Trader> traders_;
+    ArchiveWriter* archive_;
+    ExecutionFanout* fanout_;          // execution ring, nullptr = inline outputs
+    MarketDataBuilder* market_data_;   // fed by fanout_
+    size_t fanout_capacity_;           // 0 = off
+    bool record_outcomes_;             // engines keep per-batch outcomes (experiment)
+    WorkStealingPool* sort_pool_;
+    size_t parallel_sort_threshold_;
+    size_t book_reserve_;
+    RollingConfig rolling_config_;
+    bool rolling_enabled_;
+    TimeNs monitor_interval_;   // 0 = no live monitor
+    JobExecutor* jobs_;         // created by the first background job
+    std::map<int, std::shared_ptr<BackgroundRun>> background_;
+    TraderPopulation population_;
     TraderSimulator simulator_;
     
+    std::vector<RunResult> results_;
+    std::vector<uint64_t> batch_latencies_ns_;
+    bool command_failed_;
+    
     void print_banner();
     void print_help();
     void print_menu();
     
-    void run_simulation(int num_orders);
-    void run_experiment();
+    bool execute_command(const std::string& input);
+    
+    void run_simulation(uint64_t num_orders, const std::string& label = "simulate");
+    void run_experiment(int num_orders = 1000, size_t replicates = 1000);
+    void run_compare(const std::string& args);
+    void run_gateway(const std::string& port_str, const std::string& duration_str);
+    void run_shm_ingress(const std::string& name, const std::string& duration_str, bool apply_latency);
+    void record_result(const std::string& label, uint64_t num_orders, double elapsed_ms);
+    RunResult build_result(const std::string& label, MatchingMode mode, const BatchPolicy& policy,
+                           const FairnessMetrics& metrics, const TraderPopulation& population,
+                           uint64_t num_orders, double elapsed_ms,
+                           const std::vector<uint64_t>& batch_latencies_ns) const;
     void compare_modes(int num_orders);
     
     void set_mode(const std::string& mode_str);
     void set_batch_window(const std::string& window_str);
-    void show_metrics();
+    void set_batch_cap(const std::string& cap_str);
+    void set_admission(const std::string& args);
+    void set_adaptive_window(const std::string& args);
+    void set_timestamps(const std::string& stamp_str);
+    void set_price_band(const std::string& args);
+    void set_order_mix(const std::string& args);
+    void set_population(const std::string& args);
+    void set_rolling(const std::string& args);
+    void show_series(const std::string& args);
+    void set_parallel_sort(const std::string& args);
+    void set_memory(const std::string& args);
+    void show_metrics(const std::string& job_str = "");
+    void set_monitor(const std::string& interval_str);
     void show_order_book();
+    void show_stats();
+    void set_archive(const std::string& args);
+    void scan_archive(const std::string& path, const std::string& column_str);
+    void set_fanout(const std::string& args);
+    void attach_fanout();
     void reset();
+    void rebuild_engine();
+    MatchingEngine* new_engine(MatchingMode mode) const;
+    
+    // Background jobs: each runs on its own engine and batcher
+    void start_job(const std::string& args);
+    void show_jobs();
+    void cancel_job(const std::string& id_str);
+    void wait_jobs(const std::string& id_str);
+    void collect_jobs();
     
     std::string mode_to_string(MatchingMode mode) const;
-    MatchingMode string_to_mode(const std::string& str) const;
+    bool parse_mode(const std::string& str, MatchingMode& mode) const;
     
     // Helper to parse time strings like "100us", "1ms"
     TimeNs parse_time_string(const std::string& str);
+    // "lognormal:25us:0.8", "tiers:5us@0.1,50us@0.9", ... (see help)
+    bool parse_latency_model(const std::string& spec, LatencyModel& model);
 };
 
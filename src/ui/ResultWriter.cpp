@@ -0,0 +1,186 @@
+#include "ui/ResultWriter.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+static std::string json_escape(const std::string& s) {
+    std::ostringstream oss;
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\n': oss << "\\n"; break;
+            case '\r': oss << "\\r"; break;
+            case '\t': oss << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                        << std::dec << std::setfill(' ');
+                } else {
+                    oss << c;
+                }
+        }
+    }
+    return oss.str();
+}
+
+static std::string csv_escape(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+LatencySummary LatencySummary::from_samples(std::vector<uint64_t> samples_ns) {
+    LatencySummary s;
+    if (samples_ns.empty()) return s;
+    std::sort(samples_ns.begin(), samples_ns.end());
+
+    double sum = 0;
+    for (uint64_t v : samples_ns) sum += static_cast<double>(v);
+
+    auto pct = [&](double p) {
+        size_t idx = static_cast<size_t>(p * static_cast<double>(samples_ns.size() - 1) + 0.5);
+        return static_cast<double>(samples_ns[idx]);
+    };
+
+    s.samples = samples_ns.size();
+    s.min_ns = static_cast<double>(samples_ns.front());
+    s.mean_ns = sum / static_cast<double>(samples_ns.size());
+    s.p50_ns = pct(0.50);
+    s.p99_ns = pct(0.99);
+    s.max_ns = static_cast<double>(samples_ns.back());
+    return s;
+}
+
+bool ResultWriter::write(std::ostream& os, const std::string& format, const std::vector<RunResult>& results) {
+    if (format == "json") {
+        write_json(os, results);
+    } else if (format == "csv") {
+        write_csv(os, results);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ResultWriter::write_json(std::ostream& os, const std::vector<RunResult>& results) {
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    double ns_per_tick = TscClock::ns_per_tick();
+
+    oss << "{\n  \"runs\": [";
+    for (size_t r = 0; r < results.size(); ++r) {
+        const auto& run = results[r];
+        oss << (r == 0 ? "\n" : ",\n");
+        oss << "    {\n";
+        oss << "      \"run_id\": " << run.run_id << ",\n";
+        oss << "      \"command\": \"" << json_escape(run.command) << "\",\n";
+        oss << "      \"mode\": \"" << json_escape(run.mode) << "\",\n";
+        oss << "      \"window_ns\": " << run.window_ns << ",\n";
+        oss << "      \"max_batch_size\": " << run.max_batch_size << ",\n";
+        oss << "      \"adaptive_window\": " << (run.adaptive_window ? "true" : "false") << ",\n";
+        oss << "      \"orders\": " << run.orders << ",\n";
+        oss << "      \"batches\": " << run.batches << ",\n";
+        oss << "      \"trades\": " << run.trades << ",\n";
+        oss << "      \"elapsed_ms\": " << run.elapsed_ms << ",\n";
+        oss << "      \"throughput_ops\": " << run.throughput_ops << ",\n";
+        oss << "      \"fairness_index\": " << run.fairness_index << ",\n";
+        oss << "      \"latency_advantage_reduction\": " << run.latency_advantage_reduction << ",\n";
+        oss << "      \"jain_index\": " << run.jain_index << ",\n";
+        oss << "      \"gini\": " << run.gini << ",\n";
+        oss << "      \"min_win_rate\": " << run.min_win_rate << ",\n";
+
+        const auto& ci = run.confidence;
+        if (ci.replicates > 0) {
+            auto interval = [](const ConfidenceInterval& c) {
+                std::ostringstream out;
+                out << "[" << c.low << ", " << c.high << "]";
+                return out.str();
+            };
+            oss << "      \"confidence\": {\"level\": " << ci.level << ", \"replicates\": " << ci.replicates
+                << ", \"batches\": " << ci.batches << ", \"fairness_index\": " << interval(ci.fairness_index)
+                << ", \"latency_advantage_reduction\": " << interval(ci.latency_advantage_reduction) << "},\n";
+        }
+
+        const auto& lat = run.batch_latency;
+        oss << "      \"batch_latency_ns\": {\"samples\": " << lat.samples
+            << ", \"min\": " << lat.min_ns << ", \"mean\": " << lat.mean_ns
+            << ", \"p50\": " << lat.p50_ns << ", \"p99\": " << lat.p99_ns
+            << ", \"max\": " << lat.max_ns << "},\n";
+
+        oss << "      \"stages\": {";
+        for (size_t i = 0; i < kStageCount; ++i) {
+            const auto& st = run.pipeline.stages[i];
+            double per_event = st.events > 0
+                ? static_cast<double>(st.ticks) * ns_per_tick / static_cast<double>(st.events) : 0.0;
+            oss << (i == 0 ? "\n" : ",\n");
+            oss << "        \"" << PipelineStats::stage_name(static_cast<Stage>(i)) << "\": {\"calls\": "
+                << st.calls << ", \"events\": " << st.events << ", \"ns_per_event\": " << per_event << "}";
+        }
+        oss << "\n      },\n";
+
+        oss << "      \"traders\": [";
+        for (size_t t = 0; t < run.traders.size(); ++t) {
+            const auto& s = run.traders[t];
+            oss << (t == 0 ? "\n" : ",\n");
+            oss << "        {\"trader_id\": " << s.trader_id
+                << ", \"name\": \"" << json_escape(s.name) << "\""
+                << ", \"latency_ns\": " << s.total_latency_ns
+                << ", \"orders_submitted\": " << s.orders_submitted
+                << ", \"orders_executed\": " << s.orders_executed
+                << ", \"trades_won\": " << s.trades_won
+                << ", \"trades_lost\": " << s.trades_lost
+                << ", \"win_rate\": " << s.win_rate
+                << ", \"execution_rate\": " << s.execution_rate;
+            if (ci.replicates > 0 && t < ci.win_rates.size()) {
+                oss << ", \"win_rate_ci\": [" << ci.win_rates[t].low << ", " << ci.win_rates[t].high << "]";
+            }
+            oss << "}";
+        }
+        oss << (run.traders.empty() ? "]\n" : "\n      ]\n");
+        oss << "    }";
+    }
+    oss << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    os << oss.str();
+}
+
+void ResultWriter::write_csv(std::ostream& os, const std::vector<RunResult>& results) {
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+
+    oss << "run_id,command,mode,window_ns,max_batch_size,adaptive_window,orders,batches,trades,"
+           "elapsed_ms,throughput_ops,fairness_index,latency_advantage_reduction,jain_index,gini,min_win_rate,"
+           "batch_latency_mean_ns,batch_latency_p50_ns,batch_latency_p99_ns,batch_latency_max_ns,"
+           "trader_id,trader_name,latency_ns,orders_submitted,orders_executed,trades_won,trades_lost,"
+           "win_rate,execution_rate\n";
+
+    for (const auto& run : results) {
+        std::ostringstream prefix;
+        prefix << std::setprecision(6)
+               << run.run_id << ',' << csv_escape(run.command) << ',' << csv_escape(run.mode) << ','
+               << run.window_ns << ',' << run.max_batch_size << ',' << (run.adaptive_window ? 1 : 0) << ','
+               << run.orders << ',' << run.batches << ',' << run.trades << ','
+               << run.elapsed_ms << ',' << run.throughput_ops << ','
+               << run.fairness_index << ',' << run.latency_advantage_reduction << ','
+               << run.jain_index << ',' << run.gini << ',' << run.min_win_rate << ','
+               << run.batch_latency.mean_ns << ',' << run.batch_latency.p50_ns << ','
+               << run.batch_latency.p99_ns << ',' << run.batch_latency.max_ns;
+
+        if (run.traders.empty()) {
+            oss << prefix.str() << ",,,,,,,,,\n";
+            continue;
+        }
+        for (const auto& s : run.traders) {
+            oss << prefix.str() << ','
+                << s.trader_id << ',' << csv_escape(s.name) << ',' << s.total_latency_ns << ','
+                << s.orders_submitted << ',' << s.orders_executed << ','
+                << s.trades_won << ',' << s.trades_lost << ','
+                << s.win_rate << ',' << s.execution_rate << '\n';
+        }
+    }
+    os << oss.str();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/Types.h"
+#include "metrics/FairnessMetrics.h"
+#include "metrics/Bootstrap.h"
+#include "metrics/PipelineStats.h"
+
+// Latency distribution of per-batch matching time (batch handed to the
+// engine until its trades and metrics are recorded)
+struct LatencySummary {
+    uint64_t samples = 0;
+    double min_ns = 0;
+    double mean_ns = 0;
+    double p50_ns = 0;
+    double p99_ns = 0;
+    double max_ns = 0;
+
+    static LatencySummary from_samples(std::vector<uint64_t> samples_ns);
+};
+
+// Machine-readable outcome of one simulate/experiment run
+struct RunResult {
+    int run_id = 0;
+    std::string command;          // "simulate", "experiment"
+    std::string mode;             // "naive", "fair"
+    TimeNs window_ns = 0;
+    size_t max_batch_size = 0;
+    bool adaptive_window = false;
+
+    uint64_t orders = 0;
+    uint64_t batches = 0;
+    uint64_t trades = 0;
+    double elapsed_ms = 0;
+    double throughput_ops = 0;    // orders per second, wall clock
+
+    double fairness_index = 0;
+    double latency_advantage_reduction = 0;
+    double jain_index = 0;
+    double gini = 0;
+    double min_win_rate = 0;
+
+    LatencySummary batch_latency;
+    PipelineStatsSnapshot pipeline;
+    std::vector<TraderStats> traders;
+
+    // Bootstrap intervals (experiment runs); confidence.replicates == 0 = none
+    BootstrapResult confidence;
+};
+
+class ResultWriter {
+public:
+    // Returns false for an unknown format name
+    static bool write(std::ostream& os, const std::string& format, const std::vector<RunResult>& results);
+
+    static void write_json(std::ostream& os, const std::vector<RunResult>& results);
+
+    // One row per (run, trader); run-level columns repeat on each row
+    static void write_csv(std::ostream& os, const std::vector<RunResult>& results);
+};